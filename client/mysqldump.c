@@ -1167,6 +1167,9 @@ static int get_options(int *argc, char ***argv)
      (my_hash_insert(&ignore_table,
                      (uchar*) my_strdup(PSI_NOT_INSTRUMENTED,
 					"mysql.column_stats", MYF(MY_WME))) ||
+      my_hash_insert(&ignore_table,
+                     (uchar*) my_strdup(PSI_NOT_INSTRUMENTED,
+					"mysql.column_group_stats", MYF(MY_WME))) ||
       my_hash_insert(&ignore_table,
                      (uchar*) my_strdup(PSI_NOT_INSTRUMENTED,
 					"mysql.index_stats", MYF(MY_WME))) ||
@@ -4899,6 +4902,13 @@ static int dump_all_stats()
     dump_table("index_stats", "mysql", NULL, 0);
     dump_table("table_stats", "mysql", NULL, 0);
   }
+  /* Column group statistics may be missing on older servers */
+  if (!mysql_query(mysql, "show fields from column_group_stats"))
+  {
+    MYSQL_RES *tableres= mysql_store_result(mysql);
+    mysql_free_result(tableres);
+    dump_table("column_group_stats", "mysql", NULL, 0);
+  }
   /* Innodb may be disabled */
   if (!mysql_query(mysql, "show fields from innodb_index_stats"))
   {
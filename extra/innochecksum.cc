@@ -52,6 +52,11 @@ The parts not included are excluded by #ifndef UNIV_INNOCHECKSUM. */
 #include "fil0crypt.h"           /* fil_space_verify_crypt_checksum */
 
 #include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifndef PRIuMAX
 #define PRIuMAX   "llu"
@@ -68,6 +73,8 @@ static bool			do_one_page;
 static my_bool do_leaf;
 static my_bool per_page_details;
 static ulint n_merge;
+/* Number of threads for verifying the pages of a file. */
+static uint n_threads;
 extern ulong			srv_checksum_algorithm;
 static ulint physical_page_size;  /* Page size in bytes on disk. */
 ulong srv_page_size;
@@ -453,13 +460,15 @@ static bool is_page_all_zeroes(
 @param[in]	is_encrypted	true if page0 contained cryp_data
 				with crypt_scheme encrypted
 @param[in]	flags		tablespace flags
+@param[in]	page_no		expected page number
 @retval true if page is corrupted otherwise false. */
 static
 bool
 is_page_corrupted(
 	byte*		buf,
 	bool		is_encrypted,
-	ulint		flags)
+	ulint		flags,
+	unsigned long long page_no)
 {
 
 	/* enable if page is corrupted. */
@@ -475,7 +484,7 @@ is_page_corrupted(
 	ulint is_compressed = fil_space_t::is_compressed(flags);
 	const bool use_full_crc32 = fil_space_t::full_crc32(flags);
 
-	if (mach_read_from_4(buf + FIL_PAGE_OFFSET) != cur_page_num
+	if (mach_read_from_4(buf + FIL_PAGE_OFFSET) != page_no
 	    || (space_id != cur_space
 		&& (!use_full_crc32 || (!is_encrypted && !is_compressed)))) {
 		/* On pages that are not all zero, the page number
@@ -489,7 +498,7 @@ is_page_corrupted(
 			fprintf(log_file,
 				"page id mismatch space::" ULINTPF
 				" page::%llu \n",
-				space_id, cur_page_num);
+				space_id, page_no);
 		}
 
 		return true;
@@ -520,13 +529,13 @@ is_page_corrupted(
 				"space::" ULINTPF " page::%llu"
 				"; log sequence number:first = " ULINTPF
 				"; second = " ULINTPF "\n",
-				space_id, cur_page_num, logseq, logseqfield);
+				space_id, page_no, logseq, logseqfield);
 			if (logseq != logseqfield) {
 				fprintf(log_file,
 					"Fail; space::" ULINTPF " page::%llu"
 					" invalid (fails log "
 					"sequence number check)\n",
-					space_id, cur_page_num);
+					space_id, page_no);
 			}
 		}
 	}
@@ -550,7 +559,7 @@ is_page_corrupted(
 				"[page id: space=" ULINTPF
 				", page_number=%llu] may be corrupted;"
 				" key_version=%u\n",
-				space_id, cur_page_num, key_version);
+				space_id, page_no, key_version);
 		}
 	} else {
 		is_corrupted = true;
@@ -565,17 +574,17 @@ is_page_corrupted(
 
 /********************************************//*
  Check if page is doublewrite buffer or not.
- @param [in] page	buffer page
+ @param [in] page_no	page number
 
  @retval true  if page is doublewrite buffer otherwise false.
 */
 static
 bool
 is_page_doublewritebuffer(
-	const byte*	page)
+	unsigned long long	page_no)
 {
-	if ((cur_page_num >= FSP_EXTENT_SIZE)
-		&& (cur_page_num < FSP_EXTENT_SIZE * 3)) {
+	if ((page_no >= FSP_EXTENT_SIZE)
+		&& (page_no < FSP_EXTENT_SIZE * 3)) {
 		/* page is doublewrite buffer. */
 		return (true);
 	}
@@ -1296,6 +1305,11 @@ static struct my_option innochecksum_options[] = {
     &do_leaf, &do_leaf, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
   {"merge", 'm', "leaf page count if merge given number of consecutive pages",
    &n_merge, &n_merge, 0, GET_ULONG, REQUIRED_ARG, 0, 0, (longlong)10L, 0, 1, 0},
+  {"threads", 'T', "Number of threads for verifying the checksums of a file. "
+   "Only used when the pages are only verified (no --write, --log, "
+   "--page-type-summary, --page-type-dump or --per-page-details) and "
+   "the file is not read from stdin.",
+   &n_threads, &n_threads, 0, GET_UINT, REQUIRED_ARG, 1, 1, 256, 0, 1, 0},
 
   {0, 0, 0, 0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0}
 };
@@ -1322,7 +1336,8 @@ static void usage(void)
 	printf("Usage: %s [-c] [-s <start page>] [-e <end page>] "
 		"[-p <page>] [-i] [-v]  [-a <allow mismatches>] [-n] "
 		"[-C <strict-check>] [-w <write>] [-S] [-D <page type dump>] "
-		"[-l <log>] [-l] [-m <merge pages>] <filename or [-]>\n", my_progname);
+		"[-l <log>] [-l] [-m <merge pages>] [-T <threads>] "
+		"<filename or [-]>\n", my_progname);
 	printf("See https://mariadb.com/kb/en/library/innochecksum/"
 	       " for usage hints.\n");
 	my_print_help(innochecksum_options);
@@ -1493,7 +1508,7 @@ static int verify_checksum(
 	ulint			flags)
 {
 	int exit_status = 0;
-	if (is_page_corrupted(buf, is_encrypted, flags)) {
+	if (is_page_corrupted(buf, is_encrypted, flags, cur_page_num)) {
 		fprintf(stderr, "Fail: page::%llu invalid\n",
 			cur_page_num);
 
@@ -1541,6 +1556,198 @@ rewrite_checksum(
 		&& !write_file(filename, fil_in, buf, flags, pos);
 }
 
+/** Number of pages that a thread of the parallel verification
+reads with one request */
+static const ulint PARALLEL_READ_PAGES = 64;
+
+/** State of the parallel verification of a range of pages of one file */
+struct parallel_check_t {
+	/** file descriptor; only accessed with positioned reads */
+	int				fd;
+	/** whether the tablespace is encrypted */
+	bool				is_encrypted;
+	/** whether the file is the system tablespace */
+	bool				is_system_tablespace;
+	/** tablespace flags */
+	ulint				flags;
+	/** next page to be claimed by a thread */
+	std::atomic<unsigned long long>	next_page;
+	/** the page after the last page to check */
+	unsigned long long		end_page;
+	/** mismatches that may still be found before giving up */
+	unsigned long long		mismatch_limit;
+	/** number of mismatches found so far */
+	std::atomic<unsigned long long>	mismatch_count;
+	/** set if a read failed */
+	std::atomic<bool>		read_error;
+	/** protects corrupted */
+	std::mutex			mutex;
+	/** numbers of the pages that failed the verification */
+	std::vector<unsigned long long>	corrupted;
+};
+
+/** Read a part of a file. This can be invoked by several threads
+on the same file descriptor concurrently.
+@param[in]	fd	file descriptor
+@param[out]	buf	buffer
+@param[in]	len	number of bytes to read
+@param[in]	offset	file offset
+@return number of bytes read */
+static ulint read_file_at(int fd, byte* buf, ulint len,
+			  unsigned long long offset)
+{
+#ifdef _WIN32
+	OVERLAPPED	ov;
+	DWORD		n = 0;
+
+	memset(&ov, 0, sizeof ov);
+	ov.Offset = DWORD(offset);
+	ov.OffsetHigh = DWORD(offset >> 32);
+
+	if (!ReadFile(reinterpret_cast<HANDLE>(_get_osfhandle(fd)),
+		      buf, DWORD(len), &n, &ov)) {
+		return 0;
+	}
+
+	return n;
+#else
+	ssize_t	n = pread(fd, buf, len, off_t(offset));
+
+	return n < 0 ? 0 : ulint(n);
+#endif /* _WIN32 */
+}
+
+/** Verify the pages claimed from a parallel_check_t.
+@param[in,out]	check	parallel verification */
+static void parallel_check_thread(parallel_check_t* check)
+{
+	const ulint	len = PARALLEL_READ_PAGES * physical_page_size;
+	byte*		buf = static_cast<byte*>(
+		aligned_malloc(len, UNIV_PAGE_SIZE_MAX));
+	std::vector<unsigned long long>	corrupted;
+
+	while (!check->read_error
+	       && check->mismatch_count <= check->mismatch_limit) {
+		const unsigned long long first = check->next_page.fetch_add(
+			PARALLEL_READ_PAGES);
+
+		if (first >= check->end_page) {
+			break;
+		}
+
+		const ulint n = ulint(std::min<unsigned long long>(
+			PARALLEL_READ_PAGES, check->end_page - first));
+
+		if (read_file_at(check->fd, buf, n * physical_page_size,
+				 first * physical_page_size)
+		    != n * physical_page_size) {
+			fprintf(stderr, "Error reading " ULINTPF " bytes"
+				" at page %llu\n",
+				n * physical_page_size, first);
+			check->read_error = true;
+			break;
+		}
+
+		for (ulint i = 0; i < n; i++) {
+			const unsigned long long page_no = first + i;
+			byte* page = buf + i * physical_page_size;
+
+			if (check->is_system_tablespace
+			    && is_page_doublewritebuffer(page_no)) {
+				continue;
+			}
+
+			/* Page compressed pages do not contain checksum. */
+			const uint16_t page_type = fil_page_get_type(page);
+			if (page_type == FIL_PAGE_PAGE_COMPRESSED
+			    || page_type
+			    == FIL_PAGE_PAGE_COMPRESSED_ENCRYPTED) {
+				continue;
+			}
+
+			if (is_page_corrupted(page, check->is_encrypted,
+					      check->flags, page_no)) {
+				corrupted.push_back(page_no);
+				check->mismatch_count++;
+			}
+		}
+	}
+
+	aligned_free(buf);
+
+	std::lock_guard<std::mutex> lock(check->mutex);
+	check->corrupted.insert(check->corrupted.end(),
+				corrupted.begin(), corrupted.end());
+}
+
+/** Verify a range of pages of a file with n_threads threads.
+The file is split into chunks of PARALLEL_READ_PAGES pages that
+are claimed by the threads, and the mismatches are reported
+in ascending page order once all threads have finished.
+@param[in]	fil_in		file
+@param[in]	first_page	first page to check
+@param[in]	end_page	the page after the last page to check
+@param[in]	is_encrypted	true if tablespace is encrypted
+@param[in]	is_system_tablespace	true if this is the system tablespace
+@param[in]	flags		tablespace flags
+@param[in,out]	mismatch_count	Number of pages failed in checksum verify
+@retval 0 if the pages were verified within the allowed mismatch count
+@retval 1 on read error or if too many pages are corrupted */
+static int parallel_check(
+	FILE*			fil_in,
+	unsigned long long	first_page,
+	unsigned long long	end_page,
+	bool			is_encrypted,
+	bool			is_system_tablespace,
+	ulint			flags,
+	unsigned long long*	mismatch_count)
+{
+	parallel_check_t	check;
+	std::vector<std::thread> threads;
+
+	check.fd = fileno(fil_in);
+	check.is_encrypted = is_encrypted;
+	check.is_system_tablespace = is_system_tablespace;
+	check.flags = flags;
+	check.next_page = first_page;
+	check.end_page = end_page;
+	check.mismatch_limit = allow_mismatches - std::min(allow_mismatches,
+							   *mismatch_count);
+	check.mismatch_count = 0;
+	check.read_error = false;
+
+	for (uint i = 0; i < n_threads; i++) {
+		threads.emplace_back(parallel_check_thread, &check);
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	if (check.read_error) {
+		return 1;
+	}
+
+	std::sort(check.corrupted.begin(), check.corrupted.end());
+
+	for (unsigned long long page_no : check.corrupted) {
+		fprintf(stderr, "Fail: page::%llu invalid\n", page_no);
+
+		if (++*mismatch_count > allow_mismatches) {
+			fprintf(stderr,
+				"Exceeded the "
+				"maximum allowed "
+				"checksum mismatch "
+				"count::%llu current::%llu\n",
+				*mismatch_count,
+				allow_mismatches);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 int main(
 	int	argc,
 	char	**argv)
@@ -1894,6 +2101,37 @@ int main(
 			}
 		}
 
+		if (n_threads > 1 && !read_from_stdin && !do_write
+		    && !page_type_summary && !page_type_dump
+		    && !per_page_details && !is_log_enabled) {
+			const unsigned long long first = start_page
+				? start_page
+				: cur_offset ? cur_offset : 1;
+			const unsigned long long end = use_end_page
+				? std::min<unsigned long long>(end_page + 1,
+							       pages)
+				: pages;
+
+			if ((exit_status = parallel_check(
+				     fil_in, first, end, is_encrypted,
+				     is_system_tablespace, flags,
+				     &mismatch_count))) {
+				goto my_exit;
+			}
+
+			if (end == pages && size % physical_page_size) {
+				fprintf(stderr, "Error: bytes read (" ULINTPF
+					") doesn't match page size ("
+					ULINTPF ")\n",
+					ulint(size % physical_page_size),
+					physical_page_size);
+				exit_status = 1;
+				goto my_exit;
+			}
+
+			goto file_checked;
+		}
+
 		/* main checksumming loop */
 		cur_page_num = start_page ? start_page : cur_page_num + 1;
 
@@ -1927,7 +2165,7 @@ int main(
 first_non_zero:
 			if (is_system_tablespace) {
 				/* enable when page is double write buffer.*/
-				skip_page = is_page_doublewritebuffer(buf);
+				skip_page = is_page_doublewritebuffer(cur_page_num);
 			} else {
 				skip_page = false;
 			}
@@ -1989,6 +2227,7 @@ int main(
 			}
 		}
 
+file_checked:
 		if (!read_from_stdin) {
 			/* flcose() will flush the data and release the lock if
 			any acquired. */
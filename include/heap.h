@@ -31,7 +31,6 @@ extern "C" {
 #include <thr_lock.h>
 
 #include "my_compare.h"
-#include "my_tree.h"
 
 	/* defines used by heap-funktions */
 
@@ -108,6 +107,25 @@ typedef struct st_heap_block
 } HP_BLOCK;
 
 struct st_heap_info;			/* For referense */
+struct st_hp_btree_node;
+
+/*
+  BTREE indexes are B+trees of fixed size nodes, see hp_btree.c.
+  Interior nodes store for every child the number of keys under it,
+  which gives exact counts for hp_rb_records_in_range().
+*/
+
+typedef struct st_hp_btree
+{
+  struct st_hp_btree_node *root;
+  ha_rows records;			/* Keys in the tree */
+  uint version;				/* Changed when the tree changes */
+  uint key_length;			/* Length of one key slot */
+  uint node_length;			/* Length of one node */
+  uint leaf_keys;			/* Max keys in a leaf */
+  uint node_keys;			/* Max keys in an interior node */
+  uint node_key_offset;			/* Keys in an interior node */
+} HP_BTREE;
 
 typedef struct st_hp_keydef		/* Key definition with open */
 {
@@ -122,7 +140,7 @@ typedef struct st_hp_keydef		/* Key definition with open */
     #records estimates for heap key scans.
   */
   ha_rows hash_buckets; 
-  TREE rb_tree;
+  HP_BTREE btree;
   int (*write_key)(struct st_heap_info *info, struct st_hp_keydef *keyinfo,
 		   const uchar *record, uchar *recpos);
   int (*delete_key)(struct st_heap_info *info, struct st_hp_keydef *keyinfo,
@@ -130,16 +148,34 @@ typedef struct st_hp_keydef		/* Key definition with open */
   uint (*get_key_length)(struct st_hp_keydef *keydef, const uchar *key);
 } HP_KEYDEF;
 
+/*
+  BLOB data is not stored in the fixed length row. The row keeps the
+  length of the blob and a pointer to the first of a chain of continuation
+  blocks (see hp_blob.c) that hold the data.
+*/
+
+typedef struct st_hp_blobdef		/* Blob column definition */
+{
+  uint offset;				/* Offset of the column in the row */
+  uint packlength;			/* Bytes used to store the length */
+  uint null_pos;			/* Position to NULL indicator */
+  uchar null_bit;			/* If column may be NULL */
+} HP_BLOBDEF;
+
 typedef struct st_heap_share
 {
   HP_BLOCK block;
+  HP_BLOCK blob_block;			/* Continuation blocks of blobs */
   HP_KEYDEF  *keydef;
+  HP_BLOBDEF *blobdef;
   ulonglong data_length,index_length,max_table_size;
   ulonglong auto_increment;
   ulong min_records,max_records;	/* Params to open */
   ulong records;			/* records */
   ulong blength;			/* records rounded up to 2^n */
   ulong deleted;			/* Deleted records in database */
+  ulong blob_records;			/* Allocated blob blocks */
+  ulong blob_deleted;			/* Free blob blocks */
   uint key_stat_version;                /* version to indicate insert/delete */
   uint key_version;                     /* Updated on key change */
   uint file_version;                    /* Update on clear */
@@ -147,14 +183,18 @@ typedef struct st_heap_share
   uint visible;                         /* Offset to the visible/deleted mark */
   uint changed;
   uint keys,max_key_length;
+  uint blobs;				/* Number of blob columns */
   uint currently_disabled_keys;    /* saved value from "keys" when disabled */
   uint open_count;
   uchar *del_link;			/* Link to next block with del. rec */
+  uchar *blob_del_link;			/* Link to next free blob block */
   char * name;			/* Name of "memory-file" */
   time_t create_time;
   THR_LOCK lock;
+  mysql_rwlock_t latch;                 /* Row access with concurrent insert */
   my_bool delete_on_close;
   my_bool internal;                     /* Internal temporary table */
+  my_bool concurrent_insert;            /* INSERT may run with readers */
   LIST open_list;
   uint auto_key;
   uint auto_key_type;			/* real type of the auto key segment */
@@ -173,9 +213,13 @@ typedef struct st_heap_info
   uint opt_flag,update;
   uchar *lastkey;			/* Last used key with rkey */
   uchar *recbuf;                         /* Record buffer for rb-tree keys */
+  uchar **blob_chains;                  /* Blob blocks of row being written */
+  uchar *blob_buff;                     /* Blobs of the last read row */
+  size_t blob_buff_length;
   enum ha_rkey_function last_find_flag;
-  TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1];
-  TREE_ELEMENT **last_pos;
+  struct st_hp_btree_node *last_leaf;	/* BTREE read position */
+  uint last_slot;
+  uint last_version;			/* HP_BTREE::version at last read */
   uint key_version;                     /* Version at last read */
   uint file_version;                    /* Version at scan */
   uint lastkey_len;
@@ -188,9 +232,11 @@ typedef struct st_heap_info
 typedef struct st_heap_create_info
 {
   HP_KEYDEF *keydef;
+  HP_BLOBDEF *blobdef;                  /* Blob columns, in row order */
   uint auto_key;                        /* keynr [1 - maxkey] for auto key */
   uint auto_key_type;
   uint keys;
+  uint blobs;
   uint reclength;
   ulong max_records;
   ulong min_records;
@@ -739,6 +739,9 @@ ALTER TABLE help_topic MODIFY url TEXT NOT NULL;
 # MDEV-7383 - varbinary on mix/max of column_stats
 alter table column_stats modify min_value varbinary(255) DEFAULT NULL, modify max_value varbinary(255) DEFAULT NULL;
 
+# JSON_HB histograms
+alter table column_stats modify hist_type enum('SINGLE_PREC_HB','DOUBLE_PREC_HB','JSON_HB'), modify histogram longblob;
+
 --
 -- Ensure that all tables are of type Aria and transactional
 --
@@ -769,6 +772,7 @@ ALTER TABLE help_keyword ENGINE=Aria transactional=0;
 ALTER TABLE table_stats ENGINE=Aria transactional=0;
 ALTER TABLE column_stats ENGINE=Aria transactional=0;
 ALTER TABLE index_stats ENGINE=Aria transactional=0;
+ALTER TABLE column_group_stats ENGINE=Aria transactional=0;
 
 DELIMITER //
 IF 'BASE TABLE' = (select table_type from information_schema.tables where table_schema=database() and table_name='user') THEN
@@ -250,6 +250,7 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
   uint sort_len= sortlength(thd, sort_keys, &allow_packing_for_sortkeys);
 
   param.init_for_filesort(sort_len, table, max_rows, filesort->sort_positions);
+  param.sort_threads= (uint) thd->variables.sort_threads;
 
   sort->addon_fields=  param.addon_fields;
   sort->sort_keys= param.sort_keys;
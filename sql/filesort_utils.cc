@@ -18,6 +18,7 @@
 #include "filesort_utils.h"
 #include "sql_const.h"
 #include "sql_sort.h"
+#include "sql_class.h"
 #include "table.h"
 
 
@@ -159,6 +160,160 @@ void Filesort_buffer::free_sort_buffer()
 }
 
 
+/*
+  A part of the work of a parallel sort of the buffer: either sorting
+  of a slice of the keys or merging of two sorted runs of keys.
+*/
+
+struct Sort_task
+{
+  uchar **keys;                 // The slice to sort, or the first run
+  size_t count;                 // Number of keys in keys
+  uchar **keys2;                // The second run, or NULL when sorting
+  size_t count2;                // Number of keys in keys2
+  uchar **to;                   // Where to merge the runs into
+  qsort2_cmp cmp;
+  void *cmp_arg;
+};
+
+
+static void do_sort_task(Sort_task *task)
+{
+  if (!task->keys2)
+  {
+    if (task->to)
+      memcpy(task->to, task->keys, task->count * sizeof(uchar*));
+    else
+      my_qsort2(task->keys, task->count, sizeof(uchar*), task->cmp,
+                task->cmp_arg);
+    return;
+  }
+
+  uchar **a= task->keys, **a_end= a + task->count;
+  uchar **b= task->keys2, **b_end= b + task->count2;
+  uchar **to= task->to;
+  while (a < a_end && b < b_end)
+  {
+    if (task->cmp(task->cmp_arg, a, b) <= 0)
+      *to++= *a++;
+    else
+      *to++= *b++;
+  }
+  if (a < a_end)
+    memcpy(to, a, (a_end - a) * sizeof(uchar*));
+  else if (b < b_end)
+    memcpy(to, b, (b_end - b) * sizeof(uchar*));
+}
+
+
+extern "C" void *sort_task_thread(void *arg)
+{
+  my_thread_init();
+  do_sort_task(static_cast<Sort_task*>(arg));
+  my_thread_end();
+  return NULL;
+}
+
+
+/**
+  Run the tasks in separate threads.
+
+  The first task is run in the calling thread. A task for which no thread
+  can be created is run in the calling thread as well.
+*/
+
+static void run_sort_tasks(Sort_task *tasks, uint n_tasks)
+{
+  pthread_t threads[MAX_SORT_THREADS];
+  bool started[MAX_SORT_THREADS];
+
+  for (uint i= 1; i < n_tasks; i++)
+    started[i]= !mysql_thread_create(key_thread_parallel_sort, &threads[i],
+                                     NULL, sort_task_thread, &tasks[i]);
+  do_sort_task(&tasks[0]);
+  for (uint i= 1; i < n_tasks; i++)
+  {
+    if (started[i])
+      pthread_join(threads[i], NULL);
+    else
+      do_sort_task(&tasks[i]);
+  }
+}
+
+
+/**
+  Sort the keys with several threads.
+
+  The keys are split into n_threads slices that are sorted in parallel.
+  Then pairs of the sorted runs are merged in parallel, until one run is
+  left. The runs are merged between the keys and a temporary array.
+
+  @retval false  the keys have been sorted
+  @retval true   out of memory, nothing has been done
+*/
+
+static bool sort_keys_parallel(uchar **keys, size_t count, uint n_threads,
+                               qsort2_cmp cmp, void *cmp_arg)
+{
+  Sort_task tasks[MAX_SORT_THREADS];
+  size_t bounds[MAX_SORT_THREADS + 1];
+  uchar **from= keys, **to;
+  uchar **buffer;
+  uint n_runs= n_threads;
+
+  DBUG_ASSERT(n_threads > 1 && n_threads <= MAX_SORT_THREADS);
+  if (!(buffer= (uchar**) my_malloc(PSI_INSTRUMENT_ME, count*sizeof(uchar*),
+                                    MYF(MY_THREAD_SPECIFIC))))
+    return true;
+
+  THD *thd= current_thd;
+  PSI_stage_info org_stage;
+  thd->backup_stage(&org_stage);
+  THD_STAGE_INFO(thd, stage_sorting_in_parallel);
+
+  for (uint i= 0; i <= n_runs; i++)
+    bounds[i]= count * i / n_runs;
+  for (uint i= 0; i < n_runs; i++)
+    tasks[i]= { keys + bounds[i], bounds[i + 1] - bounds[i], NULL, 0, NULL,
+                cmp, cmp_arg };
+  run_sort_tasks(tasks, n_runs);
+
+  to= buffer;
+  while (n_runs > 1)
+  {
+    uint n_tasks= 0;
+    for (uint i= 0; i < n_runs; i+= 2, n_tasks++)
+    {
+      Sort_task *task= &tasks[n_tasks];
+      task->keys= from + bounds[i];
+      task->count= bounds[i + 1] - bounds[i];
+      task->to= to + bounds[i];
+      if (i + 1 < n_runs)
+      {
+        task->keys2= from + bounds[i + 1];
+        task->count2= bounds[i + 2] - bounds[i + 1];
+      }
+      else
+      {
+        task->keys2= NULL;                      // Just copy the odd run
+        task->count2= 0;
+      }
+      bounds[n_tasks]= bounds[i];
+    }
+    bounds[n_tasks]= count;
+    run_sort_tasks(tasks, n_tasks);
+    n_runs= n_tasks;
+    std::swap(from, to);
+  }
+
+  if (from != keys)
+    memcpy(keys, from, count * sizeof(uchar*));
+  my_free(buffer);
+  THD_STAGE_INFO(thd, org_stage);
+  return false;
+}
+
+
 void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
 {
   size_t size= param->sort_length;
@@ -171,6 +326,14 @@ void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
   if (!param->using_pq)
     reverse_record_pointers();
 
+  uint n_threads= MY_MIN(param->sort_threads,
+                         count / MIN_KEYS_PER_SORT_THREAD);
+  if (n_threads > 1 &&
+      !sort_keys_parallel(m_sort_keys, count, n_threads,
+                          param->get_compare_function(),
+                          param->get_compare_argument(&size)))
+    return;
+
   uchar **buffer= NULL;
   if (!param->using_packed_sortkeys() &&
       radixsort_is_appliccable(count, param->sort_length) &&
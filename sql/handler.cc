@@ -3111,6 +3111,64 @@ int handler::ha_rnd_pos(uchar *buf, uchar *pos)
   DBUG_RETURN(result);
 }
 
+int handler::ha_sample_next(uchar *buf)
+{
+  int result;
+  DBUG_ENTER("handler::ha_sample_next");
+  DBUG_ASSERT(table_share->tmp_table != NO_TMP_TABLE ||
+              m_lock_type != F_UNLCK);
+  DBUG_ASSERT(inited == RND);
+
+  do
+  {
+    TABLE_IO_WAIT(tracker, PSI_TABLE_FETCH_ROW, MAX_KEY, result,
+      { result= sample_next(buf); })
+    if (result != HA_ERR_RECORD_DELETED)
+      break;
+    status_var_increment(table->in_use->status_var.ha_read_rnd_deleted_count);
+  } while (!table->in_use->check_killed(1));
+
+  if (result == HA_ERR_RECORD_DELETED)
+    result= HA_ERR_ABORTED_BY_USER;
+  else
+  {
+    if (!result)
+    {
+      update_rows_read();
+      if (table->vfield && buf == table->record[0])
+        table->update_virtual_fields(this, VCOL_UPDATE_FOR_READ);
+    }
+    increment_statistics(&SSV::ha_read_rnd_next_count);
+  }
+
+  table->status=result ? STATUS_NOT_FOUND: 0;
+  DBUG_RETURN(result);
+}
+
+
+/*
+  Read the next row of the sample with a table scan, every row is taken
+  with the probability sample_fraction. The rows that are passed over
+  are counted as read like the rows of any table scan.
+*/
+
+int handler::sample_next(uchar *buf)
+{
+  int result;
+  THD *thd= table->in_use;
+  for (;;)
+  {
+    if ((result= rnd_next(buf)) == HA_ERR_RECORD_DELETED)
+      status_var_increment(thd->status_var.ha_read_rnd_deleted_count);
+    else if (result || thd_rnd(thd) <= sample_fraction)
+      return result;
+    else
+      increment_statistics(&SSV::ha_read_rnd_next_count);
+    if (thd->check_killed(1))
+      return HA_ERR_ABORTED_BY_USER;
+  }
+}
+
 int handler::ha_index_read_map(uchar *buf, const uchar *key,
                                       key_part_map keypart_map,
                                       enum ha_rkey_function find_flag)
@@ -349,7 +349,13 @@ enum chf_create_flags {
  */
 #define HA_ONLINE_ANALYZE             (1ULL << 59)
 
-#define HA_LAST_TABLE_FLAG HA_ONLINE_ANALYZE
+/*
+  INSERT can run while other statements read the table (table level lock
+  TL_WRITE_CONCURRENT_INSERT is honoured). Shown in EXPLAIN FORMAT=JSON.
+*/
+#define HA_CONCURRENT_INSERT          (1ULL << 60)
+
+#define HA_LAST_TABLE_FLAG HA_CONCURRENT_INSERT
 
 
 /* bits in index_flags(index_number) for what you can do with index */
@@ -3387,6 +3393,29 @@ class handler :public Sql_alloc
     DBUG_RETURN(rnd_end());
   }
   int ha_rnd_init_with_error(bool scan) __attribute__ ((warn_unused_result));
+  /*
+    Read a random sample of about 'fraction' of the rows of the table.
+    The sample is read like a table scan: ha_sample_init(), then
+    ha_sample_next() until HA_ERR_END_OF_FILE, then ha_sample_end().
+  */
+  int ha_sample_init(double fraction) __attribute__ ((warn_unused_result))
+  {
+    int result;
+    DBUG_ENTER("ha_sample_init");
+    DBUG_ASSERT(inited==NONE);
+    DBUG_ASSERT(fraction > 0 && fraction <= 1);
+    inited= (result= sample_init(fraction)) ? NONE: RND;
+    end_range= NULL;
+    DBUG_RETURN(result);
+  }
+  int ha_sample_end()
+  {
+    DBUG_ENTER("ha_sample_end");
+    DBUG_ASSERT(inited==RND);
+    inited=NONE;
+    end_range= NULL;
+    DBUG_RETURN(sample_end());
+  }
   int ha_reset();
   /* this is necessary in many places, e.g. in HANDLER command */
   int ha_index_or_rnd_end()
@@ -3939,6 +3968,7 @@ class handler :public Sql_alloc
   inline void ha_ft_end() { ft_end(); ft_handler=NULL; }
   int ha_rnd_next(uchar *buf);
   int ha_rnd_pos(uchar *buf, uchar *pos);
+  int ha_sample_next(uchar *buf);
   inline int ha_rnd_pos_by_record(uchar *buf);
   inline int ha_read_first_row(uchar *buf, uint primary_key);
 
@@ -4716,6 +4746,22 @@ class handler :public Sql_alloc
   inline void increment_statistics(ulong SSV::*offset) const;
   inline void decrement_statistics(ulong SSV::*offset) const;
 
+  /* Fraction of the rows to be read by a sample scan */
+  double sample_fraction;
+  /**
+    Sampling. By default this is a table scan that returns every row with
+    the probability 'fraction'. An engine that can find rows without
+    reading the rows before them may jump over the rows that are not in
+    the sample instead.
+  */
+  virtual int sample_init(double fraction)
+  {
+    sample_fraction= fraction;
+    return rnd_init(true);
+  }
+  virtual int sample_next(uchar *buf);
+  virtual int sample_end() { return rnd_end(); }
+
 private:
   /*
     Low-level primitives for storage engines.  These should be
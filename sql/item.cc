@@ -8616,8 +8616,25 @@ void Item_cache_wrapper::cleanup()
 }
 
 
+/* Check if the result of the expression is stored in a blob */
+
+static bool expr_cache_needs_blob(Item *item)
+{
+  switch (item->field_type()) {
+  case MYSQL_TYPE_TINY_BLOB:
+  case MYSQL_TYPE_MEDIUM_BLOB:
+  case MYSQL_TYPE_LONG_BLOB:
+  case MYSQL_TYPE_BLOB:
+  case MYSQL_TYPE_GEOMETRY:
+    return true;
+  default:
+    return item->too_big_for_varchar();
+  }
+}
+
+
 /**
-  Create an expression cache that uses a temporary table
+  Create an expression cache
 
   @param thd           Thread handle
   @param depends_on    Parameters of the expression to create cache for
@@ -8625,8 +8642,10 @@ void Item_cache_wrapper::cleanup()
   @details
   The function takes 'depends_on' as the list of all parameters for
   the expression wrapped into this object and creates an expression
-  cache in a temporary table containing the field for the parameters
-  and the result of the expression.
+  cache containing the field for the parameters and the result of the
+  expression. The cache is a hash table in memory if
+  @@subquery_cache_hash_size is set and the result is not a blob,
+  otherwise it is a temporary table.
 
   @retval FALSE OK
   @retval TRUE  Error
@@ -8636,7 +8655,13 @@ bool Item_cache_wrapper::set_cache(THD *thd)
 {
   DBUG_ENTER("Item_cache_wrapper::set_cache");
   DBUG_ASSERT(expr_cache == 0);
-  expr_cache= new Expression_cache_tmptable(thd, parameters, expr_value);
+  if (thd->variables.subquery_cache_hash_size &&
+      !expr_cache_needs_blob(expr_value))
+    expr_cache= new Expression_cache_hash(thd, parameters, expr_value,
+                                          (size_t) thd->variables.
+                                          subquery_cache_hash_size);
+  else
+    expr_cache= new Expression_cache_tmptable(thd, parameters, expr_value);
   DBUG_RETURN(expr_cache == NULL);
 }
 
@@ -8647,7 +8672,7 @@ Expression_cache_tracker* Item_cache_wrapper::init_tracker(MEM_ROOT *mem_root)
     Expression_cache_tracker* tracker=
       new(mem_root) Expression_cache_tracker(expr_cache);
     if (tracker)
-      ((Expression_cache_tmptable *)expr_cache)->set_tracker(tracker);
+      expr_cache->set_tracker(tracker);
     return tracker;
   }
   return NULL;
@@ -494,7 +494,7 @@ String *Item_func_from_base64::val_str(String *str)
 
 
 const char *histogram_types[] =
-           {"SINGLE_PREC_HB", "DOUBLE_PREC_HB", 0};
+           {"SINGLE_PREC_HB", "DOUBLE_PREC_HB", "JSON_HB", 0};
 static TYPELIB hystorgam_types_typelib=
   { array_elements(histogram_types),
     "histogram_types",
@@ -524,6 +524,17 @@ String *Item_func_decode_histogram::val_str(String *str)
     null_value= 1;
     return 0;
   }
+  if (type == JSON_HB)
+  {
+    /* The JSON document is readable as it is */
+    if (str->copy(*res))
+    {
+      null_value= 1;
+      return 0;
+    }
+    null_value= 0;
+    return str;
+  }
   if (type == DOUBLE_PREC_HB && res->length() % 2 != 0)
     res->length(res->length() - 1); // one byte is unused
 
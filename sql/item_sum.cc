@@ -752,7 +752,7 @@ bool Aggregator_distinct::setup(THD *thd)
     Setup can be called twice for ROLLUP items. This is a bug.
     Please add DBUG_ASSERT(tree == 0) here when it's fixed.
   */
-  if (tree || table || tmp_table_param)
+  if (tree || hash_set || table || tmp_table_param)
     return FALSE;
 
   if (item_sum->setup(thd))
@@ -863,6 +863,13 @@ bool Aggregator_distinct::setup(THD *thd)
         }
       }
       DBUG_ASSERT(tree == 0);
+      if (all_binary && tree_key_length)
+      {
+        /* Only the number of distinct keys is needed, not their order */
+        hash_set= new Unique_hash(tree_key_length,
+                                  item_sum->ram_limitation(thd));
+        return hash_set == 0;
+      }
       tree= new Unique(compare_key, cmp_arg, tree_key_length,
                        item_sum->ram_limitation(thd));
       /*
@@ -881,7 +888,7 @@ bool Aggregator_distinct::setup(THD *thd)
     Item *arg;
     DBUG_ENTER("Aggregator_distinct::setup");
     /* It's legal to call setup() more than once when in a subquery */
-    if (tree)
+    if (tree || hash_set)
       DBUG_RETURN(FALSE);
 
     /*
@@ -914,6 +921,17 @@ bool Aggregator_distinct::setup(THD *thd)
     /* XXX: check that the case of CHAR(0) works OK */
     tree_key_length= table->s->reclength - table->s->null_bytes;
 
+    if (field->result_type() != REAL_RESULT && tree_key_length)
+    {
+      /*
+        Integers and decimals are summed exactly, so the distinct values
+        can be fed back in any order.
+      */
+      hash_set= new Unique_hash(tree_key_length,
+                                item_sum->ram_limitation(thd));
+      DBUG_RETURN(hash_set == 0);
+    }
+
     /*
       Unique handles all unique elements in a tree until they can't fit
       in.  Then the tree is dumped to the temporary file. We can use
@@ -941,11 +959,13 @@ void Aggregator_distinct::clear()
   item_sum->clear();
   if (tree)
     tree->reset();
+  if (hash_set)
+    hash_set->reset();
   /* tree and table can be both null only if always_null */
   if (item_sum->sum_func() == Item_sum::COUNT_FUNC || 
       item_sum->sum_func() == Item_sum::COUNT_DISTINCT_FUNC)
   {
-    if (!tree && table)
+    if (!tree && !hash_set && table)
     {
       table->file->extra(HA_EXTRA_NO_CACHE);
       table->file->ha_delete_all_rows();
@@ -1002,6 +1022,8 @@ bool Aggregator_distinct::add()
       */
       return tree->unique_add(table->record[0] + table->s->null_bytes);
     }
+    if (hash_set)
+      return hash_set->unique_add(table->record[0] + table->s->null_bytes);
     if (unlikely((error= table->file->ha_write_tmp_row(table->record[0]))) &&
         table->file->is_fatal_error(error, HA_CHECK_DUP))
       return TRUE;
@@ -1012,12 +1034,14 @@ bool Aggregator_distinct::add()
     item_sum->get_arg(0)->save_in_field(table->field[0], FALSE);
     if (table->field[0]->is_null())
       return 0;
-    DBUG_ASSERT(tree);
+    DBUG_ASSERT(tree || hash_set);
     item_sum->null_value= 0;
     /*
       '0' values are also stored in the tree. This doesn't matter
       for SUM(DISTINCT), but is important for AVG(DISTINCT)
     */
+    if (hash_set)
+      return hash_set->unique_add(table->field[0]->ptr);
     return tree->unique_add(table->field[0]->ptr);
   }
 }
@@ -1058,7 +1082,12 @@ void Aggregator_distinct::endup()
       sum->count= (longlong) tree->elements_in_tree();
       endup_done= TRUE;
     }
-    if (!tree)
+    if (hash_set && hash_set->is_in_memory())
+    {
+      sum->count= (longlong) hash_set->elements_in_set();
+      endup_done= TRUE;
+    }
+    if (!tree && !hash_set)
     {
       /* there were blobs */
       table->file->info(HA_STATUS_VARIABLE | HA_STATUS_NO_LOCK);
@@ -1071,7 +1100,7 @@ void Aggregator_distinct::endup()
    We don't have a tree only if 'setup()' hasn't been called;
    this is the case of sql_executor.cc:return_zero_rows.
  */
-  if (tree && !endup_done)
+  if ((tree || hash_set) && !endup_done)
   {
    /*
      All tree's values are not NULL.
@@ -1086,7 +1115,10 @@ void Aggregator_distinct::endup()
       func= item_sum_distinct_walk_for_count;
     else
       func= item_sum_distinct_walk;
-    tree->walk(table, func, (void*) this);
+    if (hash_set)
+      hash_set->walk(table, func, (void*) this);
+    else
+      tree->walk(table, func, (void*) this);
     use_distinct_values= FALSE;
   }
   /* prevent consecutive recalculations */
@@ -1788,6 +1820,11 @@ Aggregator_distinct::~Aggregator_distinct()
     delete tree;
     tree= NULL;
   }
+  if (hash_set)
+  {
+    delete hash_set;
+    hash_set= NULL;
+  }
   if (table)
   {
     free_tmp_table(table->in_use, table);
@@ -1944,6 +1981,146 @@ void Item_sum_count::cleanup()
 }
 
 
+/*
+  Approximate count of distinct values
+*/
+
+bool Item_sum_approx_count_distinct::setup(THD *thd)
+{
+  if (!registers &&
+      !(registers= (uchar*) thd->calloc(HLL_REGISTERS)))
+    return TRUE;
+  return FALSE;
+}
+
+
+Item *Item_sum_approx_count_distinct::copy_or_same(THD* thd)
+{
+  return new (thd->mem_root) Item_sum_approx_count_distinct(thd, this);
+}
+
+
+void Item_sum_approx_count_distinct::clear()
+{
+  if (registers)
+    bzero(registers, HLL_REGISTERS);
+}
+
+
+/*
+  Hash the value of the argument. Values that compare as equal must get
+  the same hash, so strings are hashed with their collation.
+*/
+
+ulonglong Item_sum_approx_count_distinct::hash_arg()
+{
+  Item *arg= args[0];
+  ulonglong hash;
+
+  switch (arg->cmp_type()) {
+  case STRING_RESULT:
+  {
+    String *res= arg->val_str(&tmp_value);
+    ulong nr1= 1, nr2= 4;
+    if (arg->null_value)
+      return 0;
+    res->charset()->hash_sort((const uchar*) res->ptr(), res->length(),
+                              &nr1, &nr2);
+    hash= (ulonglong) nr1;
+    break;
+  }
+  case REAL_RESULT:
+  {
+    double nr= arg->val_real();
+    if (nr == 0.0)
+      nr= 0.0;                                  // -0.0 is equal to 0.0
+    memcpy(&hash, &nr, sizeof(hash));
+    break;
+  }
+  case DECIMAL_RESULT:
+  {
+    my_decimal value, *dec= arg->val_decimal(&value);
+    uchar buff[DECIMAL_MAX_FIELD_SIZE];
+    ulong nr1= 1, nr2= 4;
+    if (arg->null_value)
+      return 0;
+    uint precision= arg->decimal_precision();
+    uint scale= MY_MIN(arg->decimals, DECIMAL_MAX_SCALE);
+    dec->to_binary(buff, precision, scale);
+    my_charset_bin.hash_sort(buff, my_decimal_get_binary_size(precision, scale),
+                             &nr1, &nr2);
+    hash= (ulonglong) nr1;
+    break;
+  }
+  case TIME_RESULT:
+    hash= (ulonglong) (arg->field_type() == MYSQL_TYPE_TIME ?
+                       arg->val_time_packed(current_thd) :
+                       arg->val_datetime_packed(current_thd));
+    break;
+  case INT_RESULT:
+  case ROW_RESULT:
+  default:
+    hash= (ulonglong) arg->val_int();
+    break;
+  }
+  /* Spread the bits, as the registers use both ends of the hash */
+  hash^= hash >> 33;
+  hash*= 0xff51afd7ed558ccdULL;
+  hash^= hash >> 33;
+  hash*= 0xc4ceb9fe1a85ec53ULL;
+  hash^= hash >> 33;
+  return hash;
+}
+
+
+/*
+  The top HLL_PRECISION bits of the hash select a register, which keeps the
+  largest position of the first 1 bit in the rest of the hash seen so far.
+*/
+
+bool Item_sum_approx_count_distinct::add()
+{
+  ulonglong hash= hash_arg();
+  if (args[0]->null_value)
+    return 0;
+  uint idx= (uint) (hash >> (64 - HLL_PRECISION));
+  uint rank= 64 - my_bit_log2_uint64((hash << HLL_PRECISION) |
+                                     (1ULL << (HLL_PRECISION - 1)));
+  if (rank > registers[idx])
+    registers[idx]= (uchar) rank;
+  return 0;
+}
+
+
+longlong Item_sum_approx_count_distinct::val_int()
+{
+  DBUG_ASSERT(fixed == 1);
+  if (!registers)
+    return 0;
+  const double m= HLL_REGISTERS;
+  double sum= 0;
+  uint zeros= 0;
+  for (uint i= 0; i < HLL_REGISTERS; i++)
+  {
+    sum+= ldexp(1.0, -(int) registers[i]);
+    if (!registers[i])
+      zeros++;
+  }
+  double estimate= 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  /* The raw estimate is biased for small cardinalities, count the zeros */
+  if (estimate <= 2.5 * m && zeros)
+    estimate= m * log(m / zeros);
+  return (longlong) (estimate + 0.5);
+}
+
+
+void Item_sum_approx_count_distinct::cleanup()
+{
+  registers= NULL;
+  Item_sum_int::cleanup();
+}
+
+
 /*
   Average
 */
@@ -2361,10 +2538,146 @@ void Item_sum_min_max::clear()
   DBUG_ENTER("Item_sum_min_max::clear");
   value->clear();
   null_value= 1;
+  if (as_window_function)
+    clear_as_window();
   DBUG_VOID_RETURN;
 }
 
 
+/*
+  Prepare to be computed over a window frame
+
+  A frame that starts with UNBOUNDED PRECEDING never removes rows, and the
+  plain add() is enough. Otherwise the candidates for the result are kept
+  in a deque, so that adding and removing a row takes amortized constant
+  time.
+*/
+
+void Item_sum_min_max::setup_window_func(THD *thd, Window_spec *window_spec)
+{
+  Window_frame *frame= window_spec->window_frame;
+  as_window_function= FALSE;
+  if (!frame ||
+      (frame->top_bound->precedence_type == Window_frame_bound::PRECEDING &&
+       frame->top_bound->is_unbounded()))
+    return;
+
+  window_size= window_count= 0;
+  window_back= NULL;
+  if (grow_window(thd) ||
+      !(window_cmp= new Arg_comparator()))
+    return;
+  window_back= window_values[0];
+  window_cmp->set_cmp_func(this, (Item**) &arg_cache, (Item**) &window_back,
+                           FALSE);
+  as_window_function= TRUE;
+  clear_as_window();
+}
+
+
+/* Double the size of the deque, keeping its values */
+
+bool Item_sum_min_max::grow_window(THD *thd)
+{
+  uint new_size= window_size ? window_size * 2 : 16;
+  Item_cache **new_values;
+  ulonglong *new_seq;
+
+  if (!(new_values= (Item_cache**) thd->alloc(new_size * sizeof(Item_cache*))) ||
+      !(new_seq= (ulonglong*) thd->alloc(new_size * sizeof(ulonglong))))
+    return true;
+  for (uint i= 0; i < window_count; i++)
+  {
+    uint idx= (window_first + i) & (window_size - 1);
+    new_values[i]= window_values[idx];
+    new_seq[i]= window_seq[idx];
+  }
+  for (uint i= window_count; i < window_size; i++)
+    new_values[i]= window_values[(window_first + i) & (window_size - 1)];
+  for (uint i= window_size; i < new_size; i++)
+  {
+    if (!(new_values[i]= args[0]->get_cache(thd)))
+      return true;
+    new_values[i]->setup(thd, args[0]);
+    /* Don't cache value, as it will change */
+    new_values[i]->set_used_tables(RAND_TABLE_BIT);
+  }
+  window_values= new_values;
+  window_seq= new_seq;
+  window_size= new_size;
+  window_first= 0;
+  return false;
+}
+
+
+void Item_sum_min_max::clear_as_window()
+{
+  window_first= window_count= 0;
+  window_added= window_removed= 0;
+}
+
+
+void Item_sum_min_max::set_value_from_window()
+{
+  if (!window_count)
+  {
+    value->clear();
+    null_value= 1;
+    return;
+  }
+  value->store(window_values[window_first]);
+  value->cache_value();
+  null_value= 0;
+}
+
+
+bool Item_sum_min_max::add_as_window()
+{
+  ulonglong seq= window_added++;
+  arg_cache->cache_value();
+  if (arg_cache->null_value)
+    return 0;
+
+  /*
+    The values at the back of the deque that are not better than the new
+    one can't be the result any more: they leave the frame earlier.
+  */
+  while (window_count)
+  {
+    window_back= window_values[(window_first + window_count - 1) &
+                               (window_size - 1)];
+    if (window_cmp->compare() * cmp_sign > 0)
+      break;
+    window_count--;
+  }
+  if (window_count == window_size && grow_window(current_thd))
+    return 1;
+
+  uint idx= (window_first + window_count++) & (window_size - 1);
+  window_values[idx]->store(arg_cache);
+  window_values[idx]->cache_value();
+  window_seq[idx]= seq;
+  if (window_count == 1)
+    set_value_from_window();
+  return 0;
+}
+
+
+/* Remove the oldest row of the frame */
+
+void Item_sum_min_max::remove_as_window()
+{
+  if (window_removed < window_added)
+    window_removed++;
+  if (window_count && window_seq[window_first] < window_removed)
+  {
+    window_first= (window_first + 1) & (window_size - 1);
+    window_count--;
+    set_value_from_window();
+  }
+}
+
+
 bool
 Item_sum_min_max::get_date(THD *thd, MYSQL_TIME *ltime, date_mode_t fuzzydate)
 {
@@ -2456,6 +2769,11 @@ void Item_sum_min_max::cleanup()
   if (cmp)
     delete cmp;
   cmp= 0;
+  if (window_cmp)
+    delete window_cmp;
+  window_cmp= 0;
+  window_values= 0;
+  as_window_function= FALSE;
   /*
     by default it is TRUE to avoid TRUE reporting by
     Item_func_not_all/Item_func_nop_all if this item was never called.
@@ -2505,6 +2823,9 @@ bool Item_sum_min::add()
   DBUG_ENTER("Item_sum_min::add");
   DBUG_PRINT("enter", ("this: %p", this));
 
+  if (as_window_function)
+    DBUG_RETURN(add_as_window());
+
   if (unlikely(direct_added))
   {
     /* Change to use direct_item */
@@ -2545,6 +2866,9 @@ bool Item_sum_max::add()
   DBUG_ENTER("Item_sum_max::add");
   DBUG_PRINT("enter", ("this: %p", this));
 
+  if (as_window_function)
+    DBUG_RETURN(add_as_window());
+
   if (unlikely(direct_added))
   {
     /* Change to use direct_item */
@@ -2641,7 +2965,7 @@ void Item_sum_or::set_bits_from_counters()
   ulonglong value= 0;
   for (int i= 0; i < NUM_BIT_COUNTERS; i++)
   {
-    value|= bit_counters[i] > 0 ? (1 << i) : 0;
+    value|= bit_counters[i] > 0 ? (1ULL << i) : 0;
   }
   bits= value | reset_bits;
 }
@@ -2663,7 +2987,7 @@ void Item_sum_xor::set_bits_from_counters()
   ulonglong value= 0;
   for (int i= 0; i < NUM_BIT_COUNTERS; i++)
   {
-    value|= (bit_counters[i] % 2) ? (1 << i) : 0;
+    value|= (bit_counters[i] % 2) ? (1ULL << i) : 0;
   }
   bits= value ^ reset_bits;
 }
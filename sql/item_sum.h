@@ -356,7 +356,7 @@ class Item_sum :public Item_func_or_sum
     CUME_DIST_FUNC, NTILE_FUNC, FIRST_VALUE_FUNC, LAST_VALUE_FUNC,
     NTH_VALUE_FUNC, LEAD_FUNC, LAG_FUNC, PERCENTILE_CONT_FUNC,
     PERCENTILE_DISC_FUNC, SP_AGGREGATE_FUNC, JSON_ARRAYAGG_FUNC,
-    JSON_OBJECTAGG_FUNC
+    JSON_OBJECTAGG_FUNC, APPROX_COUNT_DISTINCT_FUNC
   };
 
   Item **ref_by; /* pointer to a ref to the object used to register it */
@@ -430,6 +430,7 @@ class Item_sum :public Item_func_or_sum
     case UDF_SUM_FUNC:
     case GROUP_CONCAT_FUNC:
     case JSON_ARRAYAGG_FUNC:
+    case APPROX_COUNT_DISTINCT_FUNC:
       return true;
     default:
       return false;
@@ -594,6 +595,7 @@ class Item_sum :public Item_func_or_sum
 
 
 class Unique;
+class Unique_hash;
 
 
 /**
@@ -652,6 +654,15 @@ class Aggregator_distinct : public Aggregator
   */
   Unique *tree;
 
+  /*
+    Used instead of 'tree' when the keys can be compared as binary strings
+    and the order in which they are walked doesn't matter: all
+    COUNT(DISTINCT) keys without character data, and SUM/AVG(DISTINCT) of
+    integers and decimals. The sum of floating point values depends on
+    the order of the summation, so they still use the tree.
+  */
+  Unique_hash *hash_set;
+
   /* 
     The length of the temp table row. Must be a member of the class as it
     gets passed down to simple_raw_key_cmp () as a compare function argument
@@ -682,7 +693,7 @@ class Aggregator_distinct : public Aggregator
 public:
   Aggregator_distinct (Item_sum *sum) :
     Aggregator(sum), table(NULL), tmp_table_param(NULL), tree(NULL),
-    always_null(false), use_distinct_values(false) {}
+    hash_set(NULL), always_null(false), use_distinct_values(false) {}
   virtual ~Aggregator_distinct ();
   Aggregator_type Aggrtype() { return DISTINCT_AGGREGATOR; }
 
@@ -919,6 +930,46 @@ class Item_sum_count :public Item_sum_int
 };
 
 
+/*
+  APPROX_COUNT_DISTINCT(expr) estimates the number of distinct non-NULL
+  values with the HyperLogLog algorithm. It uses 2^HLL_PRECISION one byte
+  registers per group, whatever the number of values, and its standard
+  error is about 1.04/sqrt(2^HLL_PRECISION), i.e. 0.8%.
+*/
+
+class Item_sum_approx_count_distinct :public Item_sum_int
+{
+  static const uint HLL_PRECISION= 14;
+  static const uint HLL_REGISTERS= 1U << HLL_PRECISION;
+  uchar *registers;
+  String tmp_value;
+
+  void clear();
+  bool add();
+  ulonglong hash_arg();
+
+public:
+  Item_sum_approx_count_distinct(THD *thd, Item *item_par):
+    Item_sum_int(thd, item_par), registers(NULL)
+  { quick_group= 0; }
+  Item_sum_approx_count_distinct(THD *thd,
+                                 Item_sum_approx_count_distinct *item):
+    Item_sum_int(thd, item), registers(NULL)
+  {}
+  enum Sumfunctype sum_func () const { return APPROX_COUNT_DISTINCT_FUNC; }
+  const Type_handler *type_handler() const { return &type_handler_slonglong; }
+  bool setup(THD *thd);
+  void cleanup();
+  longlong val_int();
+  void reset_field() { DBUG_ASSERT(0); }        // not used
+  void update_field() { DBUG_ASSERT(0); }       // not used
+  const char *func_name() const { return "approx_count_distinct("; }
+  Item *copy_or_same(THD* thd);
+  Item *get_copy(THD *thd)
+  { return get_item_copy<Item_sum_approx_count_distinct>(thd, this); }
+};
+
+
 class Item_sum_avg :public Item_sum_sum
 {
 public:
@@ -1114,16 +1165,41 @@ class Item_sum_min_max :public Item_sum_hybrid
   bool was_values;  // Set if we have found at least one row (for max/min only)
   bool was_null_value;
 
+  /*
+    Used as a window function with a frame that removes rows.
+    A frame adds rows at its end and removes them from its start in the
+    same order, so only the rows that are better than all the rows added
+    after them can become the result. Their values are kept in a deque,
+    the best one first: window_values[] is a ring buffer of window_count
+    values starting at window_first, window_seq[] has the numbers of their
+    rows in the order of adding.
+  */
+  bool as_window_function;
+  Item_cache **window_values;
+  ulonglong *window_seq;
+  uint window_size, window_first, window_count;
+  ulonglong window_added, window_removed;
+  Item_cache *window_back;          // Compared with arg_cache by window_cmp
+  Arg_comparator *window_cmp;
+
+  bool add_as_window();
+  void remove_as_window();
+  void clear_as_window();
+  bool grow_window(THD *thd);
+  void set_value_from_window();
+
 public:
   Item_sum_min_max(THD *thd, Item *item_par,int sign):
     Item_sum_hybrid(thd, item_par),
     direct_added(FALSE), value(0), arg_cache(0), cmp(0),
-    cmp_sign(sign), was_values(TRUE)
+    cmp_sign(sign), was_values(TRUE), as_window_function(FALSE),
+    window_values(0), window_cmp(0)
   { collation.set(&my_charset_bin); }
   Item_sum_min_max(THD *thd, Item_sum_min_max *item)
     :Item_sum_hybrid(thd, item),
     direct_added(FALSE), value(item->value), arg_cache(0),
-    cmp_sign(item->cmp_sign), was_values(item->was_values)
+    cmp_sign(item->cmp_sign), was_values(item->was_values),
+    as_window_function(FALSE), window_values(0), window_cmp(0)
   { }
   bool fix_fields(THD *, Item **);
   bool fix_length_and_dec();
@@ -1154,6 +1230,21 @@ class Item_sum_min_max :public Item_sum_hybrid
   void restore_to_before_no_rows_in_result();
   Field *create_tmp_field(MEM_ROOT *root, bool group, TABLE *table);
   void setup_caches(THD *thd) { setup_hybrid(thd, arguments()[0], NULL); }
+  void setup_window_func(THD *thd, Window_spec *window_spec);
+  void remove()
+  {
+    if (as_window_function)
+    {
+      remove_as_window();
+      return;
+    }
+    /* The frame never removes rows, see setup_window_func() */
+    DBUG_ASSERT(0);
+  }
+  bool supports_removal() const
+  {
+    return true;
+  }
 };
 
 
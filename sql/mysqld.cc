@@ -116,6 +116,7 @@
 #include "sp_cache.h"
 #include "sql_reload.h"  // reload_acl_and_cache
 #include "sp_head.h"  // init_sp_psi_keys
+#include "sql_plan_cache.h"
 
 #ifdef HAVE_POLL_H
 #include <poll.h>
@@ -1102,7 +1103,8 @@ static PSI_cond_info all_server_conds[]=
 PSI_thread_key key_thread_delayed_insert,
   key_thread_handle_manager, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand,
-  key_thread_slave_background, key_rpl_parallel_thread;
+  key_thread_slave_background, key_rpl_parallel_thread,
+  key_thread_parallel_sort;
 PSI_thread_key key_thread_ack_receiver;
 
 static PSI_thread_info all_server_threads[]=
@@ -1114,7 +1116,8 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
   { &key_thread_slave_background, "slave_background", PSI_FLAG_GLOBAL},
   { &key_thread_ack_receiver, "Ack_receiver", PSI_FLAG_GLOBAL},
-  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0}
+  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0},
+  { &key_thread_parallel_sort, "parallel_sort", 0}
 };
 
 #ifdef HAVE_MMAP
@@ -1962,6 +1965,7 @@ static void clean_up(bool print_message)
   if (tc_log)
     tc_log->close();
   xid_cache_free();
+  digest_plan_cache_free();
   tdc_deinit();
   mdl_destroy();
   dflt_key_cache= 0;
@@ -4577,6 +4581,7 @@ static int init_server_components()
   mdl_init();
   if (tdc_init() || hostname_cache_init())
     unireg_abort(1);
+  digest_plan_cache_init();
 
   query_cache_set_min_res_unit(query_cache_min_res_unit);
   query_cache_result_size_limit(query_cache_limit);
@@ -7387,6 +7392,9 @@ SHOW_VAR status_vars[]= {
   {"Opened_table_definitions", (char*) offsetof(STATUS_VAR, opened_shares), SHOW_LONG_STATUS},
   {"Opened_tables",            (char*) offsetof(STATUS_VAR, opened_tables), SHOW_LONG_STATUS},
   {"Opened_views",             (char*) offsetof(STATUS_VAR, opened_views), SHOW_LONG_STATUS},
+  {"Optimizer_plan_cache_entries", (char*) &digest_plan_cache_entries, SHOW_LONG},
+  {"Optimizer_plan_cache_hits", (char*) offsetof(STATUS_VAR, optimizer_plan_cache_hits), SHOW_LONG_STATUS},
+  {"Optimizer_plan_cache_misses", (char*) offsetof(STATUS_VAR, optimizer_plan_cache_misses), SHOW_LONG_STATUS},
   {"Prepared_stmt_count",      (char*) &show_prepared_stmt_count, SHOW_SIMPLE_FUNC},
   {"Rows_sent",                (char*) offsetof(STATUS_VAR, rows_sent), SHOW_LONGLONG_STATUS},
   {"Rows_read",                (char*) offsetof(STATUS_VAR, rows_read), SHOW_LONGLONG_STATUS},
@@ -9143,6 +9151,7 @@ PSI_stage_info stage_slave_has_read_all_relay_log= { 0, "Slave has read all rela
 PSI_stage_info stage_sorting= { 0, "Sorting", 0};
 PSI_stage_info stage_sorting_for_group= { 0, "Sorting for group", 0};
 PSI_stage_info stage_sorting_for_order= { 0, "Sorting for order", 0};
+PSI_stage_info stage_sorting_in_parallel= { 0, "Sorting in parallel", 0};
 PSI_stage_info stage_sorting_result= { 0, "Sorting result", 0};
 PSI_stage_info stage_statistics= { 0, "Statistics", 0};
 PSI_stage_info stage_sql_thd_waiting_until_delay= { 0, "Waiting until MASTER_DELAY seconds after master executed event", 0 };
@@ -9371,6 +9380,7 @@ PSI_stage_info *all_server_stages[]=
   & stage_sorting,
   & stage_sorting_for_group,
   & stage_sorting_for_order,
+  & stage_sorting_in_parallel,
   & stage_sorting_result,
   & stage_sql_thd_waiting_until_delay,
   & stage_statistics,
@@ -340,6 +340,7 @@ class TABLE_READ_PLAN;
   class TRP_INDEX_INTERSECT;
   class TRP_INDEX_MERGE;
   class TRP_GROUP_MIN_MAX;
+  class TRP_SKIP_SCAN;
 
 struct st_index_scan_info;
 struct st_ror_scan_info;
@@ -378,6 +379,9 @@ TABLE_READ_PLAN *merge_same_index_scans(PARAM *param, SEL_IMERGE *imerge,
 static
 TRP_GROUP_MIN_MAX *get_best_group_min_max(PARAM *param, SEL_TREE *tree,
                                           double read_time);
+static
+TRP_SKIP_SCAN *get_best_skip_scan(PARAM *param, SEL_TREE *tree,
+                                  double read_time);
 
 #ifndef DBUG_OFF
 static void print_sel_tree(PARAM *param, SEL_TREE *tree, key_map *tree_map,
@@ -2521,6 +2525,50 @@ void TRP_GROUP_MIN_MAX::trace_basic_info(PARAM *param,
 }
 
 
+/*
+  Plan for a QUICK_SKIP_SCAN_SELECT scan.
+*/
+
+class TRP_SKIP_SCAN : public TABLE_READ_PLAN
+{
+public:
+  SEL_ARG *key; /* intervals of the first key part with a condition */
+  uint     key_idx; /* key number in PARAM::key */
+  uint     prefix_key_parts; /* key parts before key->part */
+  ha_rows  num_groups; /* estimate of # distinct prefixes */
+
+  TRP_SKIP_SCAN(SEL_ARG *key_arg, uint idx_arg, ha_rows num_groups_arg)
+   : key(key_arg), key_idx(idx_arg), prefix_key_parts(key_arg->part),
+     num_groups(num_groups_arg)
+  {}
+  virtual ~TRP_SKIP_SCAN() {}                 /* Remove gcc warning */
+
+  QUICK_SELECT_I *make_quick(PARAM *param, bool retrieve_full_rows,
+                             MEM_ROOT *parent_alloc);
+  void trace_basic_info(PARAM *param,
+                        Json_writer_object *trace_object) const;
+};
+
+
+void TRP_SKIP_SCAN::trace_basic_info(PARAM *param,
+                                     Json_writer_object *trace_object) const
+{
+  DBUG_ASSERT(trace_object->trace_started());
+  const KEY &cur_key= param->table->key_info[param->real_keynr[key_idx]];
+  const KEY_PART_INFO *key_part= cur_key.key_part;
+
+  trace_object->add("type", "skip_scan")
+               .add("index", cur_key.name)
+               .add("prefix_key_parts", (ulonglong) prefix_key_parts)
+               .add("groups", num_groups)
+               .add("rows", records)
+               .add("cost", read_cost);
+
+  Json_writer_array trace_range(param->thd, "ranges");
+  trace_ranges(&trace_range, param, key_idx, key, key_part);
+}
+
+
 typedef struct st_index_scan_info
 {
   uint      idx;      /* # of used key in param->keys */
@@ -3045,6 +3093,36 @@ int SQL_SELECT::test_quick_select(THD *thd, key_map keys_to_use,
         remove_nonrange_trees(&param, tree);
     }
 
+    /*
+      Try to construct a QUICK_SKIP_SCAN_SELECT. It uses the trees that do
+      not start with the first key part.
+    */
+    if (tree && !only_single_index_range_scan &&
+        thd->variables.optimizer_skip_scan)
+    {
+      TRP_SKIP_SCAN *skip_trp;
+      restore_nonrange_trees(&param, tree, backup_keys);
+      if ((skip_trp= get_best_skip_scan(&param, tree, read_time)))
+      {
+        Json_writer_object skip_summary(thd, "best_skip_scan_summary");
+
+        if (unlikely(thd->trace_started()))
+          skip_trp->trace_basic_info(&param, &skip_summary);
+
+        if (skip_trp->read_cost < best_read_time)
+        {
+          skip_summary.add("chosen", true);
+          set_if_smaller(param.table->opt_range_condition_rows,
+                         skip_trp->records);
+          best_trp= skip_trp;
+          best_read_time= best_trp->read_cost;
+        }
+        else
+          skip_summary.add("chosen", false).add("cause", "cost");
+      }
+      remove_nonrange_trees(&param, tree);
+    }
+
     thd->mem_root= param.old_root;
 
     /* If we got a read plan, create a quick select from it. */
@@ -3330,7 +3408,8 @@ bool calculate_cond_selectivity_for_table(THD *thd, TABLE *table, Item **cond)
 
   QUICK_SELECT_I *quick;
   if ((quick=table->reginfo.join_tab->quick) &&
-      quick->get_type() == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX)
+      (quick->get_type() == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX ||
+       quick->get_type() == QUICK_SELECT_I::QS_TYPE_SKIP_SCAN))
   {
     table->cond_selectivity*= (quick->records/table_records);
     DBUG_RETURN(FALSE);
@@ -3471,6 +3550,14 @@ bool calculate_cond_selectivity_for_table(THD *thd, TABLE *table, Item **cond)
     MEM_ROOT alloc;
     SEL_TREE *tree;
     double rows;
+    MY_BITMAP equality_columns, grouped_columns;
+    my_bitmap_map *equality_buf, *grouped_buf;
+
+    if (!(equality_buf= (my_bitmap_map*) thd->alloc(table->s->column_bitmap_size)) ||
+        !(grouped_buf= (my_bitmap_map*) thd->alloc(table->s->column_bitmap_size)))
+      DBUG_RETURN(TRUE);
+    my_bitmap_init(&equality_columns, equality_buf, table->s->fields, FALSE);
+    my_bitmap_init(&grouped_columns, grouped_buf, table->s->fields, FALSE);
   
     init_sql_alloc(key_memory_quick_range_select_root, &alloc,
                    thd->variables.range_alloc_block_size, 0, MYF(MY_THREAD_SPECIFIC));
@@ -3538,18 +3625,56 @@ bool calculate_cond_selectivity_for_table(THD *thd, TABLE *table, Item **cond)
             key->field->cond_selectivity= rows/table_records;
             selectivity_for_column.add("selectivity_from_histogram",
                                        key->field->cond_selectivity);
+            if (key->elements == 1 && key->is_singlepoint() &&
+                !key->is_null_interval())
+              bitmap_set_bit(&equality_columns, key->field->field_index);
           }
         }
       }
     }
 
+    /*
+      The selectivities of equalities on all columns of a column group
+      with statistics are not taken as independent
+    */
+    for (Column_group_statistics *group=
+           table->s->stats_cb.table_stats->column_groups;
+         group;
+         group= group->next)
+    {
+      uint i;
+      for (i= 0; i < group->columns; i++)
+      {
+        uint fieldnr= group->fieldnr[i];
+        if (!bitmap_is_set(&equality_columns, fieldnr) ||
+            bitmap_is_set(&handled_columns, fieldnr) ||
+            bitmap_is_set(&grouped_columns, fieldnr))
+          break;
+      }
+      if (i < group->columns)
+        continue;
+      double group_selectivity= get_column_group_selectivity(table, group);
+      table->cond_selectivity*= group_selectivity;
+      Json_writer_object selectivity_for_group(thd);
+      Json_writer_array group_columns(thd, "column_group");
+      for (i= 0; i < group->columns; i++)
+      {
+        bitmap_set_bit(&grouped_columns, group->fieldnr[i]);
+        group_columns.add(table->field[group->fieldnr[i]]->field_name);
+      }
+      group_columns.end();
+      selectivity_for_group.add("selectivity_from_column_group",
+                                group_selectivity);
+    }
+
     for (Field **field_ptr= table->field; *field_ptr; field_ptr++)
     {
       Field *table_field= *field_ptr;   
       if (bitmap_is_set(used_fields, table_field->field_index) &&
           table_field->cond_selectivity < 1.0)
       {
-        if (!bitmap_is_set(&handled_columns, table_field->field_index))
+        if (!bitmap_is_set(&handled_columns, table_field->field_index) &&
+            !bitmap_is_set(&grouped_columns, table_field->field_index))
           table->cond_selectivity*= table_field->cond_selectivity;
       }
     }
@@ -13341,6 +13466,363 @@ void QUICK_ROR_UNION_SELECT::add_used_key_part_to_set()
 }
 
 
+/*******************************************************************************
+* Implementation of QUICK_SKIP_SCAN_SELECT
+*******************************************************************************/
+
+/*
+  Estimate the number of rows in the intervals of a key part, over all
+  values of the key parts before it
+
+  SYNOPSIS
+    skip_scan_range_rows()
+      param       Parameter from test_quick_select
+      index_info  The index
+      key_tree    SEL_ARG tree for the first key part with a condition
+      num_groups  Estimate of the number of distinct prefixes
+
+  DESCRIPTION
+    The statistics of the column are used when they have been read.
+    Otherwise only single point intervals can be estimated, by the number
+    of records per key of the index.
+
+  RETURN
+    Estimate of the number of rows
+    DBL_MAX if there is no estimate for some interval
+*/
+
+static double skip_scan_range_rows(PARAM *param, KEY *index_info,
+                                   SEL_ARG *key_tree, ha_rows num_groups)
+{
+  KEY_PART_INFO *key_part= index_info->key_part + key_tree->part;
+  Field *field= key_part->field;
+  double table_records= (double) param->table->stat_records();
+  double rec_per_key= index_info->actual_rec_per_key(key_tree->part);
+  bool have_stats= param->table->stats_is_read && is_eits_usable(field);
+  double total_rows= 0;
+
+  for (SEL_ARG *arg= key_tree->first(); arg; arg= arg->next)
+  {
+    key_range min_range, max_range;
+    double rows;
+
+    if (have_stats)
+    {
+      min_range.key= arg->min_value;
+      min_range.length= max_range.length= key_part->store_length;
+      max_range.key= arg->max_value;
+      rows= get_column_range_cardinality(field,
+                                         (arg->min_flag & NO_MIN_RANGE) ?
+                                         NULL : &min_range,
+                                         (arg->max_flag & NO_MAX_RANGE) ?
+                                         NULL : &max_range,
+                                         arg->min_flag | arg->max_flag);
+    }
+    else if (arg->is_singlepoint() && rec_per_key != 0.0)
+      rows= rec_per_key * num_groups;
+    else
+      return DBL_MAX;
+    total_rows+= rows;
+  }
+  return MY_MIN(total_rows, table_records);
+}
+
+
+/*
+  Get the best skip scan plan for the range trees of the indexes
+
+  SYNOPSIS
+    get_best_skip_scan()
+      param      Parameter from test_quick_select
+      tree       Range trees, including those that do not start with the
+                 first key part
+      read_time  Best read time so far (=table/index scan time)
+
+  DESCRIPTION
+    A skip scan reads the ranges of key part k within every distinct value
+    of the key parts 0..k-1 that have no condition. The distinct prefixes
+    are found by jumping in the index with HA_READ_AFTER_KEY. The plan is
+    considered when
+    - the tree of an index starts with a key part k > 0,
+    - the index is covering and ordered, and has no prefix key parts
+      before k,
+    - the number of records per prefix is known.
+
+    The cost is the cost of one index dive for every prefix and every range,
+    bounded by the number of index blocks, plus the cost of the rows read.
+
+  RETURN
+    The cheapest skip scan plan if it is cheaper than read_time
+    NULL otherwise
+*/
+
+static TRP_SKIP_SCAN *
+get_best_skip_scan(PARAM *param, SEL_TREE *tree, double read_time)
+{
+  TABLE *table= param->table;
+  TRP_SKIP_SCAN *best_trp= NULL;
+  double table_records= (double) table->stat_records();
+  DBUG_ENTER("get_best_skip_scan");
+
+  if (table->no_keyread)
+    DBUG_RETURN(NULL);
+
+  for (uint idx= 0; idx < param->keys; idx++)
+  {
+    SEL_ARG *key_tree= tree->keys[idx];
+    uint keynr= param->real_keynr[idx];
+    KEY *index_info= table->key_info + keynr;
+    KEY_PART_INFO *key_part;
+    uint prefix_key_parts, n_ranges= 0;
+    ulong index_flags;
+
+    if (!key_tree || !key_tree->part ||
+        key_tree->type != SEL_ARG::KEY_RANGE ||
+        !table->covering_keys.is_set(keynr) ||
+        (index_info->flags & (HA_SPATIAL | HA_FULLTEXT)))
+      continue;
+    prefix_key_parts= key_tree->part;
+    index_flags= table->file->index_flags(keynr, prefix_key_parts, 1);
+    if ((index_flags & (HA_READ_NEXT | HA_READ_ORDER | HA_READ_RANGE)) !=
+        (HA_READ_NEXT | HA_READ_ORDER | HA_READ_RANGE))
+      continue;
+    for (key_part= index_info->key_part;
+         key_part < index_info->key_part + prefix_key_parts;
+         key_part++)
+    {
+      if (key_part->key_part_flag & HA_PART_KEY_SEG)
+        break;
+    }
+    if (key_part < index_info->key_part + prefix_key_parts)
+      continue;
+
+    double keys_per_group= index_info->actual_rec_per_key(prefix_key_parts -
+                                                          1);
+    if (keys_per_group == 0.0)
+      continue;
+    ha_rows num_groups= (ha_rows) (table_records / keys_per_group) + 1;
+    double rows= skip_scan_range_rows(param, index_info, key_tree,
+                                      num_groups);
+    if (rows == DBL_MAX)
+      continue;
+    for (SEL_ARG *arg= key_tree->first(); arg; arg= arg->next)
+      n_ranges++;
+
+    /* Assume block is 75 % full, as in cost_group_min_max() */
+    uint keys_per_block= (uint) (table->file->stats.block_size * 3 / 4 /
+                                 (index_info->key_length +
+                                  table->file->ref_length) + 1);
+    set_if_bigger(keys_per_block, 2);
+    double num_blocks= table_records / keys_per_block + 1;
+    double dives= (double) num_groups * (n_ranges + 1);
+    double tree_traversal_cost=
+      ceil(log(MY_MAX(table_records, 2.0)) /
+           log(static_cast<double>(keys_per_block))) / (2 * TIME_FOR_COMPARE);
+    double io_cost= MY_MIN(dives + rows / keys_per_block, num_blocks);
+    double cpu_cost= dives * tree_traversal_cost + rows / TIME_FOR_COMPARE;
+    double cost= io_cost + cpu_cost;
+
+    DBUG_PRINT("info", ("index: %u  groups: %lu  ranges: %u  rows: %g  "
+                        "cost: %g", keynr, (ulong) num_groups, n_ranges,
+                        rows, cost));
+    if (cost < read_time &&
+        (!best_trp || cost < best_trp->read_cost))
+    {
+      if (!(best_trp= new (param->mem_root) TRP_SKIP_SCAN(key_tree, idx,
+                                                          num_groups)))
+        DBUG_RETURN(NULL);
+      best_trp->read_cost= cost;
+      best_trp->records= MY_MAX((ha_rows) rows, 1);
+    }
+  }
+  DBUG_RETURN(best_trp);
+}
+
+
+QUICK_SELECT_I *TRP_SKIP_SCAN::make_quick(PARAM *param,
+                                          bool retrieve_full_rows,
+                                          MEM_ROOT *parent_alloc)
+{
+  QUICK_SKIP_SCAN_SELECT *quick;
+  bool create_err= FALSE;
+  DBUG_ENTER("TRP_SKIP_SCAN::make_quick");
+
+  if (!(quick= new QUICK_SKIP_SCAN_SELECT(param->thd, param->table,
+                                          param->real_keynr[key_idx],
+                                          prefix_key_parts,
+                                          MY_TEST(parent_alloc), parent_alloc,
+                                          &create_err)))
+    DBUG_RETURN(NULL);
+
+  if (create_err ||
+      get_quick_keys(param, quick, param->key[key_idx], key,
+                     param->min_key, 0, param->max_key, 0) ||
+      quick->init_prefix(param->key[key_idx]))
+  {
+    delete quick;
+    DBUG_RETURN(NULL);
+  }
+  quick->records= records;
+  quick->read_time= read_cost;
+  DBUG_RETURN(quick);
+}
+
+
+QUICK_SKIP_SCAN_SELECT::QUICK_SKIP_SCAN_SELECT(THD *thd, TABLE *table,
+                                               uint index_arg,
+                                               uint prefix_key_parts_arg,
+                                               bool no_alloc,
+                                               MEM_ROOT *parent_alloc,
+                                               bool *create_err)
+  :QUICK_RANGE_SELECT(thd, table, index_arg, no_alloc, parent_alloc,
+                      create_err),
+   prefix_key_parts(prefix_key_parts_arg), prefix_length(0),
+   start_key_buff(NULL), end_key_buff(NULL), have_prefix(FALSE)
+{}
+
+
+/*
+  Set up the prefix after the ranges have been added by get_quick_keys()
+
+  RETURN
+    FALSE  Ok
+    TRUE   Out of memory
+*/
+
+bool QUICK_SKIP_SCAN_SELECT::init_prefix(KEY_PART *key)
+{
+  uint buff_length;
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::init_prefix");
+  DBUG_ASSERT(ranges.elements > 0);
+
+  for (uint part= 0; part < prefix_key_parts; part++)
+    prefix_length+= key[part].store_length;
+  /* The ranges are made of the key parts after the prefix */
+  buff_length= prefix_length + max_used_key_length;
+  max_used_key_length+= prefix_length;
+
+  if (!(key_parts= (KEY_PART*)
+        memdup_root(parent_alloc ? parent_alloc : &alloc, (char*) key,
+                    sizeof(KEY_PART) *
+                    head->actual_n_key_parts(head->key_info + index))) ||
+      !(start_key_buff= (uchar*) thd->alloc(buff_length)) ||
+      !(end_key_buff= (uchar*) thd->alloc(buff_length)))
+    DBUG_RETURN(TRUE);
+  DBUG_RETURN(FALSE);
+}
+
+
+int QUICK_SKIP_SCAN_SELECT::reset()
+{
+  int error;
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::reset");
+  last_range= NULL;
+  cur_range= (QUICK_RANGE**) ranges.buffer + ranges.elements;
+  have_prefix= FALSE;
+
+  /* The prefix is copied from the record, so it must be read */
+  for (uint part= 0; part < prefix_key_parts; part++)
+    bitmap_set_bit(head->read_set, key_part_info[part].fieldnr - 1);
+
+  if (file->inited == handler::RND &&
+      unlikely((error= file->ha_rnd_end())))
+    DBUG_RETURN(error);
+  if (file->inited == handler::NONE &&
+      unlikely((error= file->ha_index_init(index, 1))))
+  {
+    file->print_error(error, MYF(0));
+    DBUG_RETURN(error);
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Get the next record of the skip scan
+
+  DESCRIPTION
+    The ranges are read one after another for the current prefix. After
+    the last range the scan jumps to the first record with a greater
+    prefix, which becomes the current prefix. The records are returned in
+    index order.
+
+  RETURN
+    0                   Found row
+    HA_ERR_END_OF_FILE  No (more) rows
+    #                   Error code
+*/
+
+int QUICK_SKIP_SCAN_SELECT::get_next()
+{
+  QUICK_RANGE **end_range= (QUICK_RANGE**) ranges.buffer + ranges.elements;
+  int result;
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::get_next");
+
+  for (;;)
+  {
+    if (last_range)
+    {
+      /* Read the next record in the range of the current prefix */
+      result= file->read_range_next();
+      if (result != HA_ERR_END_OF_FILE)
+        DBUG_RETURN(result);
+      last_range= 0;
+    }
+
+    if (cur_range == end_range)
+    {
+      /*
+        Find the next prefix. The end of the last range must not stop the
+        engine from reading past it.
+      */
+      file->end_range= NULL;
+      if (have_prefix)
+        result= file->ha_index_read_map(record, start_key_buff,
+                                        make_prev_keypart_map(prefix_key_parts),
+                                        HA_READ_AFTER_KEY);
+      else
+        result= file->ha_index_first(record);
+      if (result)
+        DBUG_RETURN(result == HA_ERR_KEY_NOT_FOUND ? HA_ERR_END_OF_FILE :
+                    result);
+      key_copy(start_key_buff, record, head->key_info + index,
+               prefix_length);
+      memcpy(end_key_buff, start_key_buff, prefix_length);
+      have_prefix= TRUE;
+      cur_range= (QUICK_RANGE**) ranges.buffer;
+    }
+    last_range= *(cur_range++);
+
+    key_range start_key, end_key;
+    last_range->make_min_endpoint(&start_key);
+    last_range->make_max_endpoint(&end_key);
+    memcpy(start_key_buff + prefix_length, start_key.key, start_key.length);
+    memcpy(end_key_buff + prefix_length, end_key.key, end_key.length);
+    start_key.key= start_key_buff;
+    start_key.length+= prefix_length;
+    end_key.key= end_key_buff;
+    end_key.length+= prefix_length;
+
+    result= file->read_range_first(&start_key, &end_key,
+                                   MY_TEST(last_range->flag & EQ_RANGE),
+                                   TRUE);
+    if (result != HA_ERR_END_OF_FILE)
+      DBUG_RETURN(result);
+    last_range= 0;                      // No matching rows; go to next range
+  }
+}
+
+
+Explain_quick_select*
+QUICK_SKIP_SCAN_SELECT::get_explain(MEM_ROOT *local_alloc)
+{
+  Explain_quick_select *res;
+  if ((res= new (local_alloc) Explain_quick_select(QS_TYPE_SKIP_SCAN)))
+    res->range.set(local_alloc, &head->key_info[index], max_used_key_length);
+  return res;
+}
+
+
 /*******************************************************************************
 * Implementation of QUICK_GROUP_MIN_MAX_SELECT
 *******************************************************************************/
@@ -994,7 +994,8 @@ class QUICK_SELECT_I
     QS_TYPE_FULLTEXT   = 4,
     QS_TYPE_ROR_INTERSECT = 5,
     QS_TYPE_ROR_UNION = 6,
-    QS_TYPE_GROUP_MIN_MAX = 7
+    QS_TYPE_GROUP_MIN_MAX = 7,
+    QS_TYPE_SKIP_SCAN = 8
   };
 
   /* Get type of this quick select - one of the QS_TYPE_* values */
@@ -1683,6 +1684,42 @@ class QUICK_SELECT_DESC: public QUICK_RANGE_SELECT
 };
 
 
+/*
+  Index skip scan: a range scan on a key part k > 0 of an index, done for
+  every distinct value of the key parts 0..k-1 that have no condition.
+
+  The ranges are those of a QUICK_RANGE_SELECT built from the SEL_ARG tree
+  of key part k, so their key tuples start at key part k. The current
+  prefix is copied in front of them when a range is read.
+*/
+
+class QUICK_SKIP_SCAN_SELECT: public QUICK_RANGE_SELECT
+{
+  uint prefix_key_parts;
+  uint prefix_length;
+  /* The current prefix followed by the endpoints of the current range */
+  uchar *start_key_buff, *end_key_buff;
+  bool have_prefix;
+public:
+  QUICK_SKIP_SCAN_SELECT(THD *thd, TABLE *table, uint index_arg,
+                         uint prefix_key_parts_arg, bool no_alloc,
+                         MEM_ROOT *parent_alloc, bool *create_err);
+  virtual QUICK_RANGE_SELECT *clone(bool *create_error)
+    {
+      DBUG_ASSERT(0);
+      return new QUICK_SKIP_SCAN_SELECT(thd, head, index, prefix_key_parts,
+                                        no_alloc, parent_alloc, create_error);
+    }
+  bool init_prefix(KEY_PART *key);
+  int reset(void);
+  int get_next();
+  bool unique_key_range() { return false; }
+  int get_type() { return QS_TYPE_SKIP_SCAN; }
+  QUICK_SELECT_I *make_reverse(uint used_key_parts_arg) { return NULL; }
+  Explain_quick_select *get_explain(MEM_ROOT *alloc);
+};
+
+
 class SQL_SELECT :public Sql_alloc {
  public:
   QUICK_SELECT_I *quick;	// If quick-select used
@@ -929,6 +929,49 @@ static bool mysql_admin_table(THD* thd, TABLE_LIST* tables,
           }
           tab->file->column_bitmaps_signal();
         }
+        if (lex->column_group_list)
+        {
+          List<LEX_STRING> *column_names;
+          List_iterator_fast<List<LEX_STRING> > it(*lex->column_group_list);
+
+          while ((column_names= it++))
+          {
+            int pos;
+            LEX_STRING *column_name;
+            List_iterator_fast<LEX_STRING> name_it(*column_names);
+            /* The length of the names separated by commas */
+            size_t names_length= column_names->elements - 1;
+
+            bitmap_clear_all(&tab->tmp_set);
+            while ((column_name= name_it++))
+            {
+              if (tab->s->fieldnames.type_names == 0 ||
+                  (pos= find_type(&tab->s->fieldnames, column_name->str,
+                                  column_name->length, 1)) <= 0 ||
+                  bitmap_fast_test_and_set(&tab->tmp_set, --pos) ||
+                  strchr(tab->field[pos]->field_name.str, ','))
+                break;
+              enum enum_field_types type= tab->field[pos]->type();
+              if (type >= MYSQL_TYPE_MEDIUM_BLOB && type <= MYSQL_TYPE_BLOB)
+              {
+                push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+                                    ER_NO_EIS_FOR_FIELD,
+                                    ER_THD(thd, ER_NO_EIS_FOR_FIELD),
+                                    column_name->str);
+                break;
+              }
+              names_length+= tab->field[pos]->field_name.length;
+            }
+            if (column_name || column_names->elements < 2 ||
+                names_length > COLUMN_GROUP_NAMES_MAX_LENGTH)
+            {
+              compl_result_code= result_code= HA_ADMIN_INVALID;
+              break;
+            }
+            bitmap_union(tab->read_set, &tab->tmp_set);
+          }
+          tab->file->column_bitmaps_signal();
+        }
         if (!lex->index_list)
           tab->keys_in_use_for_query.init(tab->s->keys);
         else
@@ -952,6 +995,9 @@ static bool mysql_admin_table(THD* thd, TABLE_LIST* tables,
         }
         if (!(compl_result_code=
               alloc_statistics_for_table(thd, table->table)) &&
+            !(compl_result_code=
+              alloc_column_group_statistics_for_table(thd, table->table,
+                                                  lex->column_group_list)) &&
             !(compl_result_code=
               collect_statistics_for_table(thd, table->table)))
           compl_result_code= update_statistics_for_table(thd, table->table);
@@ -1211,6 +1257,9 @@ static bool mysql_admin_table(THD* thd, TABLE_LIST* tables,
         break;
       }
     }
+    /* Let the cached join orders based on old statistics be replaced */
+    if (operator_func == &handler::ha_analyze)
+      statistics_version++;
     if (table->table && !table->view)
     {
       /*
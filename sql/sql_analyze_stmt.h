@@ -203,6 +203,71 @@ class Table_access_tracker
 };
 
 
+/*
+  This stores the data about how a hash join buffer spilled its inputs
+  into partition files (see JOIN_CACHE_BNLH).
+*/
+
+class Join_buffer_spill_tracker
+{
+public:
+  Join_buffer_spill_tracker() :
+    r_spills(0), r_partitions(0), r_outer_rows(0), r_inner_rows(0),
+    r_builds(0)
+  {}
+
+  ha_rows r_spills; /* How many times the join buffer was spilled */
+  uint r_partitions; /* Number of partitions used by the spills */
+  ha_rows r_outer_rows; /* Partial join records written into partitions */
+  ha_rows r_inner_rows; /* Rows of the joined table written into partitions */
+  ha_rows r_builds; /* Hash tables built from the partitions */
+
+  bool has_spills() const { return (r_spills != 0); }
+};
+
+
+/*
+  This stores the data about how many rows of the joined table were
+  rejected by the Bloom filter of a hash join buffer (see JOIN_CACHE_HASHED).
+*/
+
+class Join_buffer_bloom_filter_tracker
+{
+public:
+  Join_buffer_bloom_filter_tracker() :
+    r_checked_rows(0), r_rejected_rows(0)
+  {}
+
+  ha_rows r_checked_rows; /* Rows of the joined table checked by the filter */
+  ha_rows r_rejected_rows; /* Rows rejected by the filter */
+
+  bool has_checks() const { return (r_checked_rows != 0); }
+};
+
+
+/*
+  This stores the data about how GROUP BY was computed in the hash table
+  of Hash_aggregation and how many of the groups were spilled into the
+  temporary table.
+*/
+
+class Hash_aggregation_tracker
+{
+public:
+  Hash_aggregation_tracker() :
+    r_loops(0), r_rows(0), r_groups(0), r_spilled_partitions(0),
+    r_spilled_groups(0), r_spilled_rows(0)
+  {}
+
+  ha_rows r_loops; /* How many times the aggregation was done */
+  ha_rows r_rows; /* Rows aggregated in the hash table */
+  ha_rows r_groups; /* Groups created in the hash table */
+  ha_rows r_spilled_partitions; /* Partitions moved to the temporary table */
+  ha_rows r_spilled_groups; /* Groups moved to the temporary table */
+  ha_rows r_spilled_rows; /* Rows aggregated in the temporary table */
+};
+
+
 class Json_writer;
 
 /*
@@ -641,6 +641,8 @@ typedef struct system_variables
   ulonglong bulk_insert_buff_size;
   ulonglong join_buff_size;
   ulonglong sortbuff_size;
+  ulonglong hash_aggr_buff_size;
+  ulonglong subquery_cache_hash_size;
   ulonglong default_regex_flags;
   ulonglong max_mem_used;
 
@@ -670,11 +672,13 @@ typedef struct system_variables
   ulong column_compression_zlib_strategy;
   ulong lock_wait_timeout;
   ulong join_cache_level;
+  ulong join_cache_spill_partitions;
   ulong max_allowed_packet;
   ulong max_error_count;
   ulong max_length_for_sort_data;
   ulong max_recursive_iterations;
   ulong max_sort_length;
+  ulong sort_threads;
   ulong max_tmp_tables;
   ulong max_insert_delayed_threads;
   ulong min_examined_row_limit;
@@ -690,6 +694,7 @@ typedef struct system_variables
   ulong optimizer_use_condition_selectivity;
   ulong use_stat_tables;
   double sample_percentage;
+  ulong analyze_hll_precision;
   ulong histogram_size;
   ulong histogram_type;
   ulong preload_buff_size;
@@ -816,6 +821,11 @@ typedef struct system_variables
   uint column_compression_zlib_level;
   uint in_subquery_conversion_threshold;
   ulong optimizer_max_sel_arg_weight;
+  my_bool optimizer_plan_cache;
+  my_bool optimizer_join_partition_pruning;
+  my_bool optimizer_skip_scan;
+  my_bool join_cache_bloom_filter;
+  ulong optimizer_join_dp_limit;
   ulonglong max_rowid_filter_size;
 
   vers_asof_timestamp_t vers_asof_timestamp;
@@ -903,6 +913,8 @@ typedef struct system_status_var
   ulong filesort_rows_;
   ulong filesort_scan_count_;
   ulong filesort_pq_sorts_;
+  ulong optimizer_plan_cache_hits;
+  ulong optimizer_plan_cache_misses;
 
   /* Features used */
   ulong feature_custom_aggregate_functions; /* +1 when custom aggregate
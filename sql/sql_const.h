@@ -98,6 +98,9 @@
 
 #define MAX_SORT_MEMORY 2048*1024
 #define MIN_SORT_MEMORY 1024
+#define MAX_SORT_THREADS 64
+/* The sort buffer is split between threads only in slices of this size */
+#define MIN_KEYS_PER_SORT_THREAD 8192
 
 /* Some portable defines */
 
@@ -737,6 +737,8 @@ bool Explain_node::print_explain_json_cache(Json_writer *writer,
       writer->add_member("state").
         add_str(Expression_cache_tracker::state_str[cache_tracker->state]);
     }
+    if (cache_tracker->hash_size)
+      writer->add_member("hash_size").add_ull(cache_tracker->hash_size);
 
     if (is_analyze)
     {
@@ -747,6 +749,12 @@ bool Explain_node::print_explain_json_cache(Json_writer *writer,
         double hit_ratio= double(cache_tracker->hit) / cache_reads * 100.0;
         writer->add_member("r_hit_ratio").add_double(hit_ratio);
       }
+      if (cache_tracker->hash_size)
+      {
+        writer->add_member("r_hits").add_ull(cache_tracker->hit);
+        writer->add_member("r_misses").add_ull(cache_tracker->miss);
+        writer->add_member("r_evictions").add_ull(cache_tracker->evictions);
+      }
     }
     return true;
   }
@@ -990,6 +998,13 @@ void Explain_select::print_explain_json(Explain_query *query,
           ((Explain_aggr_window_funcs*)node)->print_json_members(writer, is_analyze);
           break;
         }
+        case AGGR_OP_HASH_AGGREGATION:
+        {
+          writer->add_member("hash_aggregation").start_object();
+          ((Explain_aggr_hash_aggregation*)node)->print_json_members(writer,
+                                                                   is_analyze);
+          break;
+        }
         default:
           DBUG_ASSERT(0);
       }
@@ -1073,6 +1088,24 @@ void Explain_aggr_window_funcs::print_json_members(Json_writer *writer,
 }
 
 
+void Explain_aggr_hash_aggregation::print_json_members(Json_writer *writer,
+                                                       bool is_analyze)
+{
+  writer->add_member("buffer_size").add_size(buffer_size);
+  writer->add_member("partitions").add_ll(partitions);
+  if (is_analyze)
+  {
+    writer->add_member("r_loops").add_ll(tracker.r_loops);
+    writer->add_member("r_rows").add_ll(tracker.r_rows);
+    writer->add_member("r_groups").add_ll(tracker.r_groups);
+    writer->add_member("r_spilled_partitions").
+      add_ll(tracker.r_spilled_partitions);
+    writer->add_member("r_spilled_groups").add_ll(tracker.r_spilled_groups);
+    writer->add_member("r_spilled_rows").add_ll(tracker.r_spilled_rows);
+  }
+}
+
+
 void Explain_basic_join::print_explain_json(Explain_query *query, 
                                             Json_writer *writer, 
                                             bool is_analyze)
@@ -1602,6 +1635,9 @@ void Explain_table_access::tag_to_json(Json_writer *writer, enum explain_extra_t
       else
         writer->add_bool(true);
       break;
+    case ET_USING_INDEX_FOR_SKIP_SCAN:
+      writer->add_member("using_index_for_skip_scan").add_bool(true);
+      break;
 
     /*new:*/
     case ET_CONST_ROW_NOT_FOUND:
@@ -1730,6 +1766,9 @@ void Explain_table_access::print_explain_json(Explain_query *query,
   if (used_partitions_set)
     print_json_array(writer, "partitions", used_partitions_list);
 
+  if (concurrent_insert)
+    writer->add_member("concurrent_insert").add_bool(true);
+
   writer->add_member("access_type").add_str(join_type_str[type]);
 
   add_json_keyset(writer, "possible_keys", &possible_keys);
@@ -1876,6 +1915,29 @@ void Explain_table_access::print_explain_json(Explain_query *query,
         writer->add_double(jbuf_tracker.get_filtered_after_where()*100.0);
       else
         writer->add_null();
+      if (jbuf_spill_tracker.has_spills())
+      {
+        writer->add_member("r_spill").start_object();
+        writer->add_member("r_loops").add_ll(jbuf_spill_tracker.r_spills);
+        writer->add_member("partitions").
+          add_ll(jbuf_spill_tracker.r_partitions);
+        writer->add_member("r_outer_rows").
+          add_ll(jbuf_spill_tracker.r_outer_rows);
+        writer->add_member("r_inner_rows").
+          add_ll(jbuf_spill_tracker.r_inner_rows);
+        writer->add_member("r_hash_builds").
+          add_ll(jbuf_spill_tracker.r_builds);
+        writer->end_object(); // "r_spill"
+      }
+      if (jbuf_bloom_filter_tracker.has_checks())
+      {
+        writer->add_member("r_bloom_filter").start_object();
+        writer->add_member("r_checked_rows").
+          add_ll(jbuf_bloom_filter_tracker.r_checked_rows);
+        writer->add_member("r_rejected_rows").
+          add_ll(jbuf_bloom_filter_tracker.r_rejected_rows);
+        writer->end_object(); // "r_bloom_filter"
+      }
     }
   }
 
@@ -1948,6 +2010,7 @@ const char * extra_tag_text[]=
   "Scanned all databases",
 
   "Using index for group-by", // special handling
+  "Using index for skip scan",
 
   "USING MRR: DONT PRINT ME", // special handling
 
@@ -2045,7 +2108,8 @@ void Explain_quick_select::print_extra(String *str)
 {
   if (quick_type == QUICK_SELECT_I::QS_TYPE_RANGE || 
       quick_type == QUICK_SELECT_I::QS_TYPE_RANGE_DESC ||
-      quick_type == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX)
+      quick_type == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX ||
+      quick_type == QUICK_SELECT_I::QS_TYPE_SKIP_SCAN)
   {
     /* print nothing */
   }
@@ -2131,7 +2195,8 @@ void Explain_quick_select::print_key(String *str)
 {
   if (quick_type == QUICK_SELECT_I::QS_TYPE_RANGE || 
       quick_type == QUICK_SELECT_I::QS_TYPE_RANGE_DESC || 
-      quick_type == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX)
+      quick_type == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX ||
+      quick_type == QUICK_SELECT_I::QS_TYPE_SKIP_SCAN)
   {
     if (str->length() > 0)
       str->append(',');
@@ -2157,7 +2222,8 @@ void Explain_quick_select::print_key_len(String *str)
 {
   if (quick_type == QUICK_SELECT_I::QS_TYPE_RANGE || 
       quick_type == QUICK_SELECT_I::QS_TYPE_RANGE_DESC ||
-      quick_type == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX)
+      quick_type == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX ||
+      quick_type == QUICK_SELECT_I::QS_TYPE_SKIP_SCAN)
   {
     char buf[64];
     size_t length;
@@ -279,7 +279,8 @@ typedef enum
   AGGR_OP_FILESORT,
   //AGGR_OP_READ_SORTED_FILE, // need this?
   AGGR_OP_REMOVE_DUPLICATES,
-  AGGR_OP_WINDOW_FUNCS
+  AGGR_OP_WINDOW_FUNCS,
+  AGGR_OP_HASH_AGGREGATION
   //AGGR_OP_JOIN // Need this?
 } enum_explain_aggr_node_type;
 
@@ -328,6 +329,17 @@ class Explain_aggr_window_funcs : public Explain_aggr_node
   friend class Window_funcs_computation;
 };
 
+class Explain_aggr_hash_aggregation : public Explain_aggr_node
+{
+public:
+  enum_explain_aggr_node_type get_type() { return AGGR_OP_HASH_AGGREGATION; }
+  ulonglong buffer_size;
+  uint partitions;
+  Hash_aggregation_tracker tracker;
+
+  void print_json_members(Json_writer *writer, bool is_analyze);
+};
+
 /////////////////////////////////////////////////////////////////////////////
 
 extern const char *unit_operation_text[4];
@@ -536,6 +548,7 @@ enum explain_extra_tag
   ET_SCANNED_ALL_DATABASES,
 
   ET_USING_INDEX_FOR_GROUP_BY,
+  ET_USING_INDEX_FOR_SKIP_SCAN,
 
   ET_USING_MRR, // does not print "Using mrr". 
 
@@ -660,7 +673,8 @@ class Explain_quick_select : public Sql_alloc
   {
     return (quick_type == QUICK_SELECT_I::QS_TYPE_RANGE || 
             quick_type == QUICK_SELECT_I::QS_TYPE_RANGE_DESC ||
-            quick_type == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX);
+            quick_type == QUICK_SELECT_I::QS_TYPE_GROUP_MIN_MAX ||
+            quick_type == QUICK_SELECT_I::QS_TYPE_SKIP_SCAN);
   }
   
   /* This is used when quick_type == QUICK_SELECT_I::QS_TYPE_RANGE */
@@ -725,6 +739,7 @@ class Explain_table_access : public Sql_alloc
     extra_tags(root),
     range_checked_fer(NULL),
     full_scan_on_null_key(false),
+    concurrent_insert(false),
     start_dups_weedout(false),
     end_dups_weedout(false),
     where_cond(NULL),
@@ -803,6 +818,9 @@ class Explain_table_access : public Sql_alloc
  
   bool full_scan_on_null_key;
 
+  /* The table lets INSERTs run while it is being read */
+  bool concurrent_insert;
+
   // valid with ET_USING_JOIN_BUFFER
   EXPLAIN_BKA_TYPE bka_type;
 
@@ -840,6 +858,8 @@ class Explain_table_access : public Sql_alloc
   Gap_time_tracker extra_time_tracker;
 
   Table_access_tracker jbuf_tracker;
+  Join_buffer_spill_tracker jbuf_spill_tracker;
+  Join_buffer_bloom_filter_tracker jbuf_bloom_filter_tracker;
   
   Explain_rowid_filter *rowid_filter;
 
@@ -16,6 +16,7 @@
 #include "mariadb.h"
 #include "sql_base.h"
 #include "sql_select.h"
+#include "key.h"
 #include "sql_expression_cache.h"
 
 /**
@@ -82,32 +83,25 @@ static uint field_enumerator(uchar *arg)
 
 
 /**
-  Initialize temporary table and auxiliary structures for the expression
-  cache
+  Create the temporary table of the expression cache and its search index
 
   @details
-  The function creates a temporary table for the expression cache, defines
-  the search index and initializes auxiliary search structures used to check
-  whether a given set of of values of the expression parameters is in some
-  cache entry.
+  The table is described but not created in the storage engine. The first
+  field of the table is the result of the expression, the other fields are
+  the parameters that make up the search index.
+
+  @retval FALSE OK
+  @retval TRUE  The cache can not be used. cache_table is set if it has to
+                be freed.
 */
 
-void Expression_cache_tmptable::init()
+bool Expression_cache_tmptable::create_cache_table()
 {
   List_iterator<Item> li(items);
   Item_iterator_list it(li);
   uint field_counter;
   LEX_CSTRING cache_table_name= { STRING_WITH_LEN("subquery-cache-table") };
-  DBUG_ENTER("Expression_cache_tmptable::init");
-  DBUG_ASSERT(!inited);
-  inited= TRUE;
-  cache_table= NULL;
-
-  if (items.elements == 0)
-  {
-    DBUG_PRINT("info", ("All parameters were removed by optimizer."));
-    DBUG_VOID_RETURN;
-  }
+  DBUG_ENTER("Expression_cache_tmptable::create_cache_table");
 
   /* add result field */
   items.push_front(val);
@@ -129,13 +123,17 @@ void Expression_cache_tmptable::init()
                                       TRUE)))
   {
     DBUG_PRINT("error", ("create_tmp_table failed, caching switched off"));
-    DBUG_VOID_RETURN;
+    DBUG_RETURN(TRUE);
   }
 
-  if (cache_table->s->db_type() != heap_hton)
+  /* HEAP can't index blobs, only the result field may be a blob */
+  for (uint i= 1; i < cache_table->s->fields; i++)
   {
-    DBUG_PRINT("error", ("we need only heap table"));
-    goto error;
+    if (cache_table->field[i]->flags & BLOB_FLAG)
+    {
+      DBUG_PRINT("error", ("blob parameter"));
+      DBUG_RETURN(TRUE);
+    }
   }
 
   field_counter= 1;
@@ -147,15 +145,50 @@ void Expression_cache_tmptable::init()
                                       TRUE, 1 /* skip result field*/))
   {
     DBUG_PRINT("error", ("creating index failed"));
-    goto error;
+    DBUG_RETURN(TRUE);
   }
   cache_table->s->keys= 1;
   ref.null_rejecting= 1;
   ref.disable_cache= FALSE;
   ref.has_record= 0;
   ref.use_count= 0;
+  DBUG_RETURN(FALSE);
+}
 
 
+/**
+  Initialize temporary table and auxiliary structures for the expression
+  cache
+
+  @details
+  The function creates a temporary table for the expression cache, defines
+  the search index and initializes auxiliary search structures used to check
+  whether a given set of of values of the expression parameters is in some
+  cache entry.
+*/
+
+void Expression_cache_tmptable::init()
+{
+  DBUG_ENTER("Expression_cache_tmptable::init");
+  DBUG_ASSERT(!inited);
+  inited= TRUE;
+  cache_table= NULL;
+
+  if (items.elements == 0)
+  {
+    DBUG_PRINT("info", ("All parameters were removed by optimizer."));
+    DBUG_VOID_RETURN;
+  }
+
+  if (create_cache_table())
+    goto error;
+
+  if (cache_table->s->db_type() != heap_hton)
+  {
+    DBUG_PRINT("error", ("we need only heap table"));
+    goto error;
+  }
+
   if (open_tmp_table(cache_table))
   {
     DBUG_PRINT("error", ("Opening (creating) temporary table failed"));
@@ -173,7 +206,8 @@ void Expression_cache_tmptable::init()
   DBUG_VOID_RETURN;
 
 error:
-  disable_cache();
+  if (cache_table)
+    disable_cache();
   DBUG_VOID_RETURN;
 }
 
@@ -318,6 +352,344 @@ my_bool Expression_cache_tmptable::put_value(Item *value)
 }
 
 
+Expression_cache_hash::Expression_cache_hash(THD *thd,
+                                             List<Item> &dependants,
+                                             Item *value, size_t size)
+  :Expression_cache_tmptable(thd, dependants, value),
+   max_size(size), entries(NULL), buckets(NULL),
+   entry_length(0), key_length(0), rec_length(0),
+   records(0), allocated(0), max_records(0), bucket_mask(0),
+   lru_first(NO_ENTRY), lru_last(NO_ENTRY), evictions(0),
+   cache_cycles(0), eval_cycles(0), eval_start(0), evals(0),
+   miss_hash(0), miss_pending(false)
+{
+  DBUG_ENTER("Expression_cache_hash::Expression_cache_hash");
+  DBUG_VOID_RETURN;
+}
+
+
+Expression_cache_hash::~Expression_cache_hash()
+{
+  if (cache_table)
+    disable_cache();
+}
+
+
+/**
+  Free the hash table and switch the cache off
+*/
+
+void Expression_cache_hash::disable_cache()
+{
+  my_free(entries);
+  my_free(buckets);
+  entries= NULL;
+  buckets= NULL;
+  records= allocated= 0;
+  Expression_cache_tmptable::disable_cache();
+}
+
+
+/**
+  Initialize the expression cache
+
+  @details
+  The temporary table is only used to describe the record and the search
+  key, it is not opened. The hash table is allocated on the first miss.
+*/
+
+void Expression_cache_hash::init()
+{
+  DBUG_ENTER("Expression_cache_hash::init");
+  DBUG_ASSERT(!inited);
+  inited= TRUE;
+  cache_table= NULL;
+
+  if (items.elements == 0)
+  {
+    DBUG_PRINT("info", ("All parameters were removed by optimizer."));
+    DBUG_VOID_RETURN;
+  }
+
+  if (create_cache_table())
+    goto error;
+
+  /* Records are copied into the entries, blobs would point outside them */
+  if (cache_table->s->blob_fields)
+  {
+    DBUG_PRINT("error", ("blob result"));
+    goto error;
+  }
+
+  key_length= ref.key_length;
+  rec_length= cache_table->s->reclength;
+  entry_length= ALIGN_SIZE(sizeof(Hash_entry) + key_length + rec_length);
+  /* There are at most two buckets per entry */
+  max_records= (uint32) MY_MIN(max_size / (entry_length + 2 * sizeof(uint32)),
+                               NO_ENTRY - 1);
+  if (!max_records)
+  {
+    DBUG_PRINT("error", ("no room for an entry"));
+    goto error;
+  }
+
+  if (!(cached_result= new (table_thd->mem_root)
+        Item_field(table_thd, cache_table->field[0])))
+    goto error;
+
+  update_tracker();
+  DBUG_VOID_RETURN;
+
+error:
+  if (cache_table)
+    disable_cache();
+  DBUG_VOID_RETURN;
+}
+
+
+/* Find the entry with the key in ref.key_buff */
+
+uint32 Expression_cache_hash::find_entry(uint32 hash)
+{
+  uint32 idx;
+  if (!records)
+    return NO_ENTRY;
+  for (idx= buckets[hash & bucket_mask]; idx != NO_ENTRY;
+       idx= get_entry(idx)->next)
+  {
+    Hash_entry *entry= get_entry(idx);
+    if (entry->hash == hash &&
+        !key_buf_cmp(cache_table->key_info, ref.key_parts,
+                     entry_key(entry), ref.key_buff))
+      return idx;
+  }
+  return NO_ENTRY;
+}
+
+
+/**
+  Double the number of entries and rehash the buckets if needed
+
+  @retval FALSE OK
+  @retval TRUE  Out of memory
+*/
+
+bool Expression_cache_hash::grow()
+{
+  uint32 new_allocated= MY_MIN(MY_MAX(allocated * 2, 16), max_records);
+  uint32 new_buckets= my_round_up_to_next_power(new_allocated);
+  uchar *new_entries;
+  uint32 *new_bucket_array;
+
+  if (!(new_entries= (uchar*) my_realloc(PSI_INSTRUMENT_ME, entries,
+                                         (size_t) new_allocated *
+                                         entry_length,
+                                         MYF(MY_THREAD_SPECIFIC |
+                                             MY_ALLOW_ZERO_PTR))))
+    return TRUE;
+  entries= new_entries;
+  allocated= new_allocated;
+
+  if (buckets && new_buckets <= bucket_mask + 1)
+    return FALSE;
+  if (!(new_bucket_array= (uint32*) my_malloc(PSI_INSTRUMENT_ME,
+                                              new_buckets * sizeof(uint32),
+                                              MYF(MY_THREAD_SPECIFIC))))
+    return buckets == NULL;           // Go on with longer chains
+  memset(new_bucket_array, 0xff, new_buckets * sizeof(uint32));
+  for (uint32 idx= 0; idx < records; idx++)
+  {
+    Hash_entry *entry= get_entry(idx);
+    uint32 *bucket= new_bucket_array + (entry->hash & (new_buckets - 1));
+    entry->next= *bucket;
+    *bucket= idx;
+  }
+  my_free(buckets);
+  buckets= new_bucket_array;
+  bucket_mask= new_buckets - 1;
+  return FALSE;
+}
+
+
+void Expression_cache_hash::lru_unlink(uint32 idx)
+{
+  Hash_entry *entry= get_entry(idx);
+  if (entry->lru_prev == NO_ENTRY)
+    lru_first= entry->lru_next;
+  else
+    get_entry(entry->lru_prev)->lru_next= entry->lru_next;
+  if (entry->lru_next == NO_ENTRY)
+    lru_last= entry->lru_prev;
+  else
+    get_entry(entry->lru_next)->lru_prev= entry->lru_prev;
+}
+
+
+void Expression_cache_hash::lru_push(uint32 idx)
+{
+  Hash_entry *entry= get_entry(idx);
+  entry->lru_prev= NO_ENTRY;
+  entry->lru_next= lru_first;
+  if (lru_first == NO_ENTRY)
+    lru_last= idx;
+  else
+    get_entry(lru_first)->lru_prev= idx;
+  lru_first= idx;
+}
+
+
+/**
+  Get an entry for a new key
+
+  @details
+  When the memory bound is reached the least recently used entry is taken
+  out of its bucket and returned.
+
+  @return the index of the entry or NO_ENTRY if out of memory
+*/
+
+uint32 Expression_cache_hash::new_entry()
+{
+  uint32 idx, *prev;
+  Hash_entry *entry;
+
+  if (records < allocated || (allocated < max_records && !grow()))
+    return records++;
+  if (!records)
+    return NO_ENTRY;
+
+  idx= lru_last;
+  lru_unlink(idx);
+  entry= get_entry(idx);
+  for (prev= buckets + (entry->hash & bucket_mask); *prev != idx;
+       prev= &get_entry(*prev)->next)
+    ;
+  *prev= entry->next;
+  evictions++;
+  return idx;
+}
+
+
+/**
+  Check if the hits saved more time on evaluating the expression than was
+  spent in the cache
+*/
+
+bool Expression_cache_hash::is_worth_keeping()
+{
+  double eval_cost= (double) eval_cycles / evals;
+  return hit * eval_cost >= (double) cache_cycles;
+}
+
+
+/**
+  Check if a given set of parameters of the expression is in the cache
+
+  @param [out] value     the expression value found in the cache if any
+
+  @retval Expression_cache::HIT if the set of parameters is in the cache
+  @retval Expression_cache::MISS - otherwise
+*/
+
+Expression_cache::result Expression_cache_hash::check_value(Item **value)
+{
+  ulonglong start;
+  uint32 idx;
+  Hash_entry *entry;
+  DBUG_ENTER("Expression_cache_hash::check_value");
+
+  miss_pending= false;
+  if (!cache_table)
+    DBUG_RETURN(Expression_cache::MISS);
+
+  start= my_timer_cycles();
+  if (cp_buffer_from_ref(table_thd, cache_table, &ref))
+  {
+    /* The parameters do not fit into the key, do not cache the result */
+    miss++;
+    DBUG_RETURN(Expression_cache::MISS);
+  }
+  miss_hash= (uint32) key_hashnr(cache_table->key_info, ref.key_parts,
+                                 ref.key_buff);
+  if ((idx= find_entry(miss_hash)) == NO_ENTRY)
+  {
+    miss++;
+    miss_pending= true;
+    eval_start= my_timer_cycles();
+    cache_cycles+= eval_start - start;
+    DBUG_RETURN(Expression_cache::MISS);
+  }
+
+  entry= get_entry(idx);
+  memcpy(cache_table->record[0], entry_record(entry), rec_length);
+  if (idx != lru_first)
+  {
+    lru_unlink(idx);
+    lru_push(idx);
+  }
+  hit++;
+  cache_cycles+= my_timer_cycles() - start;
+  *value= cached_result;
+  DBUG_RETURN(Expression_cache::HIT);
+}
+
+
+/**
+  Put a new entry into the expression cache
+
+  @param value     the result of the expression to be put into the cache
+
+  @retval FALSE OK
+  @retval TRUE  Error
+*/
+
+my_bool Expression_cache_hash::put_value(Item *value)
+{
+  ulonglong start;
+  uint32 idx;
+  Hash_entry *entry;
+  DBUG_ENTER("Expression_cache_hash::put_value");
+  DBUG_ASSERT(inited);
+
+  if (!cache_table || !miss_pending)
+    DBUG_RETURN(FALSE);
+  miss_pending= false;
+  start= my_timer_cycles();
+  eval_cycles+= start - eval_start;
+  evals++;
+
+  *(items.head_ref())= value;
+  fill_record(table_thd, cache_table, cache_table->field, items, TRUE, TRUE);
+  if (unlikely(table_thd->is_error()))
+  {
+    disable_cache();
+    DBUG_RETURN(TRUE);
+  }
+
+  if ((idx= new_entry()) == NO_ENTRY)
+  {
+    DBUG_PRINT("info", ("out of memory, caching switched off"));
+    disable_cache();
+    DBUG_RETURN(FALSE);
+  }
+  entry= get_entry(idx);
+  entry->hash= miss_hash;
+  memcpy(entry_key(entry), ref.key_buff, key_length);
+  memcpy(entry_record(entry), cache_table->record[0], rec_length);
+  entry->next= buckets[miss_hash & bucket_mask];
+  buckets[miss_hash & bucket_mask]= idx;
+  lru_push(idx);
+  cache_cycles+= my_timer_cycles() - start;
+
+  if (!(miss % EXPCACHE_CHECK_HIT_RATIO_AFTER) && !is_worth_keeping())
+  {
+    DBUG_PRINT("info", ("the cache costs more than it saves"));
+    disable_cache();
+  }
+  DBUG_RETURN(FALSE);
+}
+
+
 void Expression_cache_tmptable::print(String *str, enum_query_type query_type)
 {
   List_iterator<Item> li(items);
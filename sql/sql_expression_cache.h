@@ -31,6 +31,8 @@
 
 extern ulong subquery_cache_miss, subquery_cache_hit;
 
+class Expression_cache_tracker;
+
 class Expression_cache :public Sql_alloc
 {
 public:
@@ -68,6 +70,11 @@ class Expression_cache :public Sql_alloc
     Save this object's statistics into Expression_cache_tracker object
   */
   virtual void update_tracker()= 0;
+
+  /**
+    Set the object to save the statistics in
+  */
+  virtual void set_tracker(Expression_cache_tracker *st)= 0;
 };
 
 struct st_table_ref;
@@ -80,12 +87,15 @@ class Expression_cache_tracker :public Sql_alloc
 public:
   enum expr_cache_state {UNINITED, STOPPED, OK};
   Expression_cache_tracker(Expression_cache *c) :
-    cache(c), hit(0), miss(0), state(UNINITED)
+    cache(c), hit(0), miss(0), state(UNINITED), hash_size(0), evictions(0)
   {}
 
   Expression_cache *cache;
   ulong hit, miss;
   enum expr_cache_state state;
+  /* Memory bound of Expression_cache_hash, 0 for other caches */
+  size_t hash_size;
+  ulong evictions;
 
   static const char* state_str[3];
   void set(ulong h, ulong m, enum expr_cache_state s)
@@ -115,7 +125,7 @@ class Expression_cache_tmptable :public Expression_cache
   bool is_inited() { return inited; };
   void init();
 
-  void set_tracker(Expression_cache_tracker *st)
+  virtual void set_tracker(Expression_cache_tracker *st)
   {
     tracker= st;
     update_tracker();
@@ -131,8 +141,9 @@ class Expression_cache_tmptable :public Expression_cache
     }
   }
 
-private:
-  void disable_cache();
+protected:
+  virtual void disable_cache();
+  bool create_cache_table();
 
   /* tmp table parameters */
   TMP_TABLE_PARAM cache_table_param;
@@ -156,4 +167,74 @@ class Expression_cache_tmptable :public Expression_cache
   bool inited;
 };
 
+
+/**
+  Implementation of expression cache over a hash table in memory
+
+  @details
+  The temporary table of Expression_cache_tmptable only describes the record
+  and the key here, it is not created in the storage engine. Every entry of
+  the hash table keeps the key made of the parameters and the record. When
+  the memory bound is reached the least recently used entry is replaced.
+  The cache is switched off when the time spent in it is more than the time
+  that the hits saved on evaluating the expression.
+*/
+
+class Expression_cache_hash :public Expression_cache_tmptable
+{
+public:
+  Expression_cache_hash(THD *thd, List<Item> &dependants, Item *value,
+                        size_t size);
+  virtual ~Expression_cache_hash();
+  virtual result check_value(Item **value);
+  virtual my_bool put_value(Item *value);
+  void init();
+  virtual void update_tracker()
+  {
+    Expression_cache_tmptable::update_tracker();
+    if (tracker)
+    {
+      tracker->hash_size= max_size;
+      tracker->evictions= evictions;
+    }
+  }
+
+private:
+  struct Hash_entry
+  {
+    uint32 hash;
+    uint32 next;                              // Next entry of the bucket
+    uint32 lru_prev, lru_next;                // Most recently used first
+  };
+  static const uint32 NO_ENTRY= UINT_MAX32;
+
+  virtual void disable_cache();
+  Hash_entry *get_entry(uint32 idx)
+  { return (Hash_entry*) (entries + (size_t) idx * entry_length); }
+  uchar *entry_key(Hash_entry *entry) { return (uchar*) (entry + 1); }
+  uchar *entry_record(Hash_entry *entry)
+  { return entry_key(entry) + key_length; }
+  uint32 find_entry(uint32 hash);
+  uint32 new_entry();
+  bool grow();
+  void lru_unlink(uint32 idx);
+  void lru_push(uint32 idx);
+  bool is_worth_keeping();
+
+  /* Memory bound of the entries and the buckets */
+  size_t max_size;
+  uchar *entries;
+  uint32 *buckets;
+  uint entry_length, key_length, rec_length;
+  uint32 records, allocated, max_records, bucket_mask;
+  uint32 lru_first, lru_last;
+  ulong evictions;
+  /* Time spent in the cache and in evaluating the expression on misses */
+  ulonglong cache_cycles, eval_cycles, eval_start;
+  ulong evals;
+  /* Set by a miss in check_value() for put_value() */
+  uint32 miss_hash;
+  bool miss_pending;
+};
+
 #endif /* SQL_EXPRESSION_CACHE_INCLUDED */
@@ -35,6 +35,21 @@
 
 #define NO_MORE_RECORDS_IN_BUFFER  (uint)(-1)
 
+/* Size of the buffer of a spill file of a BNLH join cache partition */
+#define JOIN_CACHE_SPILL_BUFFER_SIZE  (uint) (IO_SIZE*4)
+
+/* Bits of the Bloom filter of a BNLH join cache per expected key */
+#define JOIN_CACHE_BLOOM_BITS_PER_KEY  8
+/* Maximal size of the Bloom filter of a BNLH join cache in bits */
+#define JOIN_CACHE_BLOOM_MAX_BITS      (1U << 24)
+/*
+  The Bloom filter is not checked for the rest of a scan of join_tab when
+  it has rejected less than 1/JOIN_CACHE_BLOOM_MIN_REJECTED of the first
+  JOIN_CACHE_BLOOM_SAMPLE rows
+*/
+#define JOIN_CACHE_BLOOM_SAMPLE        1024
+#define JOIN_CACHE_BLOOM_MIN_REJECTED  16
+
 static void save_or_restore_used_tabs(JOIN_TAB *join_tab, bool save);
 
 /*****************************************************************************
@@ -2039,6 +2054,54 @@ void JOIN_CACHE::restore_last_record()
 }
 
 
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+/*
+  Collect the partitions of join_tab the records in the buffer can match
+
+  SYNOPSIS
+    collect_partitions_to_scan()
+
+  DESCRIPTION
+    The function reads all records from the join buffer into the record
+    buffers and adds the partition of join_tab the values of each record
+    fall into to the partitions to be scanned by the next scan of join_tab.
+    It stops as soon as all partitions are to be scanned.
+    Afterwards the last record is restored in the record buffers and the
+    position in the buffer is the same as before the call.
+
+  NOTES
+    Nothing is collected if the blob data of the last record may be kept
+    in the record buffers only. All partitions are scanned then.
+*/
+
+void JOIN_CACHE::collect_partitions_to_scan()
+{
+  Partition_join_pruning *pruning= join_tab->partition_pruning;
+  uchar *save_pos= pos;
+  uchar *save_curr_rec_pos= curr_rec_pos;
+  uchar *save_curr_rec_link= curr_rec_link;
+
+  for (JOIN_CACHE *cache= this; cache; cache= cache->prev_cache)
+  {
+    if (cache->blobs)
+      return;
+  }
+
+  pruning->start_collecting();
+  reset(FALSE);
+  for (ulong i= 0; i < records; i++)
+  {
+    if (get_record() || pruning->add_current_values())
+      break;
+  }
+  JOIN_CACHE::restore_last_record();
+  pos= save_pos;
+  curr_rec_pos= save_curr_rec_pos;
+  curr_rec_link= save_curr_rec_link;
+}
+#endif
+
+
 /*
   Join records from the join buffer with records from the next join table    
 
@@ -2881,6 +2944,8 @@ void JOIN_CACHE_HASHED::reset(bool for_writing)
   this->JOIN_CACHE::reset(for_writing);
   if (for_writing && hash_table)
     cleanup_hash_table();
+  if (for_writing && bloom_filter)
+    bzero(bloom_filter, (bloom_filter_mask >> 3) + 1);
   curr_key_entry= hash_table;
 }
 
@@ -2988,6 +3053,8 @@ bool JOIN_CACHE_HASHED::put_record()
     DBUG_ASSERT(last_key_entry >= end_pos);
     /* Increment the counter of key_entries in the hash table */ 
     key_entries++;
+    if (bloom_filter)
+      add_key_to_bloom_filter(key);
   }  
   return is_full;
 }
@@ -3142,6 +3209,25 @@ bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
 
 inline
 uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
+{
+  return get_hash_value_simple(key, key_len) % hash_entries;
+}
+
+
+/* 
+  Calculate the hash value for a key as a sequence of bytes
+
+  SYNOPSIS
+    get_hash_value_simple()
+      key             pointer to the key value
+      key_len         key value length
+
+  RETURN VALUE
+    the hash value for the key used by get_hash_idx_simple
+*/
+
+inline
+ulong JOIN_CACHE_HASHED::get_hash_value_simple(uchar* key, uint key_len)
 {
   ulong nr= 1;
   ulong nr2= 4;
@@ -3152,7 +3238,7 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     nr^= (ulong) ((((uint) nr & 63)+nr2)*((uint) *pos))+ (nr << 8);
     nr2+= 3;
   }
-  return nr % hash_entries;
+  return nr;
 }
 
 
@@ -3187,6 +3273,199 @@ uint JOIN_CACHE_HASHED::get_hash_idx_complex(uchar *key, uint key_len)
 }
 
 
+/* 
+  Get the number of the spill partition for a key
+
+  SYNOPSIS
+    get_hash_partition()
+      key             pointer to the key value
+      key_len         key value length
+      n_partitions    number of the partitions
+
+  DESCRIPTION
+    The function calculates the hash value of the key in the same way as
+    the hash function of the hash table does, so that equal keys always fall
+    into the same partition. The number of the partition is taken from other
+    bits of the hash value than the index of the hash entry is, otherwise
+    all keys of a partition would be placed into a few hash entries when
+    the partition is loaded into the join buffer.
+
+  RETURN VALUE
+    the number of the partition for the given key  
+*/
+
+uint JOIN_CACHE_HASHED::get_hash_partition(uchar *key, uint key_len,
+                                           uint n_partitions)
+{
+  ulong nr= get_hash_value(key, key_len);
+  return (uint) (((uint32) (nr * 2654435761UL) >> 16) % n_partitions);
+}
+
+
+/* 
+  Calculate the hash value for a key
+
+  SYNOPSIS
+    get_hash_value()
+      key             pointer to the key value
+      key_len         key value length
+
+  DESCRIPTION
+    The function calculates the hash value of the key in the same way as
+    the hash function of the hash table does, so that equal keys always
+    have the same hash value.
+
+  RETURN VALUE
+    the hash value for the key
+*/
+
+ulong JOIN_CACHE_HASHED::get_hash_value(uchar *key, uint key_len)
+{
+  if (hash_func == &JOIN_CACHE_HASHED::get_hash_idx_simple)
+    return get_hash_value_simple(key, key_len);
+  return key_hashnr(ref_key_info, ref_used_key_parts, key);
+}
+
+
+/*
+  Allocate the Bloom filter of a hashed join cache
+
+  SYNOPSIS
+    init_bloom_filter()
+
+  DESCRIPTION
+    The function allocates the Bloom filter over the keys put into the hash
+    table of the join cache. The filter gets JOIN_CACHE_BLOOM_BITS_PER_KEY
+    bits for each entry of the hash table, rounded up to a power of 2.
+    The filter is allocated in the memory of the statement, the join buffer
+    is not changed.
+
+  RETURN VALUE
+    FALSE   the filter has been allocated
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_HASHED::init_bloom_filter()
+{
+  ulonglong bits= (ulonglong) hash_entries * JOIN_CACHE_BLOOM_BITS_PER_KEY;
+  uint size= 64;
+
+  while (size < bits && size < JOIN_CACHE_BLOOM_MAX_BITS)
+    size<<= 1;
+  bloom_filter_mask= size - 1;
+  if (!(bloom_filter= (uchar*) join->thd->calloc(size >> 3)))
+    return TRUE;
+  return FALSE;
+}
+
+
+/*
+  Get the numbers of the two bits of the Bloom filter for a hash value
+*/
+
+static inline void bloom_filter_bits(ulong nr, uint mask,
+                                     uint *bit1, uint *bit2)
+{
+  ulonglong h= (ulonglong) nr * 0x9E3779B97F4A7C15ULL;
+  *bit1= (uint) (h >> 40) & mask;
+  *bit2= (uint) (h >> 16) & mask;
+}
+
+
+/*
+  Add a key to the Bloom filter of a hashed join cache
+*/
+
+void JOIN_CACHE_HASHED::add_key_to_bloom_filter(uchar *key)
+{
+  uint bit1, bit2;
+  bloom_filter_bits(get_hash_value(key, key_length), bloom_filter_mask,
+                    &bit1, &bit2);
+  bloom_filter[bit1 >> 3]|= (uchar) (1 << (bit1 & 7));
+  bloom_filter[bit2 >> 3]|= (uchar) (1 << (bit2 & 7));
+}
+
+
+/*
+  Check whether a key may have been added to the Bloom filter
+
+  RETURN VALUE
+    FALSE   the key is not in the hash table of the join cache
+    TRUE    the key may be in the hash table
+*/
+
+bool JOIN_CACHE_HASHED::bloom_filter_may_contain(uchar *key)
+{
+  uint bit1, bit2;
+  bloom_filter_bits(get_hash_value(key, key_length), bloom_filter_mask,
+                    &bit1, &bit2);
+  return (bloom_filter[bit1 >> 3] & (1 << (bit1 & 7))) &&
+         (bloom_filter[bit2 >> 3] & (1 << (bit2 & 7)));
+}
+
+
+/*
+  Prepare the Bloom filter for a new scan of join_tab
+
+  SYNOPSIS
+    start_join_tab_filter()
+
+  DESCRIPTION
+    The function decides whether the rows of join_tab are checked by the
+    Bloom filter in the scan of join_tab that is started. The filter is not
+    used when the join inputs have been spilled, as the keys of the spilled
+    records are not in the hash table, and when the filter has got so many
+    keys that it would reject few rows.
+*/
+
+void JOIN_CACHE_HASHED::start_join_tab_filter()
+{
+  bloom_filter_checks= bloom_filter_rejects= 0;
+  use_bloom_filter= bloom_filter && !is_spilled() &&
+                    (ulonglong) key_entries *
+                    JOIN_CACHE_BLOOM_BITS_PER_KEY / 4 <= bloom_filter_mask;
+}
+
+
+/*
+  Check the current row of join_tab by the Bloom filter
+
+  SYNOPSIS
+    join_tab_filter_passes()
+
+  DESCRIPTION
+    The function builds the join key of the row of join_tab that has been
+    read into its record buffer and looks for the key in the Bloom filter
+    over the keys in the hash table. A row rejected by the filter has no
+    matches in the join buffer, so it is skipped before the condition
+    pushed to join_tab is evaluated and before the hash table is searched.
+    If the filter rejects too few rows of the first JOIN_CACHE_BLOOM_SAMPLE
+    ones it is not checked any more in the current scan.
+
+  RETURN VALUE
+    FALSE   the row cannot match any record in the join buffer
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_HASHED::join_tab_filter_passes()
+{
+  if (!use_bloom_filter)
+    return TRUE;
+  KEY *keyinfo= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
+  key_copy(key_buff, join_tab->table->record[0], keyinfo, key_length, TRUE);
+  join_tab->jbuf_bloom_filter_tracker->r_checked_rows++;
+  if (++bloom_filter_checks == JOIN_CACHE_BLOOM_SAMPLE &&
+      bloom_filter_rejects < JOIN_CACHE_BLOOM_SAMPLE /
+                             JOIN_CACHE_BLOOM_MIN_REJECTED)
+    use_bloom_filter= FALSE;
+  if (bloom_filter_may_contain(key_buff))
+    return TRUE;
+  bloom_filter_rejects++;
+  join_tab->jbuf_bloom_filter_tracker->r_rejected_rows++;
+  return FALSE;
+}
+
+
 /* 
   Compare two key entries in the hash table as sequence of bytes
 
@@ -3352,9 +3631,14 @@ uint JOIN_CACHE_HASHED::get_next_key(uchar ** key)
 
 int JOIN_TAB_SCAN::open()
 {
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+  if (join_tab->partition_pruning && !cache->is_spilled())
+    cache->collect_partitions_to_scan();
+#endif
   save_or_restore_used_tabs(join_tab, FALSE);
   is_first_record= TRUE;
   join_tab->tracker->r_scans++;
+  cache->start_join_tab_filter();
   return join_init_read_record(join_tab);
 }
 
@@ -3398,13 +3682,21 @@ int JOIN_TAB_SCAN::next()
     join_tab->tracker->r_rows++;
   }
 
-  while (!err && select && (skip_rc= select->skip_record(thd)) <= 0)
+  while (!err)
   {
-    if (unlikely(thd->check_killed()) || skip_rc < 0)
+    if (cache->join_tab_filter_passes())
+    {
+      if (!select || (skip_rc= select->skip_record(thd)) > 0)
+        break;
+      if (skip_rc < 0)
+        return 1;
+    }
+    if (unlikely(thd->check_killed()))
       return 1;
     /* 
-      Move to the next record if the last retrieved record does not
-      meet the condition pushed to the table join_tab.
+      Move to the next record if the last retrieved record cannot match
+      any record in the join buffer or does not meet the condition pushed
+      to the table join_tab.
     */
     err= info->read_record();
     if (!err)
@@ -3482,6 +3774,54 @@ void JOIN_TAB_SCAN::close()
 }
 
 
+/* 
+  Initiate the iteration over the rows spilled into a partition file
+
+  SYNOPSIS
+    open()
+
+  DESCRIPTION
+    The function positions the file of the partition at its beginning
+    for reading.
+
+  RETURN VALUE   
+    0            initiation is a success 
+    error code   otherwise     
+*/
+
+int JOIN_TAB_SCAN_SPILLED::open()
+{
+  save_or_restore_used_tabs(join_tab, FALSE);
+  return MY_TEST(reinit_io_cache(file, READ_CACHE, 0L, 0, 0));
+}
+
+
+/* 
+  Read the next row spilled into a partition file
+
+  SYNOPSIS
+    next()
+
+  DESCRIPTION
+    The function reads the next row of join_tab from the file of the
+    partition into the record buffer of the table.
+
+  RETURN VALUE   
+    0            the next row has been successfully read 
+    -1           there are no more rows in the file
+    1            the read has failed
+*/
+
+int JOIN_TAB_SCAN_SPILLED::next()
+{
+  TABLE *table= join_tab->table;
+  if (my_b_read(file, table->record[0], table->s->reclength))
+    return file->error ? 1 : -1;
+  table->status= 0;
+  return 0;
+}
+
+
 /*
   Prepare to iterate over the BNL join cache buffer to look for matches 
 
@@ -3818,7 +4158,438 @@ int JOIN_CACHE_BNLH::init(bool for_explain)
   if (!(join_tab_scan= new JOIN_TAB_SCAN(join, join_tab)))
     DBUG_RETURN(1);
 
-  DBUG_RETURN(JOIN_CACHE_HASHED::init(for_explain));
+  if (!(spill_scan= new JOIN_TAB_SCAN_SPILLED(join, join_tab)))
+    DBUG_RETURN(1);
+
+  if (JOIN_CACHE_HASHED::init(for_explain))
+    DBUG_RETURN(1);
+
+  if (!for_explain && join->thd->variables.join_cache_bloom_filter &&
+      init_bloom_filter())
+    DBUG_RETURN(1);
+
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Check whether the join inputs of the BNLH join cache may be spilled
+
+  SYNOPSIS
+    can_spill()
+
+  DESCRIPTION
+    The function checks whether the records of the join buffer and the rows
+    of join_tab can be partitioned into temporary files when the join buffer
+    has overflowed. The partial join records are saved in the spill files as
+    images of the record buffers of the tables from start_tab to join_tab.
+    So spilling is supported only for plain inner equi-joins: the cache must
+    not be linked to a previous cache, no blobs may be used, there must be
+    no outer joins, semi-joins or SJM nests among the tables whose records
+    are stored in the buffer, and no rowids of the tables are needed.
+    Spilling is also turned off when the system variable
+    join_cache_spill_partitions is set to 0.
+
+  RETURN VALUE
+    TRUE    the join inputs can be spilled
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::can_spill()
+{
+  JOIN_TAB *tab;
+
+  if (!join->thd->variables.join_cache_spill_partitions ||
+      get_join_alg() != BNLH_JOIN_ALG || !spill_scan ||
+      prev_cache || blobs || join_tab->table->s->blob_fields ||
+      join_tab->use_quick == 2 || join_tab->check_weed_out_table ||
+      join_tab->bush_root_tab || start_tab->bush_root_tab)
+    return FALSE;
+
+  for (tab= start_tab; tab <= join_tab; tab++)
+  {
+    if (tab->bush_children || tab->first_inner || tab->first_sj_inner_tab ||
+        tab->emb_sj_nest || tab->keep_current_rowid)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+
+/*
+  Close the spill files of the BNLH join cache
+
+  SYNOPSIS
+    close_spill_files()
+
+  DESCRIPTION
+    The function closes the temporary files of all partitions, releases
+    the memory allocated for them and returns the cache into the state
+    where records are put into the join buffer.
+
+  RETURN VALUE
+    none
+*/
+
+void JOIN_CACHE_BNLH::close_spill_files()
+{
+  if (spill_files)
+  {
+    for (uint i= 0; i < 2 * spill_partitions; i++)
+      close_cached_file(&spill_files[i]);
+    my_free(spill_files);
+  }
+  spill_files= 0;
+  spill_partitions= 0;
+  spill_error= FALSE;
+}
+
+
+/*
+  Write the current partial join record into its spill partition
+
+  SYNOPSIS
+    spill_outer_record()
+
+  DESCRIPTION
+    The function builds the join key for the partial join record whose
+    fields are in the record buffers of the tables from start_tab to join_tab
+    and writes the images of the record buffers into the spill file of
+    the partition the key belongs to.
+    If writing fails the flag spill_error is set and the error is reported
+    when the records are joined.
+
+  RETURN VALUE
+    none
+*/
+
+void JOIN_CACHE_BNLH::spill_outer_record()
+{
+  TABLE_REF *ref= &join_tab->ref;
+  IO_CACHE *file;
+
+  if (spill_error)
+    return;
+
+  cp_buffer_from_ref(join->thd, join_tab->table, ref);
+  file= spill_files +
+        get_hash_partition(ref->key_buff, key_length, spill_partitions);
+
+  for (JOIN_TAB *tab= start_tab; tab != join_tab; tab++)
+  {
+    TABLE *table= tab->table;
+    if (my_b_write(file, table->record[0], table->s->reclength))
+    {
+      spill_error= TRUE;
+      return;
+    }
+  }
+  join_tab->jbuf_spill_tracker->r_outer_rows++;
+}
+
+
+/*
+  Read a partial join record from a spill file
+
+  SYNOPSIS
+    read_outer_record()
+      file    the spill file to read the record from
+
+  DESCRIPTION
+    The function reads the images of the record buffers of the tables
+    from start_tab to join_tab written by spill_outer_record.
+
+  RETURN VALUE
+    TRUE    there are no more records in the file or the read has failed
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::read_outer_record(IO_CACHE *file)
+{
+  for (JOIN_TAB *tab= start_tab; tab != join_tab; tab++)
+  {
+    TABLE *table= tab->table;
+    if (my_b_read(file, table->record[0], table->s->reclength))
+    {
+      if (file->error)
+        spill_error= TRUE;
+      return TRUE;
+    }
+    table->status= 0;
+    table->null_row= 0;
+  }
+  return FALSE;
+}
+
+
+/*
+  Move all records from the join buffer of the BNLH cache into spill files
+
+  SYNOPSIS
+    spill_buffer()
+
+  DESCRIPTION
+    The function is called when the join buffer has overflowed and the join
+    inputs can be spilled. It opens a temporary file for the partial join
+    records and a temporary file for the rows of join_tab for each of the
+    join_cache_spill_partitions partitions. Then it reads all records from
+    the join buffer and writes them into the files of their partitions.
+    After this the join buffer is emptied. All subsequent records are put
+    directly into the spill files.
+
+  NOTES
+    The records are read back into the record buffers, and the last one read
+    is the record that has just been put into the buffer. So the record
+    buffers are left in the same state as they have been before the call.
+
+  RETURN VALUE
+    FALSE   the records have been spilled
+    TRUE    the spill files could not be created, the join buffer
+            is left intact
+*/
+
+bool JOIN_CACHE_BNLH::spill_buffer()
+{
+  uint n= (uint) join->thd->variables.join_cache_spill_partitions;
+  DBUG_ENTER("JOIN_CACHE_BNLH::spill_buffer");
+
+  if (!(spill_files= (IO_CACHE*) my_malloc(key_memory_JOIN_CACHE,
+                                           2 * n * sizeof(IO_CACHE),
+                                           MYF(MY_ZEROFILL |
+                                               MY_THREAD_SPECIFIC))))
+    DBUG_RETURN(TRUE);
+  for (spill_partitions= 0; spill_partitions < n; spill_partitions++)
+  {
+    if (open_cached_file(&spill_files[spill_partitions], mysql_tmpdir,
+                         TEMP_PREFIX, JOIN_CACHE_SPILL_BUFFER_SIZE, MYF(0)) ||
+        open_cached_file(&spill_files[n + spill_partitions], mysql_tmpdir,
+                         TEMP_PREFIX, JOIN_CACHE_SPILL_BUFFER_SIZE, MYF(0)))
+    {
+      /* close_spill_files() expects the files to be laid out for n */
+      spill_partitions= n;
+      close_spill_files();
+      DBUG_RETURN(TRUE);
+    }
+  }
+
+  reset(FALSE);
+  while (!get_record())
+    spill_outer_record();
+  reset(TRUE);
+
+  join_tab->jbuf_spill_tracker->r_spills++;
+  join_tab->jbuf_spill_tracker->r_partitions= n;
+  DBUG_RETURN(FALSE);
+}
+
+
+/*
+  Add a record into the buffer or into the spill files of the BNLH cache
+
+  SYNOPSIS
+    put_record()
+
+  DESCRIPTION
+    This implementation of the virtual function put_record puts the record
+    into the join buffer as the implementation for JOIN_CACHE_HASHED does.
+    If the join buffer overflows and the join inputs can be spilled the
+    records from the buffer are moved into the spill files of their
+    partitions and the buffer is not reported as full. After this the
+    function writes every record directly into the spill files, so that
+    the join is performed only when all partial join records have been
+    received.
+
+  RETURN VALUE
+    TRUE    if it has been decided that it should be the last record
+            in the join buffer,
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::put_record()
+{
+  if (spill_files)
+  {
+    spill_outer_record();
+    return FALSE;
+  }
+  bool is_full= JOIN_CACHE_HASHED::put_record();
+  if (is_full && can_spill() && !spill_buffer())
+    return FALSE;
+  return is_full;
+}
+
+
+/*
+  Join records from the BNLH join buffer or from the spill files
+
+  SYNOPSIS
+    join_records()
+      skip_last    do not find matches for the last record from the buffer
+
+  DESCRIPTION
+    If the join inputs have not been spilled the function just calls
+    the default implementation. Otherwise it performs the join of
+    the spilled partitions.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state, except NESTED_LOOP_NO_MORE_ROWS.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_records(bool skip_last)
+{
+  if (!spill_files)
+    return JOIN_CACHE::join_records(skip_last);
+  DBUG_ASSERT(!skip_last);
+  return join_spilled_records();
+}
+
+
+/*
+  Distribute the rows of join_tab over the spill partitions
+
+  SYNOPSIS
+    spill_join_tab_rows()
+
+  DESCRIPTION
+    The function scans join_tab once. Each row that meets the condition
+    pushed to join_tab is written into the spill file for the rows of
+    join_tab of the partition its join key belongs to.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::spill_join_tab_rows()
+{
+  int error;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  TABLE *table= join_tab->table;
+  KEY *keyinfo= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
+  DBUG_ENTER("JOIN_CACHE_BNLH::spill_join_tab_rows");
+
+  if ((rc= join_tab_execution_startup(join_tab)) < 0)
+    DBUG_RETURN(rc);
+
+  join_tab->build_range_rowid_filter_if_needed();
+
+  if (unlikely((error= join_tab_scan->open())))
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+
+  while (!(error= join_tab_scan->next()))
+  {
+    if (unlikely(join->thd->check_killed()))
+    {
+      rc= NESTED_LOOP_KILLED;
+      break;
+    }
+    key_copy(key_buff, table->record[0], keyinfo, key_length, TRUE);
+    IO_CACHE *file= spill_files + spill_partitions +
+                    get_hash_partition(key_buff, key_length, spill_partitions);
+    if (my_b_write(file, table->record[0], table->s->reclength))
+    {
+      rc= NESTED_LOOP_ERROR;
+      break;
+    }
+    join_tab->jbuf_spill_tracker->r_inner_rows++;
+  }
+  join_tab_scan->close();
+  if (error > 0)
+    rc= NESTED_LOOP_ERROR;
+  DBUG_RETURN(rc);
+}
+
+
+/*
+  Join the spilled partial join records with the spilled rows of join_tab
+
+  SYNOPSIS
+    join_spilled_records()
+
+  DESCRIPTION
+    The function is called when all partial join records have been
+    written into the spill files. It distributes the rows of join_tab
+    over the partitions and then joins the partitions pairwise. The partial
+    join records of a partition are loaded into the join buffer and the rows
+    of join_tab from the same partition are read from the spill file to
+    look for matches in the hash table of the buffer, exactly as the rows
+    are read from join_tab by join_matching_records.
+    If the records of a partition do not fit into the join buffer they are
+    loaded in several portions, and the rows of join_tab of the partition
+    are read once for each portion.
+    Partitions without partial join records or without rows of join_tab
+    cannot produce any matches and are skipped.
+    The spill files are closed when all partitions have been joined.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state, except NESTED_LOOP_NO_MORE_ROWS.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_spilled_records()
+{
+  enum_nested_loop_state rc;
+  JOIN_TAB_SCAN *save_join_tab_scan= join_tab_scan;
+  DBUG_ENTER("JOIN_CACHE_BNLH::join_spilled_records");
+
+  if (spill_error)
+  {
+    my_error(ER_ERROR_ON_WRITE, MYF(0), "join buffer spill file", my_errno);
+    rc= NESTED_LOOP_ERROR;
+    goto finish;
+  }
+
+  if ((rc= spill_join_tab_rows()) != NESTED_LOOP_OK)
+    goto finish;
+
+  join_tab_scan= spill_scan;
+  for (uint i= 0; i < spill_partitions; i++)
+  {
+    IO_CACHE *outer_file= spill_files + i;
+    IO_CACHE *inner_file= spill_files + spill_partitions + i;
+    bool eof= FALSE;
+
+    if (!my_b_tell(outer_file) || !my_b_tell(inner_file))
+      continue;
+    if (reinit_io_cache(outer_file, READ_CACHE, 0L, 0, 0))
+    {
+      rc= NESTED_LOOP_ERROR;
+      break;
+    }
+    spill_scan->set_file(inner_file);
+
+    while (!eof)
+    {
+      bool is_full= FALSE;
+      while (!is_full && !(eof= read_outer_record(outer_file)))
+        is_full= JOIN_CACHE_HASHED::put_record();
+      if (spill_error)
+      {
+        my_error(ER_ERROR_ON_READ, MYF(0), "join buffer spill file",
+                 my_errno);
+        rc= NESTED_LOOP_ERROR;
+        break;
+      }
+      if (!records)
+        break;
+      join_tab->jbuf_spill_tracker->r_builds++;
+      rc= join_matching_records(FALSE);
+      if ((rc == NESTED_LOOP_OK || rc == NESTED_LOOP_NO_MORE_ROWS) &&
+          next_cache)
+        rc= next_cache->join_records(FALSE);
+      reset(TRUE);
+      if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+        break;
+      rc= NESTED_LOOP_OK;
+    }
+    if (rc != NESTED_LOOP_OK)
+      break;
+  }
+  join_tab_scan= save_join_tab_scan;
+
+finish:
+  close_spill_files();
+  reset(TRUE);
+  DBUG_PRINT("exit", ("rc: %d", rc));
+  DBUG_RETURN(rc);
 }
 
 
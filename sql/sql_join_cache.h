@@ -521,6 +521,26 @@ class JOIN_CACHE :public Sql_alloc
   /* Restore the fields of the last record from the join buffer */
   virtual void restore_last_record();
 
+  /*
+    Return TRUE if the partial join records have been moved out of the
+    join buffer into spill files
+  */
+  virtual bool is_spilled() { return FALSE; }
+
+  /* Prepare the filter of the rows of join_tab for a new scan of join_tab */
+  virtual void start_join_tab_filter() {}
+
+  /*
+    Return FALSE if the current row of join_tab cannot match any record
+    in the join buffer
+  */
+  virtual bool join_tab_filter_passes() { return TRUE; }
+
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+  /* Collect the partitions of join_tab the records in the buffer can match */
+  void collect_partitions_to_scan();
+#endif
+
   /* Set match flag for a record in join buffer if it has not been set yet */
   bool set_match_flag_if_none(JOIN_TAB *first_inner, uchar *rec_ptr);
 
@@ -659,7 +679,7 @@ class JOIN_CACHE :public Sql_alloc
   }
      
   /* Join records from the join buffer with records from the next join table */ 
-  enum_nested_loop_state join_records(bool skip_last);
+  virtual enum_nested_loop_state join_records(bool skip_last);
 
   /* Add a comment on the join algorithm employed by the join cache */
   virtual bool save_explain_data(EXPLAIN_BKA_TYPE *explain);
@@ -668,7 +688,7 @@ class JOIN_CACHE :public Sql_alloc
 
   virtual ~JOIN_CACHE() {}
   void reset_join(JOIN *j) { join= j; }
-  void free()
+  virtual void free()
   { 
     my_free(buff);
     buff= 0;
@@ -791,6 +811,19 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* The offset of the data fields from the beginning of the record fields */
   uint data_fields_offset;
 
+  /*
+    The Bloom filter over the keys in the hash table, or 0 if the cache
+    does not use it. It is allocated outside of the join buffer.
+  */
+  uchar *bloom_filter;
+  /* The number of bits of the Bloom filter minus 1, a power of 2 minus 1 */
+  uint bloom_filter_mask;
+  /* TRUE if the Bloom filter is checked in the current scan of join_tab */
+  bool use_bloom_filter;
+  /* Rows of join_tab checked and rejected in the current scan */
+  uint bloom_filter_checks, bloom_filter_rejects;
+
+  inline ulong get_hash_value_simple(uchar *key, uint key_len);
   inline uint get_hash_idx_simple(uchar *key, uint key_len);
   inline uint get_hash_idx_complex(uchar *key, uint key_len);
 
@@ -799,6 +832,12 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
 
   int init_hash_table();
   void cleanup_hash_table();
+
+  /* Get the hash value of a key that is equal for equal keys */
+  ulong get_hash_value(uchar *key, uint key_len);
+
+  void add_key_to_bloom_filter(uchar *key);
+  bool bloom_filter_may_contain(uchar *key);
   
 protected:
 
@@ -975,12 +1014,21 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* Reallocate the join buffer of a hashed join cache */
   int realloc_buffer();
 
+  /* Get the number of the spill partition a key value belongs to */
+  uint get_hash_partition(uchar *key, uint key_len, uint n_partitions);
+
+  /* Allocate the Bloom filter over the keys in the hash table */
+  bool init_bloom_filter();
+
   /* 
     This constructor creates an unlinked hashed join cache. The cache is to be
     used to join table 'tab' to the result of joining the previous tables 
     specified by the 'j' parameter.
   */   
-  JOIN_CACHE_HASHED(JOIN *j, JOIN_TAB *tab) :JOIN_CACHE(j, tab) {}
+  JOIN_CACHE_HASHED(JOIN *j, JOIN_TAB *tab) :JOIN_CACHE(j, tab)
+  {
+    bloom_filter= 0;
+  }
 
   /* 
     This constructor creates a linked hashed join cache. The cache is to be
@@ -989,7 +1037,10 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
     cache object to which this cache is linked.
   */   
   JOIN_CACHE_HASHED(JOIN *j, JOIN_TAB *tab, JOIN_CACHE *prev) 
-		    :JOIN_CACHE(j, tab, prev) {}
+		    :JOIN_CACHE(j, tab, prev)
+  {
+    bloom_filter= 0;
+  }
 
 public:
 
@@ -1005,6 +1056,11 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* Read the next record from the buffer of a hashed join cache */
   bool get_record();
 
+  void start_join_tab_filter();
+
+  /* Check the join key of the current row of join_tab by the Bloom filter */
+  bool join_tab_filter_passes();
+
   /*
     Shall check whether all records in a key chain have 
     their match flags set on
@@ -1086,6 +1142,36 @@ class JOIN_TAB_SCAN: public Sql_alloc
 
 };
 
+/*
+  The class JOIN_TAB_SCAN_SPILLED is a companion class for the class
+  JOIN_CACHE_BNLH used when the join buffer of the cache has overflowed
+  and both join inputs have been partitioned into temporary files.
+  The iterator reads the rows of the joined table that have been written
+  into the temporary file of one partition back into the record buffer
+  of the table. The rows in the file have already been checked against
+  the condition pushed to the table.
+*/
+
+class JOIN_TAB_SCAN_SPILLED: public JOIN_TAB_SCAN
+{
+  /* The file with the rows of the partition to iterate over */
+  IO_CACHE *file;
+
+public:
+
+  JOIN_TAB_SCAN_SPILLED(JOIN *j, JOIN_TAB *tab)
+    :JOIN_TAB_SCAN(j, tab), file(0) {}
+
+  /* Set the file of the partition to iterate over */
+  void set_file(IO_CACHE *f) { file= f; }
+
+  int open();
+
+  int next();
+
+};
+
+
 /*
   The class JOIN_CACHE_BNL is used when the BNL join algorithm is
   employed to perform a join operation   
@@ -1178,6 +1264,49 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
 
   void read_next_candidate_for_match(uchar *rec_ptr);
 
+private:
+
+  /*
+    The temporary files of the partitions when the join buffer has been
+    spilled: first the files with the partial join records, then the files
+    with the rows of join_tab. The array is 0 when nothing is spilled.
+  */
+  IO_CACHE *spill_files;
+  /* Number of partitions the join inputs are spilled into */
+  uint spill_partitions;
+  /* TRUE if writing or reading of a spill file has failed */
+  bool spill_error;
+  /* The iterator over the rows of join_tab spilled into a partition */
+  JOIN_TAB_SCAN_SPILLED *spill_scan;
+
+  /* Check whether the join inputs may be spilled when the buffer is full */
+  bool can_spill();
+
+  /* Move all records from the join buffer into the spill files */
+  bool spill_buffer();
+
+  /* Write the current partial join record into its spill partition */
+  void spill_outer_record();
+
+  /* Read a partial join record from a spill file into the record buffers */
+  bool read_outer_record(IO_CACHE *file);
+
+  /* Distribute the rows of join_tab over the spill partitions */
+  enum_nested_loop_state spill_join_tab_rows();
+
+  /* Join the spilled partial join records with the spilled rows */
+  enum_nested_loop_state join_spilled_records();
+
+  void close_spill_files();
+
+  void init_spill()
+  {
+    spill_files= 0;
+    spill_partitions= 0;
+    spill_error= FALSE;
+    spill_scan= 0;
+  }
+
 public:
 
   /* 
@@ -1185,7 +1314,10 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     used to join table 'tab' to the result of joining the previous tables 
     specified by the 'j' parameter.
   */   
-  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab) : JOIN_CACHE_HASHED(j, tab) {}
+  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab) : JOIN_CACHE_HASHED(j, tab)
+  {
+    init_spill();
+  }
 
   /* 
     This constructor creates a linked BNLH join cache. The cache is to be 
@@ -1194,7 +1326,10 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     cache object to which this cache is linked.
   */   
   JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab, JOIN_CACHE *prev) 
-    : JOIN_CACHE_HASHED(j, tab, prev) {}
+    : JOIN_CACHE_HASHED(j, tab, prev)
+  {
+    init_spill();
+  }
 
   /* Initialize the BNLH cache */       
   int init(bool for_explain);
@@ -1203,6 +1338,20 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
 
   bool is_key_access() { return TRUE; }
 
+  bool is_spilled() { return spill_files != 0; }
+
+  /* Add a record into the buffer or into the spill files of the cache */
+  bool put_record();
+
+  /* Join the records from the join buffer or from the spill files */
+  enum_nested_loop_state join_records(bool skip_last);
+
+  void free()
+  {
+    close_spill_files();
+    JOIN_CACHE_HASHED::free();
+  }
+
 };
 
 
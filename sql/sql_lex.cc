@@ -1244,6 +1244,7 @@ void LEX::start(THD *thd_arg)
   with_persistent_for_clause= FALSE;
   column_list= NULL;
   index_list= NULL;
+  column_group_list= NULL;
   prepared_stmt.lex_start();
   auxiliary_table_list.empty();
   unit.next= unit.master= unit.link_next= unit.return_to= 0;
@@ -2944,6 +2945,7 @@ void st_select_lex::init_query()
   item_list.empty();
   min_max_opt_list.empty();
   join= 0;
+  plan_cache= 0;
   having= prep_having= where= prep_where= 0;
   cond_pushed_into_where= cond_pushed_into_having= 0;
   attach_to_conds.empty();
@@ -842,6 +842,7 @@ typedef class st_select_lex_node SELECT_LEX_NODE;
 class THD;
 class select_result;
 class JOIN;
+class Join_plan_cache;
 class select_unit;
 class Procedure;
 class Explain_query;
@@ -1140,6 +1141,8 @@ class st_select_lex: public st_select_lex_node
   */
   List<Item_sum> min_max_opt_list;
   JOIN *join; /* after JOIN::prepare it is pointer to corresponding JOIN */
+  /* join order kept between executions of a prepared statement */
+  Join_plan_cache *plan_cache;
   List<TABLE_LIST> top_join_list; /* join list of the top level          */
   List<TABLE_LIST> *join_list;    /* list for the currently parsed join  */
   TABLE_LIST *embedding;          /* table embedding to the above list   */
@@ -3277,6 +3280,8 @@ struct LEX: public Query_tables_list
   List<LEX_CSTRING>   view_list; // view list (list of field names in view)
   List<LEX_STRING>   *column_list; // list of column names (in ANALYZE)
   List<LEX_STRING>   *index_list;  // list of index names (in ANALYZE)
+  /* list of column groups (in ANALYZE) */
+  List<List<LEX_STRING> > *column_group_list;
   /*
     A stack of name resolution contexts for the query. This stack is used
     at parse time to set local name resolution contexts for various parts
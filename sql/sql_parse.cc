@@ -95,6 +95,7 @@
 #include "sql_sequence.h"
 #include "opt_trace.h"
 #include "mysql/psi/mysql_sp.h"
+#include "sql_plan_cache.h"
 
 #include "my_json_writer.h" 
 
@@ -10376,12 +10377,14 @@ bool parse_sql(THD *thd, Parser_state *parser_state,
     /* Start Digest */
     parser_state->m_digest_psi= MYSQL_DIGEST_START(thd->m_statement_psi);
 
-    if (parser_state->m_digest_psi != NULL)
+    if (parser_state->m_digest_psi != NULL ||
+        (digest_plan_cache_size && thd->m_digest != NULL))
     {
       /*
         If either:
         - the caller wants to compute a digest
         - the performance schema wants to compute a digest
+        - the digest plan cache needs the digest
         set the digest listener in the lexer.
       */
       parser_state->m_lip.m_digest= thd->m_digest;
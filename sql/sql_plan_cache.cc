@@ -0,0 +1,242 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA */
+
+/*
+  Digest plan cache
+
+  Server wide cache of the join orders chosen for the selects of
+  non-prepared statements. An entry is found by the digest of the
+  statement, that is the tokens of the statement with the literals left
+  out, the current database and the number of the select.
+
+  A select gets a copy of the entry. The guards of Join_plan_cache decide
+  whether the cached join order can be taken for the literals of this
+  execution. When the join order is searched again, the new one replaces
+  the entry. When the cache is full, the least recently used entry is
+  removed.
+*/
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "sql_class.h"
+#include "sql_select.h"
+#include "sql_digest.h"
+#include "sql_plist.h"
+#include "sql_plan_cache.h"
+
+ulong digest_plan_cache_size, digest_plan_cache_entries;
+
+struct Digest_plan_entry
+{
+  /* The join order is allocated here */
+  MEM_ROOT mem_root;
+  Join_plan_cache *plan;
+  Digest_plan_entry *next_in_lru, **prev_in_lru;
+  uchar *key;
+  uint key_length;
+};
+
+/* The least recently used entry is the first one */
+typedef I_P_List<Digest_plan_entry,
+                 I_P_List_adapter<Digest_plan_entry,
+                                  &Digest_plan_entry::next_in_lru,
+                                  &Digest_plan_entry::prev_in_lru>,
+                 I_P_List_null_counter,
+                 I_P_List_fast_push_back<Digest_plan_entry> >
+        Digest_plan_lru;
+
+static HASH digest_plan_hash;
+static Digest_plan_lru digest_plan_lru;
+static mysql_mutex_t LOCK_digest_plan_cache;
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_mutex_key key_LOCK_digest_plan_cache;
+static PSI_mutex_info all_digest_plan_cache_mutexes[]=
+{
+  { &key_LOCK_digest_plan_cache, "LOCK_digest_plan_cache", PSI_FLAG_GLOBAL}
+};
+#endif
+
+
+static uchar *digest_plan_get_key(const Digest_plan_entry *entry,
+                                  size_t *length, my_bool)
+{
+  *length= entry->key_length;
+  return (uchar*) entry->key;
+}
+
+
+static void digest_plan_free_entry(Digest_plan_entry *entry)
+{
+  digest_plan_lru.remove(entry);
+  free_root(&entry->mem_root, MYF(0));
+  my_free(entry);
+}
+
+
+void digest_plan_cache_init()
+{
+#ifdef HAVE_PSI_INTERFACE
+  mysql_mutex_register("sql", all_digest_plan_cache_mutexes,
+                       array_elements(all_digest_plan_cache_mutexes));
+#endif
+  mysql_mutex_init(key_LOCK_digest_plan_cache, &LOCK_digest_plan_cache,
+                   MY_MUTEX_INIT_FAST);
+  my_hash_init(PSI_INSTRUMENT_ME, &digest_plan_hash, &my_charset_bin, 64, 0,
+               0, (my_hash_get_key) digest_plan_get_key,
+               (my_hash_free_key) digest_plan_free_entry, 0);
+}
+
+
+void digest_plan_cache_free()
+{
+  my_hash_free(&digest_plan_hash);
+  mysql_mutex_destroy(&LOCK_digest_plan_cache);
+}
+
+
+/* Remove the least recently used entries above the size of the cache */
+
+static void digest_plan_cache_shrink(ulong size)
+{
+  mysql_mutex_assert_owner(&LOCK_digest_plan_cache);
+  while (digest_plan_hash.records > size)
+    my_hash_delete(&digest_plan_hash, (uchar*) digest_plan_lru.front());
+  digest_plan_cache_entries= (ulong) digest_plan_hash.records;
+}
+
+
+void digest_plan_cache_resize()
+{
+  mysql_mutex_lock(&LOCK_digest_plan_cache);
+  digest_plan_cache_shrink(digest_plan_cache_size);
+  mysql_mutex_unlock(&LOCK_digest_plan_cache);
+}
+
+
+/*
+  Make the key of the entry of a select on the memory of the statement
+
+  RETURN
+    NULL   The statement has no complete digest
+    other  The key
+*/
+
+static uchar *digest_plan_key(THD *thd, JOIN *join, uint *key_length)
+{
+  sql_digest_storage *digest;
+  uchar *key;
+
+  if (!thd->m_digest)
+    return NULL;
+  digest= &thd->m_digest->m_digest_storage;
+  if (digest->m_full || digest->is_empty())
+    return NULL;
+  *key_length= digest->m_byte_count + 4 + (uint) thd->db.length;
+  if (!(key= (uchar*) thd->alloc(*key_length)))
+    return NULL;
+  memcpy(key, digest->m_token_array, digest->m_byte_count);
+  int4store(key + digest->m_byte_count, join->select_lex->select_number);
+  if (thd->db.length)
+    memcpy(key + digest->m_byte_count + 4, thd->db.str, thd->db.length);
+  return key;
+}
+
+
+/**
+  Get the cache of the join order for a select of a non-prepared statement
+
+  @return
+    A Join_plan_cache on the memory of the statement, with the join order
+    of the entry if there is one, or NULL if the cache can not be used
+*/
+
+Join_plan_cache *digest_plan_cache_get(THD *thd, JOIN *join)
+{
+  uchar *key;
+  uint key_length;
+  Join_plan_cache *plan;
+  Digest_plan_entry *entry;
+
+  if (!digest_plan_cache_size ||
+      !(key= digest_plan_key(thd, join, &key_length)) ||
+      !(plan= Join_plan_cache::create(thd->mem_root, join->table_count)))
+    return NULL;
+
+  mysql_mutex_lock(&LOCK_digest_plan_cache);
+  if ((entry= (Digest_plan_entry*) my_hash_search(&digest_plan_hash, key,
+                                                   key_length)))
+  {
+    plan->copy(entry->plan);
+    digest_plan_lru.remove(entry);
+    digest_plan_lru.push_back(entry);
+  }
+  mysql_mutex_unlock(&LOCK_digest_plan_cache);
+  return plan;
+}
+
+
+/**
+  Put the join order chosen for a select into the cache
+
+  @note
+    Nothing is done when the join order was taken from the cache
+*/
+
+void digest_plan_cache_put(THD *thd, JOIN *join, Join_plan_cache *plan)
+{
+  uchar *key;
+  uint key_length;
+  Digest_plan_entry *entry;
+
+  if (!plan->is_saved() || !(key= digest_plan_key(thd, join, &key_length)))
+    return;
+
+  mysql_mutex_lock(&LOCK_digest_plan_cache);
+  if ((entry= (Digest_plan_entry*) my_hash_search(&digest_plan_hash, key,
+                                                   key_length)))
+  {
+    if (!entry->plan->copy(plan))
+    {
+      digest_plan_lru.remove(entry);
+      digest_plan_lru.push_back(entry);
+      goto end;
+    }
+    /* The select has another number of tables now */
+    my_hash_delete(&digest_plan_hash, (uchar*) entry);
+  }
+  if (!digest_plan_cache_size)
+    goto end;
+  digest_plan_cache_shrink(digest_plan_cache_size - 1);
+
+  if (!(entry= (Digest_plan_entry*) my_malloc(PSI_INSTRUMENT_ME,
+                                              sizeof(Digest_plan_entry),
+                                              MYF(0))))
+    goto end;
+  init_alloc_root(PSI_INSTRUMENT_ME, &entry->mem_root, 512, 0, MYF(0));
+  entry->key_length= key_length;
+  digest_plan_lru.push_back(entry);
+  if (!(entry->key= (uchar*) memdup_root(&entry->mem_root, key,
+                                         key_length)) ||
+      !(entry->plan= Join_plan_cache::create(&entry->mem_root,
+                                             join->table_count)) ||
+      entry->plan->copy(plan) ||
+      my_hash_insert(&digest_plan_hash, (uchar*) entry))
+    digest_plan_free_entry(entry);
+  digest_plan_cache_entries= (ulong) digest_plan_hash.records;
+
+end:
+  mysql_mutex_unlock(&LOCK_digest_plan_cache);
+}
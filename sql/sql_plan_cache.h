@@ -0,0 +1,33 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA */
+
+#ifndef SQL_PLAN_CACHE_INCLUDED
+#define SQL_PLAN_CACHE_INCLUDED
+
+class THD;
+class JOIN;
+class Join_plan_cache;
+
+/* The maximum number of entries, 0 if the cache is disabled */
+extern ulong digest_plan_cache_size;
+extern ulong digest_plan_cache_entries;
+
+void digest_plan_cache_init();
+void digest_plan_cache_free();
+void digest_plan_cache_resize();
+Join_plan_cache *digest_plan_cache_get(THD *thd, JOIN *join);
+void digest_plan_cache_put(THD *thd, JOIN *join, Join_plan_cache *plan);
+
+#endif /* SQL_PLAN_CACHE_INCLUDED */
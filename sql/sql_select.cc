@@ -67,6 +67,7 @@
 #include "select_handler.h"
 #include "my_json_writer.h"
 #include "opt_trace.h"
+#include "sql_plan_cache.h"
 
 /*
   A key part number that means we're using a fulltext scan.
@@ -107,15 +108,18 @@ static ha_rows get_quick_record_count(THD *thd, SQL_SELECT *select,
 				      TABLE *table,
 				      const key_map *keys,ha_rows limit);
 static void optimize_straight_join(JOIN *join, table_map join_tables);
+static Join_plan_cache *get_join_plan_cache(JOIN *join);
+class Join_plan_memo;
 static bool greedy_search(JOIN *join, table_map remaining_tables,
                           uint depth, uint prune_level,
-                          uint use_cond_selectivity);
+                          uint use_cond_selectivity, bool use_memo);
 static bool best_extension_by_limited_search(JOIN *join,
                                              table_map remaining_tables,
                                              uint idx, double record_count,
                                              double read_time, uint depth,
                                              uint prune_level,
-                                             uint use_cond_selectivity);
+                                             uint use_cond_selectivity,
+                                             Join_plan_memo *memo);
 static uint determine_search_depth(JOIN* join);
 C_MODE_START
 static int join_tab_cmp(const void *dummy, const void* ptr1, const void* ptr2);
@@ -183,6 +187,8 @@ static enum_nested_loop_state
 end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static enum_nested_loop_state
 end_unique_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 
 static int join_read_const_table(THD *thd, JOIN_TAB *tab, POSITION *pos);
 static int join_read_system(JOIN_TAB *tab);
@@ -280,6 +286,7 @@ static bool update_sum_func(Item_sum **func);
 static void select_describe(JOIN *join, bool need_tmp_table,bool need_order,
 			    bool distinct, const char *message=NullS);
 static void add_group_and_distinct_keys(JOIN *join, JOIN_TAB *join_tab);
+static void add_skip_scan_keys(JOIN *join, JOIN_TAB *join_tab);
 static uint make_join_orderinfo(JOIN *join);
 static bool generate_derived_keys(DYNAMIC_ARRAY *keyuse_array);
 
@@ -4071,6 +4078,8 @@ JOIN::reinit()
     for ( ; curr_tab < end_tab; curr_tab++)
     {
       TABLE *tmp_table= curr_tab->table;
+      if (curr_tab->aggr && curr_tab->aggr->hash_aggr)
+        curr_tab->aggr->hash_aggr->reset();
       if (!tmp_table->is_created())
         continue;
       tmp_table->file->extra(HA_EXTRA_RESET_STATE);
@@ -4505,6 +4514,7 @@ JOIN::destroy()
         free_tmp_table(thd, tab->table);
         delete tab->tmp_table_param;
         tab->tmp_table_param= NULL;
+        tab->aggr->cleanup();
         tab->aggr= NULL;
       }
       tab->table= NULL;
@@ -5464,6 +5474,12 @@ make_join_statistics(JOIN *join, List<TABLE_LIST> &tables_list,
       */
       add_group_and_distinct_keys(join, s);
 
+      /*
+        Add to stat->const_keys the covering indexes that can only be used
+        by an index skip scan.
+      */
+      add_skip_scan_keys(join, s);
+
       s->table->cond_selectivity= 1.0;
 
       /*
@@ -5608,8 +5624,12 @@ make_join_statistics(JOIN *join, List<TABLE_LIST> &tables_list,
     /* Find an optimal join order of the non-constant tables. */
     if (join->const_tables != join->table_count)
     {
-      if (choose_plan(join, all_table_map & ~join->const_table_map))
+      Join_plan_cache *plan_cache= get_join_plan_cache(join);
+      if (choose_plan(join, all_table_map & ~join->const_table_map,
+                      plan_cache))
         goto error;
+      if (plan_cache && join->thd->stmt_arena->is_conventional())
+        digest_plan_cache_put(join->thd, join, plan_cache);
 
 #ifdef HAVE_valgrind
       // JOIN::positions holds the current query plan. We've already
@@ -7200,6 +7220,44 @@ add_group_and_distinct_keys(JOIN *join, JOIN_TAB *join_tab)
 }
 
 
+/**
+  Discover the indexes that can be used for an index skip scan.
+
+  Find the covering indexes that have a field compared with a constant,
+  but are not usable by any condition on their first field, and add those
+  indexes to join_tab->const_keys. This allows later on such queries to be
+  processed by a QUICK_SKIP_SCAN_SELECT.
+
+  @param join
+  @param join_tab
+
+  @return
+    None
+*/
+
+static void
+add_skip_scan_keys(JOIN *join, JOIN_TAB *join_tab)
+{
+  TABLE *table= join_tab->table;
+  key_map skip_scan_keys;
+
+  if (!join->thd->variables.optimizer_skip_scan ||
+      bitmap_is_clear_all(&table->cond_set))
+    return;
+
+  skip_scan_keys.clear_all();
+  for (Field **field_ptr= table->field; *field_ptr; field_ptr++)
+  {
+    if (bitmap_is_set(&table->cond_set, (*field_ptr)->field_index))
+      skip_scan_keys.merge((*field_ptr)->part_of_key);
+  }
+  skip_scan_keys.intersect(table->covering_keys);
+  skip_scan_keys.intersect(table->keys_in_use_for_query);
+  skip_scan_keys.subtract(join_tab->keys);
+  join_tab->const_keys.merge(skip_scan_keys);
+}
+
+
 /*****************************************************************************
   Go through all combinations of not marked tables and find the one
   which uses least records
@@ -8285,6 +8343,37 @@ static void choose_initial_table_order(JOIN *join)
 }
 
 
+/**
+  Get the cache of the join order of a select that is executed many times
+
+  @details
+    The join orders of the selects of prepared statements and of the
+    statements of stored routines are cached when there are at least two
+    non-constant tables to order. The cache is allocated on the memory of
+    the statement at the first execution. Non-prepared statements use the
+    digest plan cache.
+
+  @retval
+    NULL  The join order is not to be cached
+*/
+
+static Join_plan_cache *get_join_plan_cache(JOIN *join)
+{
+  THD *thd= join->thd;
+  SELECT_LEX *select= join->select_lex;
+
+  if (!thd->variables.optimizer_plan_cache ||
+      join->table_count - join->const_tables < 2)
+    return NULL;
+  if (thd->stmt_arena->is_conventional())
+    return digest_plan_cache_get(thd, join);
+  if (!select->plan_cache)
+    select->plan_cache= Join_plan_cache::create(thd->stmt_arena->mem_root,
+                                                join->table_count);
+  return select->plan_cache;
+}
+
+
 /**
   Selects and invokes a search strategy for an optimal query plan.
 
@@ -8297,6 +8386,8 @@ static void choose_initial_table_order(JOIN *join)
   @param join         pointer to the structure providing all context info for
                       the query
   @param join_tables  set of the tables in the query
+  @param plan_cache   if not NULL, the join order to take when it is still
+                      valid, and where to save the chosen join order otherwise
 
   @retval
     FALSE       ok
@@ -8305,7 +8396,7 @@ static void choose_initial_table_order(JOIN *join)
 */
 
 bool
-choose_plan(JOIN *join, table_map join_tables)
+choose_plan(JOIN *join, table_map join_tables, Join_plan_cache *plan_cache)
 {
   uint search_depth= join->thd->variables.optimizer_search_depth;
   uint prune_level=  join->thd->variables.optimizer_prune_level;
@@ -8362,15 +8453,39 @@ choose_plan(JOIN *join, table_map join_tables)
   {
     optimize_straight_join(join, join_tables);
   }
+  else if (plan_cache && plan_cache->is_usable(join))
+  {
+    /* Only the access methods are chosen for the cached join order */
+    plan_cache->use(join);
+    optimize_straight_join(join, join_tables);
+    thd->status_var.optimizer_plan_cache_hits++;
+  }
   else
   {
+    uint dp_limit= (uint) thd->variables.optimizer_join_dp_limit;
+    /*
+      The state of the semi-join strategies of a partial plan depends on the
+      order of its tables, so partial plans are not memoized for them.
+    */
+    bool use_memo= dp_limit && !join->select_lex->sj_nests.elements;
+
     DBUG_ASSERT(search_depth <= MAX_TABLES + 1);
     if (search_depth == 0)
       /* Automatically determine a reasonable value for 'search_depth' */
       search_depth= determine_search_depth(join);
+    if (use_memo && join->table_count - join->const_tables > dp_limit)
+    {
+      /* Too many tables for the exhaustive search: fall back to greedy */
+      set_if_smaller(search_depth, dp_limit);
+    }
     if (greedy_search(join, join_tables, search_depth, prune_level,
-                      use_cond_selectivity))
+                      use_cond_selectivity, use_memo))
       DBUG_RETURN(TRUE);
+    if (plan_cache)
+    {
+      plan_cache->save(join);
+      thd->status_var.optimizer_plan_cache_misses++;
+    }
   }
 
   /* 
@@ -8385,6 +8500,157 @@ choose_plan(JOIN *join, table_map join_tables)
 }
 
 
+/*
+  The class of the number of rows expected from a table: the rows
+  estimates of the same class differ by less than a factor of 2
+*/
+
+static inline uchar join_plan_record_class(ha_rows records)
+{
+  return (uchar) (records ? my_bit_log2_uint64(records) + 1 : 0);
+}
+
+
+Join_plan_cache *Join_plan_cache::create(MEM_ROOT *mem_root,
+                                         uint table_count)
+{
+  Join_plan_cache *cache;
+  if (!(cache= new (mem_root) Join_plan_cache) ||
+      !multi_alloc_root(mem_root,
+                        &cache->order, sizeof(uint) * table_count,
+                        &cache->table_versions,
+                        sizeof(ulonglong) * table_count,
+                        &cache->record_classes, sizeof(uchar) * table_count,
+                        NullS))
+    return NULL;
+  cache->table_count= table_count;
+  cache->valid= false;
+  cache->saved= false;
+  return cache;
+}
+
+
+/**
+  Take the join order and the guards of another cache of the same join
+
+  @retval
+    false  Ok
+  @retval
+    true   The caches are for different numbers of tables
+*/
+
+bool Join_plan_cache::copy(const Join_plan_cache *from)
+{
+  if (from->table_count != table_count)
+    return true;
+  memcpy(order, from->order, sizeof(uint) * table_count);
+  memcpy(table_versions, from->table_versions,
+         sizeof(ulonglong) * table_count);
+  memcpy(record_classes, from->record_classes, sizeof(uchar) * table_count);
+  stats_version= from->stats_version;
+  const_tables= from->const_tables;
+  optimizer_switch= from->optimizer_switch;
+  search_depth= from->search_depth;
+  prune_level= from->prune_level;
+  join_dp_limit= from->join_dp_limit;
+  use_cond_selectivity= from->use_cond_selectivity;
+  join_cache_level= from->join_cache_level;
+  valid= from->valid;
+  saved= false;
+  return false;
+}
+
+
+/**
+  Check whether the guards of the cached join order still hold
+
+  @note
+    Must be called after the constant tables are found and the range
+    analysis is done, that is, with the same state of the join as save().
+*/
+
+bool Join_plan_cache::is_usable(JOIN *join)
+{
+  system_variables *vars= &join->thd->variables;
+  if (!valid || join->table_count != table_count ||
+      join->const_table_map != const_tables ||
+      statistics_version != stats_version ||
+      vars->optimizer_switch != optimizer_switch ||
+      vars->optimizer_search_depth != search_depth ||
+      vars->optimizer_prune_level != prune_level ||
+      vars->optimizer_join_dp_limit != join_dp_limit ||
+      vars->optimizer_use_condition_selectivity != use_cond_selectivity ||
+      vars->join_cache_level != join_cache_level)
+    return false;
+  for (uint i= 0; i < table_count; i++)
+  {
+    JOIN_TAB *tab= join->best_ref[i];
+    uint tablenr= tab->table->tablenr;
+    if (tablenr >= table_count ||
+        table_versions[tablenr] != tab->table->s->get_table_ref_version() ||
+        record_classes[tablenr] != join_plan_record_class(tab->found_records))
+      return false;
+  }
+  return true;
+}
+
+
+/**
+  Put the non-constant tables of the join into the cached order
+*/
+
+void Join_plan_cache::use(JOIN *join)
+{
+  JOIN_TAB **first= join->best_ref + join->const_tables;
+  JOIN_TAB **end= join->best_ref + table_count;
+  for (uint i= 0; first + i < end; i++)
+  {
+    for (JOIN_TAB **tab= first + i; tab < end; tab++)
+    {
+      if ((*tab)->table->tablenr == order[i])
+      {
+        swap_variables(JOIN_TAB*, first[i], *tab);
+        break;
+      }
+    }
+  }
+}
+
+
+/**
+  Save the join order chosen by the search with its guards
+*/
+
+void Join_plan_cache::save(JOIN *join)
+{
+  system_variables *vars= &join->thd->variables;
+  valid= false;
+  if (join->table_count != table_count)
+    return;
+  for (uint i= 0; i < table_count; i++)
+  {
+    TABLE *table= join->best_ref[i]->table;
+    if (table->tablenr >= table_count)
+      return;
+    table_versions[table->tablenr]= table->s->get_table_ref_version();
+    record_classes[table->tablenr]=
+      join_plan_record_class(join->best_ref[i]->found_records);
+  }
+  for (uint i= join->const_tables; i < table_count; i++)
+    order[i - join->const_tables]= join->best_positions[i].table->table->tablenr;
+  const_tables= join->const_table_map;
+  stats_version= statistics_version;
+  optimizer_switch= vars->optimizer_switch;
+  search_depth= vars->optimizer_search_depth;
+  prune_level= vars->optimizer_prune_level;
+  join_dp_limit= vars->optimizer_join_dp_limit;
+  use_cond_selectivity= vars->optimizer_use_condition_selectivity;
+  join_cache_level= vars->join_cache_level;
+  valid= true;
+  saved= true;
+}
+
+
 /*
   Compare two join tabs based on the subqueries they are from.
    - top-level join tabs go first
@@ -8611,6 +8877,118 @@ determine_search_depth(JOIN *join)
 }
 
 
+/*
+  The cheapest partial plans found by best_extension_by_limited_search()
+  for the sets of tables they join.
+
+  The cost of the best extension of a partial plan depends on the set of
+  the tables in it and on the number of the records it produces, but
+  little on the order of these tables. A partial plan over the same set
+  of tables as a plan that has already been expanded, that is not
+  cheaper and does not produce fewer records, is not expanded again. With
+  this the depth-first search of all join orders becomes a dynamic
+  programming over the sets of tables, as the permutations of the same
+  tables are only expanded while they improve the plan.
+
+  When the query needs sorting, it can be avoided only if the first table
+  of the plan is join->sort_by_table, so the first table is a part of the
+  key then.
+
+  The memo is emptied before each call of best_extension_by_limited_search()
+  from greedy_search(), as the partial plans found in different calls
+  extend different plans.
+*/
+
+class Join_plan_memo
+{
+  struct Entry
+  {
+    /* The key: the tables not in the plan and the first table if needed */
+    table_map remaining_tables;
+    table_map first_table;
+    double read_time;
+    double record_count;
+  };
+  HASH hash;
+  MEM_ROOT mem_root;
+
+  static uchar *get_key(const Entry *entry, size_t *length, my_bool)
+  {
+    *length= 2 * sizeof(table_map);
+    return (uchar*) &entry->remaining_tables;
+  }
+
+public:
+  /* The memo stops growing when it has this many plans */
+  static const uint MAX_PLANS= 1U << 18;
+
+  Join_plan_memo()
+  {
+    init_alloc_root(PSI_INSTRUMENT_ME, &mem_root, 8192, 0, MYF(0));
+    my_hash_init(PSI_INSTRUMENT_ME, &hash, &my_charset_bin, 256, 0, 0,
+                 (my_hash_get_key) get_key, 0, 0);
+  }
+  ~Join_plan_memo()
+  {
+    my_hash_free(&hash);
+    free_root(&mem_root, MYF(0));
+  }
+  void reset()
+  {
+    my_hash_reset(&hash);
+    free_root(&mem_root, MYF(MY_MARK_BLOCKS_FREE));
+  }
+  bool is_dominated(table_map remaining_tables, table_map first_table,
+                    double read_time, double record_count);
+};
+
+
+/**
+  Check whether a partial plan needs not be expanded, and memoize it if it
+  does
+
+  @param remaining_tables  the tables not in the partial plan
+  @param first_table       the first table of the plan if its choice
+                           matters for the rest of the plan, 0 otherwise
+  @param read_time         the cost of the partial plan
+  @param record_count      the number of the records it produces
+
+  @retval
+    TRUE   a plan over the same tables that is not more expensive and does
+           not produce more records has been expanded
+  @retval
+    FALSE  otherwise
+*/
+
+bool Join_plan_memo::is_dominated(table_map remaining_tables,
+                                  table_map first_table,
+                                  double read_time, double record_count)
+{
+  table_map key[2]= { remaining_tables, first_table };
+  Entry *entry= (Entry*) my_hash_search(&hash, (uchar*) key, sizeof(key));
+  if (entry)
+  {
+    if (entry->read_time <= read_time && entry->record_count <= record_count)
+      return TRUE;
+    if (read_time <= entry->read_time && record_count <= entry->record_count)
+    {
+      entry->read_time= read_time;
+      entry->record_count= record_count;
+    }
+    return FALSE;
+  }
+  if (hash.records >= MAX_PLANS ||
+      !(entry= (Entry*) alloc_root(&mem_root, sizeof(Entry))))
+    return FALSE;
+  entry->remaining_tables= remaining_tables;
+  entry->first_table= first_table;
+  entry->read_time= read_time;
+  entry->record_count= record_count;
+  (void) my_hash_insert(&hash, (uchar*) entry);
+  return FALSE;
+}
+
+
 /**
   Select the best ways to access the tables in a query without reordering them.
 
@@ -8767,6 +9145,8 @@ optimize_straight_join(JOIN *join, table_map join_tables)
                           search
   @param use_cond_selectivity  specifies how the selectivity of the conditions
                           pushed to a table should be taken into account
+  @param use_memo         skip the partial plans that are worse than the
+                          plans over the same tables (see Join_plan_memo)
 
   @retval
     FALSE       ok
@@ -8779,7 +9159,8 @@ greedy_search(JOIN      *join,
               table_map remaining_tables,
               uint      search_depth,
               uint      prune_level,
-              uint      use_cond_selectivity)
+              uint      use_cond_selectivity,
+              bool      use_memo)
 {
   double    record_count= 1.0;
   double    read_time=    0.0;
@@ -8800,12 +9181,16 @@ greedy_search(JOIN      *join,
                                          :
                                          ~(table_map)0));
 
+  Join_plan_memo memo;
+
   do {
     /* Find the extension of the current QEP with the lowest cost */
     join->best_read= DBL_MAX;
+    memo.reset();
     if (best_extension_by_limited_search(join, remaining_tables, idx, record_count,
                                          read_time, search_depth, prune_level,
-                                         use_cond_selectivity))
+                                         use_cond_selectivity,
+                                         use_memo ? &memo : NULL))
       DBUG_RETURN(TRUE);
     /*
       'best_read < DBL_MAX' means that optimizer managed to find
@@ -9525,6 +9910,8 @@ double table_cond_selectivity(JOIN *join, uint idx, JOIN_TAB *s,
                           (values: 0 = EXHAUSTIVE, 1 = PRUNE_BY_TIME_OR_ROWS)
   @param use_cond_selectivity  specifies how the selectivity of the conditions
                           pushed to a table should be taken into account
+  @param memo             if not NULL, the partial plans expanded so far
+                          (see Join_plan_memo)
 
   @retval
     FALSE       ok
@@ -9540,7 +9927,8 @@ best_extension_by_limited_search(JOIN      *join,
                                  double    read_time,
                                  uint      search_depth,
                                  uint      prune_level,
-                                 uint      use_cond_selectivity)
+                                 uint      use_cond_selectivity,
+                                 Join_plan_memo *memo)
 {
   DBUG_ENTER("best_extension_by_limited_search");
 
@@ -9683,7 +10071,25 @@ best_extension_by_limited_search(JOIN      *join,
       double partial_join_cardinality= current_record_count *
                                         pushdown_cond_selectivity;
       if ( (search_depth > 1) && (remaining_tables & ~real_table_bit) & allowed_tables )
-      { /* Recursively expand the current partial plan */
+      {
+        if (memo &&
+            memo->is_dominated(remaining_tables & ~real_table_bit,
+                               join->sort_by_table ?
+                               join->positions[join->const_tables].
+                                 table->table->map : 0,
+                               current_read_time, partial_join_cardinality))
+        {
+          DBUG_EXECUTE("opt", print_plan(join, idx+1,
+                                         current_record_count,
+                                         read_time,
+                                         current_read_time,
+                                         "pruned_by_memo"););
+          trace_one_table.add("pruned_by_memo", true);
+          restore_prev_nj_state(s);
+          restore_prev_sj_state(remaining_tables, s, idx);
+          continue;
+        }
+        /* Recursively expand the current partial plan */
         swap_variables(JOIN_TAB*, join->best_ref[idx], *pos);
         Json_writer_array trace_rest(thd, "rest_of_plan");
         if (best_extension_by_limited_search(join,
@@ -9693,7 +10099,8 @@ best_extension_by_limited_search(JOIN      *join,
                                              current_read_time,
                                              search_depth - 1,
                                              prune_level,
-                                             use_cond_selectivity))
+                                             use_cond_selectivity,
+                                             memo))
           DBUG_RETURN(TRUE);
         swap_variables(JOIN_TAB*, join->best_ref[idx], *pos);
       }
@@ -11746,6 +12153,9 @@ make_join_select(JOIN *join,SQL_SELECT *select,COND *cond)
 	  {
 	    /* Join with outer join condition */
 	    COND *orig_cond=sel->cond;
+            /* const_keys may also have the indexes for a skip scan */
+            key_map keys_to_use= tab->keys;
+            keys_to_use.merge(tab->const_keys);
 
             if (build_tmp_join_prefix_cond(join, tab, &sel->cond))
               return true;
@@ -11760,7 +12170,7 @@ make_join_select(JOIN *join,SQL_SELECT *select,COND *cond)
 	    if (sel->cond && !sel->cond->is_fixed())
 	      sel->cond->quick_fix_field();
 
-	    if (sel->test_quick_select(thd, tab->keys,
+	    if (sel->test_quick_select(thd, keys_to_use,
 				       ((used_tables & ~ current_map) |
                                         OUTER_REF_TABLE_BIT),
 				       (join->select_options &
@@ -11775,7 +12185,7 @@ make_join_select(JOIN *join,SQL_SELECT *select,COND *cond)
 	      */
               sel->cond=orig_cond;
               if (!*tab->on_expr_ref ||
-                  sel->test_quick_select(thd, tab->keys,
+                  sel->test_quick_select(thd, keys_to_use,
                                          used_tables & ~ current_map,
                                          (join->select_options &
                                           OPTION_FOUND_ROWS ?
@@ -13327,6 +13737,9 @@ make_join_readinfo(JOIN *join, ulonglong options, uint no_jbuf_after)
                  str.append(tab->table? tab->table->alias.c_ptr() :"<no_table_name>");
                  str.append(" final_pushdown_cond");
                  print_where(tab->select_cond, str.c_ptr_safe(), QT_ORDINARY););
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+    tab->partition_pruning= Partition_join_pruning::create(tab);
+#endif
   }
   uint n_top_tables= (uint)(join->join_tab_ranges.head()->end -  
                      join->join_tab_ranges.head()->start);
@@ -13498,6 +13911,10 @@ void JOIN_TAB::cleanup()
       table->file->ha_ft_end();
     else
       table->file->ha_index_or_rnd_end();
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+    if (partition_pruning)
+      partition_pruning->restore();
+#endif
     preread_init_done= FALSE;
     if (table->pos_in_table_list && 
         table->pos_in_table_list->jtbm_subselect)
@@ -13939,6 +14356,7 @@ void JOIN::cleanup(bool full)
             free_tmp_table(thd, curr_tab->table);
             delete curr_tab->tmp_table_param;
             curr_tab->tmp_table_param= NULL;
+            curr_tab->aggr->cleanup();
             curr_tab->aggr= NULL;
 
             delete curr_tab->filesort_result;
@@ -18708,9 +19126,12 @@ bool Create_tmp_table::finalize(THD *thd,
   DBUG_ASSERT(m_alloced_field_count >= share->fields);
   DBUG_ASSERT(m_alloced_field_count >= share->blob_fields);
 
-  /* If result table is small; use a heap */
+  /*
+    If result table is small; use a heap.
+    HEAP stores blobs, but can't have them in the distinct key.
+  */
   /* future: storage engine selection can be made dynamic? */
-  if (share->blob_fields || m_using_unique_constraint
+  if (m_blobs_count[distinct] || m_using_unique_constraint
       || (thd->variables.big_tables && !(m_select_options & SELECT_SMALL_RESULT))
       || (m_select_options & TMP_TABLE_FORCE_MYISAM)
       || thd->variables.tmp_memory_table_size == 0)
@@ -20028,6 +20449,7 @@ void set_postjoin_aggr_write_func(JOIN_TAB *tab)
 
   DBUG_ASSERT(table && aggr);
 
+  aggr->cleanup();
   if (table->group && tmp_tbl->sum_func_count && 
       !tmp_tbl->precomputed_group_by)
   {
@@ -20039,6 +20461,19 @@ void set_postjoin_aggr_write_func(JOIN_TAB *tab)
     {
       DBUG_PRINT("info",("Using end_update"));
       aggr->set_write_func(end_update);
+      /*
+        The hash table needs the group key in group_buff and can't store
+        blobs. If it can't be allocated end_update is used alone.
+      */
+      if (join->thd->variables.hash_aggr_buff_size && !table->s->blob_fields &&
+          (aggr->hash_aggr=
+             new Hash_aggregation(table, tmp_tbl->group_length, end_update,
+                                  (size_t) join->thd->
+                                  variables.hash_aggr_buff_size)))
+      {
+        DBUG_PRINT("info",("Using end_hash_update"));
+        aggr->set_write_func(end_hash_update);
+      }
     }
     else
     {
@@ -21595,8 +22030,235 @@ bool test_if_use_dynamic_range_scan(JOIN_TAB *join_tab)
     return (join_tab->use_quick == 2 && test_if_quick_select(join_tab) > 0);
 }
 
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+
+/*
+  Find the field of a previous table that a field of the partitioning
+  function is equal to in a condition attached to the table
+
+  RETURN
+    NULL   No such field
+    other  The field
+*/
+
+static Field *find_partition_field_value(Field *part_field, Item *cond)
+{
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    List_iterator_fast<Item> li(*((Item_cond*) cond)->argument_list());
+    Item *item;
+    Field *value;
+    while ((item= li++))
+    {
+      if ((value= find_partition_field_value(part_field, item)))
+        return value;
+    }
+    return NULL;
+  }
+  if (cond->type() != Item::FUNC_ITEM ||
+      ((Item_func*) cond)->functype() != Item_func::EQ_FUNC)
+    return NULL;
+
+  Item **args= ((Item_func*) cond)->arguments();
+  for (uint i= 0; i < 2; i++)
+  {
+    Item *item= args[i]->real_item();
+    Item *other= args[1 - i]->real_item();
+    if (item->type() == Item::FIELD_ITEM &&
+        ((Item_field*) item)->field == part_field &&
+        other->type() == Item::FIELD_ITEM)
+    {
+      Field *value= ((Item_field*) other)->field;
+      if (value->table != part_field->table && value->eq_def(part_field))
+        return value;
+    }
+  }
+  return NULL;
+}
+
+
+/*
+  Create the pruning of the partitions of a scanned table by the values of
+  the previous tables
+
+  RETURN
+    NULL   The partitions of the table cannot be pruned this way
+    other  The pruning object
+*/
+
+Partition_join_pruning *Partition_join_pruning::create(JOIN_TAB *tab)
+{
+  TABLE *table= tab->table;
+  partition_info *part_info= table->part_info;
+  THD *thd= tab->join->thd;
+  Partition_join_pruning *pruning;
+  my_bitmap_map *buf;
+  uint n_parts;
+
+  if (!part_info || !thd->variables.optimizer_join_partition_pruning ||
+      (tab->join->select_options & SELECT_DESCRIBE) ||
+      part_info->part_type == VERSIONING_PARTITION ||
+      (tab->type != JT_ALL && tab->type != JT_HASH) ||
+      tab->bush_children || tab->use_quick == 2 ||
+      (tab->select && tab->select->quick) || tab->filesort ||
+      !tab->select_cond ||
+      /* Rows of the table may be read again by position */
+      table->reginfo.lock_type > TL_READ_NO_INSERT)
+    return NULL;
+
+  if (!(pruning= new (thd->mem_root) Partition_join_pruning) ||
+      !(pruning->values= (Field**) thd->alloc(sizeof(Field*) *
+                                             part_info->num_part_fields)))
+    return NULL;
+
+  for (uint i= 0; i < part_info->num_part_fields; i++)
+  {
+    Field *part_field= part_info->part_field_array[i];
+    Field *value= find_partition_field_value(part_field, tab->select_cond);
+    if (!value && tab->type == JT_HASH)
+    {
+      /* The equalities used for the hash join key */
+      KEY *keyinfo= tab->get_keyinfo_by_key_no(tab->ref.key);
+      for (uint k= 0; k < tab->ref.key_parts && !value; k++)
+      {
+        Item *item= tab->ref.items[k]->real_item();
+        if (keyinfo->key_part[k].field == part_field &&
+            item->type() == Item::FIELD_ITEM &&
+            ((Item_field*) item)->field->table != table &&
+            ((Item_field*) item)->field->eq_def(part_field))
+          value= ((Item_field*) item)->field;
+      }
+    }
+    /*
+      The hash of KEY partitioning is not the same for values of floating
+      point fields that are equal, like 0 and -0
+    */
+    if (!value || value->result_type() == REAL_RESULT)
+      return NULL;
+    pruning->values[i]= value;
+  }
+
+  n_parts= part_info->read_partitions.n_bits;
+  if (!(buf= (my_bitmap_map*) thd->alloc(bitmap_buffer_size(n_parts) * 2)))
+    return NULL;
+  my_bitmap_init(&pruning->used_partitions, buf, n_parts, FALSE);
+  my_bitmap_init(&pruning->scan_partitions,
+                 buf + bitmap_buffer_size(n_parts) / sizeof(my_bitmap_map),
+                 n_parts, FALSE);
+  bitmap_copy(&pruning->used_partitions, &part_info->read_partitions);
+  pruning->used_count= bitmap_bits_set(&pruning->used_partitions);
+  pruning->table= table;
+  pruning->part_info= part_info;
+  pruning->scan_count= 0;
+  pruning->collected= FALSE;
+  return pruning;
+}
+
+
+void Partition_join_pruning::start_collecting()
+{
+  bitmap_clear_all(&scan_partitions);
+  scan_count= 0;
+  collected= TRUE;
+}
+
+
+/*
+  Add the partition of the current values of the previous tables to the
+  partitions collected for the next scan
+
+  RETURN
+    TRUE   All partitions left by the optimizer have been collected
+    FALSE  Otherwise
+*/
+
+bool Partition_join_pruning::add_current_values()
+{
+  uint32 part_id;
+  longlong func_value;
+  int error;
+
+  for (uint i= 0; i < part_info->num_part_fields; i++)
+  {
+    /* The equality cannot be true */
+    if (values[i]->is_null())
+      return FALSE;
+  }
+
+  MY_BITMAP *old_sets[2];
+  dbug_tmp_use_all_columns(table, old_sets, &table->read_set,
+                           &table->write_set);
+  for (uint i= 0; i < part_info->num_part_fields; i++)
+  {
+    Field *part_field= part_info->part_field_array[i];
+    part_field->set_notnull();
+    field_conv(part_field, values[i]);
+  }
+  if (part_info->is_sub_partitioned())
+    error= part_info->get_part_partition_id(part_info, &part_id, &func_value);
+  else
+    error= part_info->get_partition_id(part_info, &part_id, &func_value);
+  dbug_tmp_restore_column_maps(&table->read_set, &table->write_set, old_sets);
+  if (error)
+    return FALSE;                               // No partition for the values
+
+  uint n_subparts= part_info->is_sub_partitioned() ?
+                   part_info->num_subparts : 1;
+  for (uint i= part_id * n_subparts; i < (part_id + 1) * n_subparts; i++)
+  {
+    if (bitmap_is_set(&used_partitions, i) &&
+        !bitmap_fast_test_and_set(&scan_partitions, i))
+      scan_count++;
+  }
+  return scan_count == used_count;
+}
+
+
+/*
+  Set the partitions of the table for the next scan
+
+  DESCRIPTION
+    When no join buffer is used, the partition of the current partial join
+    record is taken. When the records of the join buffer have been collected
+    the partitions of these records are taken. Otherwise, and when the table
+    is not scanned in the order of the partitions, all partitions left by
+    the optimizer are scanned.
+*/
+
+void Partition_join_pruning::prepare_scan(JOIN_TAB *tab)
+{
+  bool prune= !(tab->select && tab->select->quick) && !tab->filesort &&
+              !tab->distinct;
+
+  if (prune && !tab->cache)
+  {
+    start_collecting();
+    add_current_values();
+  }
+  if (table->file->inited != handler::NONE)
+    table->file->ha_index_or_rnd_end();
+  bitmap_copy(&part_info->read_partitions,
+              prune && collected ? &scan_partitions : &used_partitions);
+  collected= FALSE;
+}
+
+
+void Partition_join_pruning::restore()
+{
+  bitmap_copy(&part_info->read_partitions, &used_partitions);
+  collected= FALSE;
+}
+
+#endif /* WITH_PARTITION_STORAGE_ENGINE */
+
+
 int join_init_read_record(JOIN_TAB *tab)
 {
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+  if (tab->partition_pruning)
+    tab->partition_pruning->prepare_scan(tab);
+#endif
   /* 
     Note: the query plan tree for the below operations is constructed in
     save_agg_explain_data.
@@ -22152,6 +22814,32 @@ end_write(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 }
 
 
+/**
+  Make a key of group index in TMP_TABLE_PARAM::group_buff
+*/
+
+static void make_group_key(TABLE *table)
+{
+  for (ORDER *group= table->group ; group ; group= group->next)
+  {
+    Item *item= *group->item;
+    if (group->fast_field_copier_setup != group->field)
+    {
+      DBUG_PRINT("info", ("new setup %p -> %p",
+                          group->fast_field_copier_setup,
+                          group->field));
+      group->fast_field_copier_setup= group->field;
+      group->fast_field_copier_func=
+        item->setup_fast_field_copier(group->field);
+    }
+    item->save_org_in_field(group->field, group->fast_field_copier_func);
+    /* Store in the used key if the field was 0 */
+    if (item->maybe_null)
+      group->buff[-1]= (char) group->field->is_null();
+  }
+}
+
+
 /*
   @brief
     Perform a GROUP BY operation over rows coming in arbitrary order. 
@@ -22168,7 +22856,6 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 	   bool end_of_records)
 {
   TABLE *const table= join_tab->table;
-  ORDER   *group;
   int	  error;
   DBUG_ENTER("end_update");
 
@@ -22177,24 +22864,7 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 
   join->found_records++;
   copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
-  /* Make a key of group index */
-  for (group=table->group ; group ; group=group->next)
-  {
-    Item *item= *group->item;
-    if (group->fast_field_copier_setup != group->field)
-    {
-      DBUG_PRINT("info", ("new setup %p -> %p",
-                          group->fast_field_copier_setup,
-                          group->field));
-      group->fast_field_copier_setup= group->field;
-      group->fast_field_copier_func=
-        item->setup_fast_field_copier(group->field);
-    }
-    item->save_org_in_field(group->field, group->fast_field_copier_func);
-    /* Store in the used key if the field was 0 */
-    if (item->maybe_null)
-      group->buff[-1]= (char) group->field->is_null();
-  }
+  make_group_key(table);
   if (!table->file->ha_index_read_map(table->record[1],
                                       join_tab->tmp_table_param->group_buff,
                                       HA_WHOLE_KEY,
@@ -22229,7 +22899,7 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
       DBUG_RETURN(NESTED_LOOP_ERROR);
     }
 
-    join_tab->aggr->set_write_func(end_unique_update);
+    join_tab->aggr->set_update_func(end_unique_update);
   }
   join_tab->send_records++;
 end:
@@ -22308,6 +22978,114 @@ end_unique_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 }
 
 
+/**
+  Write a group of Hash_aggregation into the tmp table
+
+  @note
+    The group is written through table->record[0]. If the HEAP table gets
+    full it is converted to an on-disk table, and the groups of the spilled
+    partitions are updated with end_unique_update from then on.
+*/
+
+static bool write_hash_group(JOIN_TAB *join_tab, const uchar *group)
+{
+  TABLE *const table= join_tab->table;
+  int error;
+
+  memcpy(table->record[0], group, table->s->reclength);
+  if (likely(!(error= table->file->ha_write_tmp_row(table->record[0]))))
+    return false;
+  if (create_internal_tmp_table_from_heap(join_tab->join->thd, table,
+                                          join_tab->tmp_table_param->start_recinfo,
+                                          &join_tab->tmp_table_param->recinfo,
+                                          error, 0, NULL))
+    return true;                                // Not a table_is_full error
+  if (unlikely((error= table->file->ha_index_init(0, 0))))
+  {
+    table->file->print_error(error, MYF(0));
+    return true;
+  }
+  join_tab->aggr->set_update_func(end_unique_update);
+  return false;
+}
+
+
+/*
+  @brief
+    Perform a GROUP BY operation over rows coming in arbitrary order in the
+    hash table of Hash_aggregation.
+
+  @detail
+    The records of the partitions that have been spilled are passed to
+    Hash_aggregation::update_func. The groups left in the hash table are
+    written into the temp table at the end of records.
+*/
+
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
+{
+  TABLE *const table= join_tab->table;
+  TMP_TABLE_PARAM *const param= join_tab->tmp_table_param;
+  Hash_aggregation *const hash_aggr= join_tab->aggr->hash_aggr;
+  uchar *group;
+  uint32 hash;
+  DBUG_ENTER("end_hash_update");
+
+  if (end_of_records)
+  {
+    if (hash_aggr->write_groups(join_tab))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    DBUG_RETURN((*hash_aggr->update_func)(join, join_tab, true));
+  }
+
+  copy_fields(param);				// Groups are copied twice.
+  make_group_key(table);
+  hash= hash_aggr->hash_key(param->group_buff);
+  if (hash_aggr->is_spilled(hash))
+  {
+    hash_aggr->tracker->r_spilled_rows++;
+    DBUG_RETURN((*hash_aggr->update_func)(join, join_tab, false));
+  }
+
+  if ((group= hash_aggr->find_group(param->group_buff, hash)))
+  {						/* Update old group */
+    memcpy(table->record[0], group, table->s->reclength);
+    update_tmptable_sum_func(join->sum_funcs, table);
+    memcpy(group, table->record[0], table->s->reclength);
+  }
+  else
+  {
+    bool spilled= false;
+    if (hash_aggr->make_room(join_tab, hash, &spilled))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    if (spilled)
+    {
+      /* Writing of the spilled groups has overwritten record[0] */
+      if (hash_aggr->is_spilled(hash))
+      {
+        hash_aggr->tracker->r_spilled_rows++;
+        DBUG_RETURN((*hash_aggr->update_func)(join, join_tab, false));
+      }
+      copy_fields(param);
+    }
+    init_tmptable_sum_functions(join->sum_funcs);
+    if (unlikely(copy_funcs(param->items_to_copy, join->thd)))
+      DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+    if (unlikely(!hash_aggr->add_group(param->group_buff, hash,
+                                       table->record[0])))
+      DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+    join_tab->send_records++;
+  }
+  join->found_records++;
+  hash_aggr->tracker->r_rows++;
+  if (unlikely(join->thd->check_killed()))
+  {
+    DBUG_RETURN(NESTED_LOOP_KILLED);             /* purecov: inspected */
+  }
+  DBUG_RETURN(NESTED_LOOP_OK);
+}
+
+
 /*
   @brief
     Perform a GROUP BY operation over a stream of rows ordered by their group.
@@ -24061,8 +24839,8 @@ JOIN_TAB::remove_duplicates()
     thd->reset_killed();
 
   table->file->info(HA_STATUS_VARIABLE);
-  if (table->s->db_type() == heap_hton ||
-      (!table->s->blob_fields &&
+  if (!table->s->blob_fields &&
+      (table->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(keylength) + HASH_OVERHEAD) * table->file->stats.records <
 	thd->variables.sortbuff_size)))
     error=remove_dup_with_hash_index(join->thd, table, field_count, first_field,
@@ -26490,6 +27268,8 @@ bool JOIN_TAB::save_explain_data(Explain_table_access *eta,
   // psergey-todo: data for filtering!
   tracker= &eta->tracker;
   jbuf_tracker= &eta->jbuf_tracker;
+  jbuf_spill_tracker= &eta->jbuf_spill_tracker;
+  jbuf_bloom_filter_tracker= &eta->jbuf_bloom_filter_tracker;
 
   /* Enable the table access time tracker only for "ANALYZE stmt" */
   if (thd->lex->analyze_stmt)
@@ -26564,6 +27344,10 @@ bool JOIN_TAB::save_explain_data(Explain_table_access *eta,
 #endif
   }
 
+  eta->concurrent_insert= (table->s->tmp_table == NO_TMP_TABLE &&
+                           (table->file->ha_table_flags() &
+                            HA_CONCURRENT_INSERT));
+
   /* "type" column */
   enum join_type tab_type= type;
   if ((type == JT_ALL || type == JT_HASH) &&
@@ -26840,6 +27624,8 @@ bool JOIN_TAB::save_explain_data(Explain_table_access *eta,
         eta->push_extra(ET_USING_INDEX_FOR_GROUP_BY);
         eta->loose_scan_is_scanning= qgs->loose_scan_is_scanning();
       }
+      else if (quick_type == QUICK_SELECT_I::QS_TYPE_SKIP_SCAN)
+        eta->push_extra(ET_USING_INDEX_FOR_SKIP_SCAN);
       else
         eta->push_extra(ET_USING_INDEX);
     }
@@ -26946,6 +27732,18 @@ bool save_agg_explain_data(JOIN *join, Explain_select *xpl_sel)
 
   for (uint i= 0; i < join->aggr_tables; i++, join_tab++)
   {
+    if (join_tab->aggr && join_tab->aggr->hash_aggr)
+    {
+      Explain_aggr_hash_aggregation *eah=
+        new (thd->mem_root) Explain_aggr_hash_aggregation;
+      if (!eah)
+        return 1;
+      join_tab->aggr->hash_aggr->save_explain_data(eah);
+      prev_node= node;
+      node= eah;
+      node->child= prev_node;
+    }
+
     // Each aggregate means a temp.table
     prev_node= node;
     if (!(node= new (thd->mem_root) Explain_aggr_tmp_table))
@@ -29005,6 +29803,285 @@ AGGR_OP::end_send()
 }
 
 
+/****************************************************************************
+  Hash_aggregation implementation
+****************************************************************************/
+
+/* Number of entries the hash table starts with */
+#define HASH_AGGR_MIN_ENTRIES 256
+
+Hash_aggregation::Hash_aggregation(TABLE *table_arg, uint key_length_arg,
+                                   Next_select_func update_func_arg,
+                                   size_t buffer_size_arg)
+  :update_func(update_func_arg), tracker(&own_tracker), table(table_arg),
+   buffer_size(buffer_size_arg), key_length(key_length_arg),
+   rec_length(table_arg->s->reclength), entries(NULL), capacity(0),
+   n_groups(0), spilled_partitions(0), allocated_groups(0), free_groups(NULL)
+{
+  group_length= ALIGN_SIZE(rec_length + key_length);
+  bzero(partition_groups, sizeof(partition_groups));
+  init_alloc_root(PSI_INSTRUMENT_ME, &groups_root,
+                  MY_MAX(8192, group_length * 16), 0,
+                  MYF(MY_THREAD_SPECIFIC));
+}
+
+
+Hash_aggregation::~Hash_aggregation()
+{
+  my_free(entries);
+  free_root(&groups_root, MYF(0));
+}
+
+
+/**
+  Get the hash value of a group key
+
+  The value of key_hashnr() is mixed so that the high bits, which select
+  the partition, depend on all the bits of the key.
+*/
+
+uint32 Hash_aggregation::hash_key(const uchar *key)
+{
+  ulonglong nr= key_hashnr(table->key_info,
+                           table->key_info->user_defined_key_parts, key);
+  uint32 hash= (uint32) (nr ^ (nr >> 32));
+  hash^= hash >> 16;
+  hash*= 0x85ebca6b;
+  hash^= hash >> 13;
+  hash*= 0xc2b2ae35;
+  hash^= hash >> 16;
+  return hash;
+}
+
+
+/**
+  Find the entry of the group with the key, or the empty entry where the
+  group should be inserted
+*/
+
+Hash_aggregation::Hash_entry *
+Hash_aggregation::find_entry(Hash_entry *entries_arg, uint capacity_arg,
+                             const uchar *key, uint32 hash)
+{
+  uint mask= capacity_arg - 1;
+  for (uint idx= hash & mask; ; idx= (idx + 1) & mask)
+  {
+    Hash_entry *entry= entries_arg + idx;
+    if (!entry->group ||
+        (entry->hash == hash &&
+         !key_buf_cmp(table->key_info, table->key_info->user_defined_key_parts,
+                      entry->group + rec_length, key)))
+      return entry;
+  }
+}
+
+
+/**
+  Get the tmp table record of the group with the key
+
+  @retval NULL  the group is not in the hash table
+*/
+
+uchar *Hash_aggregation::find_group(const uchar *key, uint32 hash)
+{
+  if (!n_groups)
+    return NULL;
+  return find_entry(entries, capacity, key, hash)->group;
+}
+
+
+/**
+  Rehash the groups into a new array of entries
+
+  @retval true  out of memory
+*/
+
+bool Hash_aggregation::rebuild(uint new_capacity)
+{
+  Hash_entry *new_entries;
+  if (!(new_entries= (Hash_entry*) my_malloc(PSI_INSTRUMENT_ME,
+                                             new_capacity * sizeof(Hash_entry),
+                                             MYF(MY_WME | MY_ZEROFILL |
+                                                 MY_THREAD_SPECIFIC))))
+    return true;
+  for (Hash_entry *entry= entries, *end= entries + capacity; entry < end;
+       entry++)
+  {
+    if (entry->group)
+      *find_entry(new_entries, new_capacity, entry->group + rec_length,
+                  entry->hash)= *entry;
+  }
+  my_free(entries);
+  entries= new_entries;
+  capacity= new_capacity;
+  return false;
+}
+
+
+/**
+  Write the groups of a partition into the tmp table and mark it spilled
+
+  @retval true  error
+*/
+
+bool Hash_aggregation::spill_partition(JOIN_TAB *tab, uint part)
+{
+  ha_rows spilled_groups= 0;
+  DBUG_ENTER("Hash_aggregation::spill_partition");
+  DBUG_PRINT("info", ("partition: %u  groups: %llu", part,
+                      (ulonglong) partition_groups[part]));
+
+  for (Hash_entry *entry= entries, *end= entries + capacity; entry < end;
+       entry++)
+  {
+    if (!entry->group || partition(entry->hash) != part)
+      continue;
+    if (write_hash_group(tab, entry->group))
+      DBUG_RETURN(true);
+    *(uchar**) entry->group= free_groups;
+    free_groups= entry->group;
+    entry->group= NULL;
+    spilled_groups++;
+  }
+  n_groups-= (uint) spilled_groups;
+  partition_groups[part]= 0;
+  spilled_partitions|= 1U << part;
+  tracker->r_spilled_partitions++;
+  tracker->r_spilled_groups+= spilled_groups;
+  /* The removed entries may have broken the probe sequences of others */
+  DBUG_RETURN(spilled_groups && rebuild(capacity));
+}
+
+
+/**
+  Make sure that a new group fits into the buffer
+
+  @param tab          the JOIN_TAB of the tmp table
+  @param hash         hash value of the new group
+  @param[out] spilled set to true if some partitions have been spilled
+
+  @details
+    While the new group doesn't fit, the partition with the most groups is
+    spilled. When no groups are left in memory, the partition of the new
+    group is spilled, the caller has to check it with is_spilled().
+
+  @retval true  error
+*/
+
+bool Hash_aggregation::make_room(JOIN_TAB *tab, uint32 hash, bool *spilled)
+{
+  for (;;)
+  {
+    uint new_capacity= capacity;
+    if (!capacity)
+      new_capacity= HASH_AGGR_MIN_ENTRIES;
+    else if ((n_groups + 1) * 4 > capacity * 3)
+      new_capacity= capacity * 2;
+    if (allocated_groups * group_length + new_capacity * sizeof(Hash_entry) +
+        (free_groups ? 0 : group_length) <= buffer_size)
+      return new_capacity != capacity && rebuild(new_capacity);
+
+    uint victim= partition(hash);
+    ha_rows max_groups= 0;
+    for (uint part= 0; part < PARTITIONS; part++)
+    {
+      if (partition_groups[part] > max_groups)
+      {
+        max_groups= partition_groups[part];
+        victim= part;
+      }
+    }
+    if (spill_partition(tab, victim))
+      return true;
+    *spilled= true;
+    if (victim == partition(hash))
+      return false;
+  }
+}
+
+
+/**
+  Add a new group to the hash table
+
+  @note make_room() must have been called for the group
+
+  @return the stored copy of the record, NULL if out of memory
+*/
+
+uchar *Hash_aggregation::add_group(const uchar *key, uint32 hash,
+                                   const uchar *record)
+{
+  uchar *group;
+  if ((group= free_groups))
+    free_groups= *(uchar**) group;
+  else
+  {
+    if (!(group= (uchar*) alloc_root(&groups_root, group_length)))
+      return NULL;
+    allocated_groups++;
+  }
+  memcpy(group, record, rec_length);
+  memcpy(group + rec_length, key, key_length);
+
+  Hash_entry *entry= find_entry(entries, capacity, key, hash);
+  DBUG_ASSERT(!entry->group);
+  entry->group= group;
+  entry->hash= hash;
+  n_groups++;
+  partition_groups[partition(hash)]++;
+  tracker->r_groups++;
+  return group;
+}
+
+
+/**
+  Write the groups left in the hash table into the tmp table
+
+  @retval true  error
+*/
+
+bool Hash_aggregation::write_groups(JOIN_TAB *tab)
+{
+  if (n_groups)
+  {
+    for (Hash_entry *entry= entries, *end= entries + capacity; entry < end;
+         entry++)
+    {
+      if (entry->group && write_hash_group(tab, entry->group))
+        return true;
+    }
+  }
+  tracker->r_loops++;
+  reset();
+  return false;
+}
+
+
+/**
+  Remove all groups, to start the aggregation anew
+*/
+
+void Hash_aggregation::reset()
+{
+  if (entries)
+    bzero(entries, capacity * sizeof(Hash_entry));
+  n_groups= 0;
+  bzero(partition_groups, sizeof(partition_groups));
+  spilled_partitions= 0;
+  free_root(&groups_root, MYF(MY_MARK_BLOCKS_FREE));
+  allocated_groups= 0;
+  free_groups= NULL;
+}
+
+
+void Hash_aggregation::save_explain_data(Explain_aggr_hash_aggregation *node)
+{
+  node->buffer_size= buffer_size;
+  node->partitions= PARTITIONS;
+  tracker= &node->tracker;
+}
+
+
 /**
   @brief
   Remove marked top conjuncts of a condition
@@ -243,6 +243,7 @@ class AGGR_OP;
 class Filesort;
 struct SplM_plan_info;
 class SplM_opt_info;
+class Partition_join_pruning;
 
 typedef struct st_join_table {
   TABLE		*table;
@@ -303,6 +304,8 @@ typedef struct st_join_table {
   Table_access_tracker *tracker;
 
   Table_access_tracker *jbuf_tracker;
+  Join_buffer_spill_tracker *jbuf_spill_tracker;
+  Join_buffer_bloom_filter_tracker *jbuf_bloom_filter_tracker;
   /* 
     Bitmap of TAB_INFO_* bits that encodes special line for EXPLAIN 'Extra'
     column, or 0 if there is no info.
@@ -523,6 +526,10 @@ typedef struct st_join_table {
   Rowid_filter *rowid_filter;
   /* Becomes true just after the used range filter has been built / filled */
   bool is_rowid_filter_built;
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+  /* Pruning of the partitions scanned by the values of the previous tables */
+  Partition_join_pruning *partition_pruning;
+#endif
 
   void build_range_rowid_filter_if_needed();
 
@@ -1019,6 +1026,87 @@ class JOIN_TAB_RANGE: public Sql_alloc
 
 class Pushdown_query;
 
+/**
+  @brief
+    In-memory hash table for GROUP BY over unsorted records
+
+  @details
+    The records of the groups of a grouping tmp table are kept in an open
+    addressing hash table, keyed by the group key built in
+    TMP_TABLE_PARAM::group_buff. A record of an existing group only updates
+    the sum functions of the stored record, the tmp table is not accessed
+    while the groups fit into hash_aggregation_buffer_size bytes.
+
+    The groups are split into partitions by their hash value. When the
+    buffer gets full, the groups of the largest partition are written into
+    the tmp table and the partition is marked as spilled: its further
+    records are aggregated in the tmp table by update_func. The groups that
+    are left in memory are written into the tmp table at the end.
+*/
+
+class Hash_aggregation :public Sql_alloc
+{
+public:
+  static const uint PARTITIONS= 16;
+
+  /* Aggregates the records of the spilled partitions in the tmp table */
+  Next_select_func update_func;
+  Hash_aggregation_tracker *tracker;
+
+  Hash_aggregation(TABLE *table_arg, uint key_length_arg,
+                   Next_select_func update_func_arg, size_t buffer_size_arg);
+  ~Hash_aggregation();
+
+  uint32 hash_key(const uchar *key);
+  bool is_spilled(uint32 hash) const
+  {
+    return spilled_partitions & (1U << partition(hash));
+  }
+  uchar *find_group(const uchar *key, uint32 hash);
+  bool make_room(JOIN_TAB *tab, uint32 hash, bool *spilled);
+  uchar *add_group(const uchar *key, uint32 hash, const uchar *record);
+  bool write_groups(JOIN_TAB *tab);
+  void reset();
+  void save_explain_data(Explain_aggr_hash_aggregation *node);
+
+private:
+  struct Hash_entry
+  {
+    uchar *group;                             // NULL for an empty entry
+    uint32 hash;
+  };
+
+  TABLE *table;
+  size_t buffer_size;
+  uint key_length;
+  uint rec_length;
+  /* A group is stored as the tmp table record followed by the group key */
+  uint group_length;
+
+  Hash_entry *entries;
+  uint capacity;                              // A power of 2
+  uint n_groups;
+  ha_rows partition_groups[PARTITIONS];
+  uint spilled_partitions;                    // Bitmap of partitions
+
+  MEM_ROOT groups_root;
+  size_t allocated_groups;
+  uchar *free_groups;                         // List of reusable groups
+
+  Hash_aggregation_tracker own_tracker;
+
+  static uint partition(uint32 hash) { return hash >> 28; }
+  size_t memory_used() const
+  {
+    return allocated_groups * group_length + capacity * sizeof(Hash_entry);
+  }
+  Hash_entry *find_entry(Hash_entry *entries_arg, uint capacity_arg,
+                         const uchar *key, uint32 hash);
+  bool rebuild(uint new_capacity);
+  bool spill_partition(JOIN_TAB *tab, uint part);
+};
+
+
 /**
   @brief
     Class to perform postjoin aggregation operations
@@ -1033,6 +1121,9 @@ class Pushdown_query;
                          table. Input records aren't expected to be sorted.
                          Tmp table uses the heap engine
       end_update_unique  Same as above, but the engine is myisam.
+      end_hash_update    Perform grouping in the hash table of hash_aggr,
+                         the groups are written into tmp table at the end
+                         or when a partition of them is spilled.
 
     Lazy table initialization is used - the table will be instantiated and
     rnd/index scan started on the first put_record() call.
@@ -1044,7 +1135,9 @@ class AGGR_OP :public Sql_alloc
 public:
   JOIN_TAB *join_tab;
 
-  AGGR_OP(JOIN_TAB *tab) : join_tab(tab), write_func(NULL)
+  Hash_aggregation *hash_aggr;
+
+  AGGR_OP(JOIN_TAB *tab) : join_tab(tab), hash_aggr(NULL), write_func(NULL)
   {};
 
   enum_nested_loop_state put_record() { return put_record(false); };
@@ -1060,6 +1153,22 @@ class AGGR_OP :public Sql_alloc
   {
     write_func= new_write_func;
   }
+  /*
+    Switch the function that updates the groups in tmp table. With hash
+    aggregation it is used only for the spilled partitions.
+  */
+  void set_update_func(Next_select_func new_update_func)
+  {
+    if (hash_aggr)
+      hash_aggr->update_func= new_update_func;
+    else
+      write_func= new_update_func;
+  }
+  void cleanup()
+  {
+    delete hash_aggr;
+    hash_aggr= NULL;
+  }
 
 private:
   /** Write function that would be used for saving records in tmp table. */
@@ -2363,7 +2472,91 @@ inline Item * or_items(THD *thd, Item* cond, Item *item)
 {
   return (cond ? (new (thd->mem_root) Item_cond_or(thd, cond, item)) : item);
 }
-bool choose_plan(JOIN *join, table_map join_tables);
+
+/*
+  The join order chosen for a select of a prepared statement or of a
+  statement of a stored routine. Non-prepared statements get a copy of
+  the entry of the digest plan cache (see sql_plan_cache.cc).
+
+  Later executions of the statement take the order instead of searching
+  for it again as long as:
+  - the tables have the same versions,
+  - no ANALYZE TABLE has been run (statistics_version),
+  - the same tables are constant,
+  - the optimizer settings are the same,
+  - the number of rows expected from each table after the range analysis
+    is in the same power of two class, so that the parameter values
+    select similar parts of the tables.
+*/
+
+class Join_plan_cache :public Sql_alloc
+{
+  ulonglong stats_version;
+  table_map const_tables;
+  /* The optimizer settings the join order was chosen with */
+  ulonglong optimizer_switch;
+  ulong search_depth, prune_level, join_dp_limit;
+  ulong use_cond_selectivity, join_cache_level;
+  uint table_count;
+  /* tablenr of the non-constant tables in the join order */
+  uint *order;
+  /* The guards of the tables, indexed by tablenr */
+  ulonglong *table_versions;
+  uchar *record_classes;
+  bool valid;
+  /* save() has been called since create() or copy() */
+  bool saved;
+public:
+  static Join_plan_cache *create(MEM_ROOT *mem_root, uint table_count);
+  bool copy(const Join_plan_cache *from);
+  bool is_saved() const { return saved; }
+  bool is_usable(JOIN *join);
+  void use(JOIN *join);
+  void save(JOIN *join);
+};
+
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+/*
+  Pruning of the partitions of a table scanned in a join by the values of
+  the previous tables.
+
+  prune_partitions() only uses the conditions that are known when the plan
+  is chosen. If the condition attached to the scanned table contains an
+  equality between each field of the partitioning function and a field of
+  a previous table with the same definition, only the partitions these
+  values fall into can have matching rows. Before each scan the partitions
+  of the table are narrowed to the partition of the current partial join
+  record, or, when a join buffer is used, to the partitions of all the
+  records in the buffer.
+
+  Index lookups into the table are not handled here: ha_partition already
+  finds the partitions from the key values of each lookup.
+*/
+
+class Partition_join_pruning :public Sql_alloc
+{
+  TABLE *table;
+  partition_info *part_info;
+  /* values[i] is the field equal to part_info->part_field_array[i] */
+  Field **values;
+  /* The partitions left by prune_partitions() */
+  MY_BITMAP used_partitions;
+  /* The partitions collected for the next scan */
+  MY_BITMAP scan_partitions;
+  uint used_count, scan_count;
+  /* scan_partitions has been collected since the last scan */
+  bool collected;
+public:
+  static Partition_join_pruning *create(JOIN_TAB *tab);
+  void start_collecting();
+  bool add_current_values();
+  void prepare_scan(JOIN_TAB *tab);
+  void restore();
+};
+#endif
+
+bool choose_plan(JOIN *join, table_map join_tables,
+                 Join_plan_cache *plan_cache= NULL);
 void optimize_wo_join_buffering(JOIN *join, uint first_tab, uint last_tab, 
                                 table_map last_remaining_tables, 
                                 bool first_alt, uint no_jbuf_before,
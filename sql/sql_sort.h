@@ -547,6 +547,7 @@ class Sort_param {
   uint addon_length;          // Length of addon_fields
   uint res_length;            // Length of records in final sorted file/buffer.
   uint max_keys_per_buffer;   // Max keys / buffer.
+  uint sort_threads;          // Number of threads to sort a buffer with.
   uint min_dupl_count;
   ha_rows max_rows;           // Select limit, or HA_POS_ERROR if unlimited.
   ha_rows examined_rows;      // Number of examined rows.
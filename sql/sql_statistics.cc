@@ -32,6 +32,9 @@
 #include "uniques.h"
 #include "sql_show.h"
 #include "sql_partition.h"
+#include "my_json_writer.h"
+#include "json_lib.h"
+#include "strfunc.h"
 
 /*
   The system variable 'use_stat_tables' can take one of the
@@ -59,8 +62,8 @@
   equal to "never".
 */ 
    
-/* Currently there are only 3 persistent statistical tables */
-static const uint STATISTICS_TABLES= 3;
+/* Currently there are only 4 persistent statistical tables */
+static const uint STATISTICS_TABLES= 4;
 
 /* 
   The names of the statistical tables in this array must correspond the
@@ -70,9 +73,13 @@ static const LEX_CSTRING stat_table_name[STATISTICS_TABLES]=
 {
   { STRING_WITH_LEN("table_stats") },
   { STRING_WITH_LEN("column_stats") },
-  { STRING_WITH_LEN("index_stats") }
+  { STRING_WITH_LEN("index_stats") },
+  { STRING_WITH_LEN("column_group_stats") }
 };
 
+/* Incremented by every ANALYZE TABLE */
+Atomic_counter<ulonglong> statistics_version;
+
 
 /**
   @details
@@ -178,12 +185,12 @@ TABLE_FIELD_TYPE column_stat_fields[COLUMN_STAT_N_FIELDS] =
   },
   {
     { STRING_WITH_LEN("hist_type") },
-    { STRING_WITH_LEN("enum('SINGLE_PREC_HB','DOUBLE_PREC_HB')") },
+    { STRING_WITH_LEN("enum('SINGLE_PREC_HB','DOUBLE_PREC_HB','JSON_HB')") },
     { STRING_WITH_LEN("utf8") }
   },
   {
     { STRING_WITH_LEN("histogram") },
-    { STRING_WITH_LEN("varbinary(255)") },
+    { STRING_WITH_LEN("longblob") },
     { NULL, 0 }
   }
 };
@@ -224,6 +231,40 @@ static const uint index_stat_pk_col[]= {0,1,2,3};
 static const TABLE_FIELD_DEF
 index_stat_def= {INDEX_STAT_N_FIELDS, index_stat_fields, 4, index_stat_pk_col};
 
+static const
+TABLE_FIELD_TYPE column_group_stat_fields[COLUMN_GROUP_STAT_N_FIELDS] =
+{
+  {
+    { STRING_WITH_LEN("db_name") },
+    { STRING_WITH_LEN("varchar(64)") },
+    { STRING_WITH_LEN("utf8") }
+  },
+  {
+    { STRING_WITH_LEN("table_name") },
+    { STRING_WITH_LEN("varchar(64)") },
+    { STRING_WITH_LEN("utf8") }
+  },
+  {
+    { STRING_WITH_LEN("column_names") },
+    { STRING_WITH_LEN("varchar(255)") },
+    { STRING_WITH_LEN("utf8") }
+  },
+  {
+    { STRING_WITH_LEN("avg_frequency") },
+    { STRING_WITH_LEN("decimal(12,4)") },
+    { NULL, 0 }
+  },
+  {
+    { STRING_WITH_LEN("dependency_degree") },
+    { STRING_WITH_LEN("decimal(12,4)") },
+    { NULL, 0 }
+  }
+};
+static const uint column_group_stat_pk_col[]= {0,1,2};
+static const TABLE_FIELD_DEF
+column_group_stat_def= {COLUMN_GROUP_STAT_N_FIELDS, column_group_stat_fields,
+                        3, column_group_stat_pk_col};
+
 
 /**
   @brief
@@ -246,12 +287,14 @@ static int open_stat_tables(THD *thd, TABLE_LIST *tables, bool for_write)
 
 
   /* If the number of tables changes, we should revise the check below. */
-  compile_time_assert(STATISTICS_TABLES == 3);
+  compile_time_assert(STATISTICS_TABLES == 4);
 
   if (!rc &&
       (stat_table_intact.check(tables[TABLE_STAT].table, &table_stat_def) ||
        stat_table_intact.check(tables[COLUMN_STAT].table, &column_stat_def) ||
-       stat_table_intact.check(tables[INDEX_STAT].table, &index_stat_def)))
+       stat_table_intact.check(tables[INDEX_STAT].table, &index_stat_def) ||
+       stat_table_intact.check(tables[COLUMN_GROUP_STAT].table,
+                               &column_group_stat_def)))
   {
     close_thread_tables(thd);
     rc= 1;
@@ -305,13 +348,89 @@ class Column_statistics_collected :public Column_statistics
 
 public:
 
-  inline void init(THD *thd, Field * table_field);
+  inline void init(THD *thd, Field * table_field, uint hll_precision);
   inline bool add();
   inline void finish(ha_rows rows, double sample_fraction);
   inline void cleanup();
 };
 
 
+C_MODE_START
+
+static int column_group_key_cmp(void *arg, uchar *key1, uchar *key2)
+{
+  return memcmp(key1, key2, *(uint *) arg);
+}
+
+C_MODE_END
+
+
+/*
+  The class Column_group_statistics_collected is a helper class used to
+  collect statistics on a group of columns. For every row without NULLs
+  in the columns of the group a key is built from the sort strings of the
+  values of the columns in the order of the group. The distinct keys are
+  counted in a Unique object. As the keys are sorted by the values of all
+  the columns but the last one first, the walk over them in order visits
+  the rows with the same values of these columns together, which allows
+  to find the share of the rows in which they determine the value of the
+  last column.
+*/
+
+class Column_group_statistics_collected :public Column_group_statistics
+{
+
+private:
+  TABLE *table;          /* The table of the group */
+  Unique *tree;          /* The container of the distinct keys */
+  uchar *key;            /* The key built for the current row */
+  uint key_length;       /* The length of the keys */
+  uint prefix_length;    /* The length of the keys without the last column */
+  ha_rows rows;          /* The number of the rows without NULLs */
+
+  /* The state of the walk over the distinct keys */
+  uchar *prev_key;
+  ulonglong distincts;
+  ulonglong distincts_single_occurence;
+  ulonglong prefix_rows;       /* Rows with the prefix of prev_key */
+  ulonglong prefix_distincts;  /* Distinct keys with the prefix of prev_key */
+  ulonglong determined_rows;   /* Rows of the prefixes with one key */
+
+  static int walk_action(void *elem, element_count count, void *arg)
+  {
+    return ((Column_group_statistics_collected *) arg)->
+             add_distinct((uchar *) elem, count);
+  }
+
+  int add_distinct(uchar *elem, element_count count)
+  {
+    if (distincts && memcmp(elem, prev_key, prefix_length))
+      end_prefix();
+    memcpy(prev_key, elem, key_length);
+    distincts++;
+    if (count == 1)
+      distincts_single_occurence++;
+    prefix_rows+= count;
+    prefix_distincts++;
+    return 0;
+  }
+
+  void end_prefix()
+  {
+    if (prefix_distincts == 1)
+      determined_rows+= prefix_rows;
+    prefix_rows= prefix_distincts= 0;
+  }
+
+public:
+
+  inline bool init(THD *thd, TABLE *tab);
+  inline bool add();
+  inline void finish(double sample_fraction);
+  inline void cleanup();
+};
+
+
 /**
   Stat_table is the base class for classes Table_stat, Column_stat and
   Index_stat. The methods of these classes allow us to read statistical
@@ -428,6 +547,10 @@ class Stat_table
   uchar *record[2];     /* Record buffers used to access/update stat_table */
   uint stat_key_idx;    /* The number of the key to access stat_table */
 
+  /* The key prefix for reading with first/next_stat_for_prefix() */
+  uchar prefix_key[MAX_KEY_LENGTH];
+  uint prefix_key_length;
+
   /* This is a helper function used only by the Stat_table constructors */
   void common_init_stat_table()
   {
@@ -611,6 +734,48 @@ class Stat_table
     return !stat_file->ha_index_read_idx_map(record[0], stat_key_idx, key,
                                              prefix_map, HA_READ_KEY_EXACT);
   }
+
+
+  /**
+    @brief
+    Find the first record in the statistical table with a key prefix value
+
+    @details
+    The function starts an index scan over the records of stat_table
+    whose 'prefix_parts' major components of the primary key are equal to
+    the values stored in the record buffer of stat_table. The following
+    records are read with next_stat_for_prefix(). The scan must be ended
+    with end_stat_for_prefix().
+
+    @retval
+    FALSE    no record is found
+    @retval
+    TRUE     the record is found
+  */
+
+  bool first_stat_for_prefix(uint prefix_parts)
+  {
+    prefix_key_length= 0;
+    for (uint i= 0; i < prefix_parts; i++)
+      prefix_key_length+= stat_key_info->key_part[i].store_length;
+    key_copy(prefix_key, record[0], stat_key_info, prefix_key_length);
+    key_part_map prefix_map= (key_part_map) ((1 << prefix_parts) - 1);
+    if (stat_file->ha_index_init(stat_key_idx, FALSE))
+      return FALSE;
+    return !stat_file->ha_index_read_map(record[0], prefix_key, prefix_map,
+                                         HA_READ_KEY_EXACT);
+  }
+
+  bool next_stat_for_prefix()
+  {
+    return !stat_file->ha_index_next_same(record[0], prefix_key,
+                                          prefix_key_length);
+  }
+
+  void end_stat_for_prefix()
+  {
+    stat_file->ha_index_or_rnd_end();
+  }
    
 
   /**
@@ -1070,8 +1235,13 @@ class Column_stat: public Stat_table
           stat_field->store(table_field->collected_stats->get_avg_frequency());
           break; 
         case COLUMN_STAT_HIST_SIZE:
-          stat_field->store(table_field->collected_stats->histogram.get_size());
+        {
+          /* The number of buckets for JSON_HB, of bytes for the others */
+          Histogram *hist= &table_field->collected_stats->histogram;
+          stat_field->store(hist->get_type() == JSON_HB ?
+                            hist->get_width() : hist->get_size());
           break;
+        }
         case COLUMN_STAT_HIST_TYPE:
           stat_field->store(table_field->collected_stats->histogram.get_type() +
                             1);
@@ -1164,7 +1334,16 @@ class Column_stat: public Stat_table
           case COLUMN_STAT_HIST_TYPE:
             Histogram_type hist_type= (Histogram_type) (stat_field->val_int() -
                                                         1);
-            table_field->read_stats->histogram.set_type(hist_type);
+            Histogram *hist= &table_field->read_stats->histogram;
+            hist->set_type(hist_type);
+            if (hist_type == JSON_HB)
+            {
+              /* hist_size is the number of buckets, take the JSON length */
+              Field *hist_field= stat_table->field[COLUMN_STAT_HISTOGRAM];
+              hist->set_width((uint) hist->get_size());
+              hist->set_size(hist_field->is_null() ? 0 :
+                             hist_field->val_str(&val)->length());
+            }
             break;            
           }
         }
@@ -1406,163 +1585,456 @@ class Index_stat: public Stat_table
 
 
 /*
-  An iterator to enumerate statistics table rows which allows to modify
-  the rows while reading them.
+  The separator of the column names in column_group_stats.column_names
+*/
+static const char column_group_separator= ',';
 
-  Used by RENAME TABLE handling to assign new dbname.tablename to statistic
-  rows.
+
+/**
+  @brief
+  Build the value of column_group_stats.column_names for a column group
+
+  @details
+  The names of the columns of 'group' from 'table_share' are joined in
+  the order of the group with column_group_separator between them.
 */
-class Stat_table_write_iter
-{
-  Stat_table *owner;
-  IO_CACHE io_cache;
-  uchar *rowid_buf;
-  uint rowid_size;
 
-public:
-  Stat_table_write_iter(Stat_table *stat_table_arg)
-   : owner(stat_table_arg), rowid_buf(NULL),
-     rowid_size(owner->stat_file->ref_length)
+static void column_group_names(TABLE_SHARE *table_share,
+                               Column_group_statistics *group, String *names)
+{
+  names->length(0);
+  for (uint i= 0; i < group->columns; i++)
   {
-     my_b_clear(&io_cache);
+    Field *field= table_share->field[group->fieldnr[i]];
+    if (i)
+      names->append(column_group_separator);
+    names->append(field->field_name.str, field->field_name.length);
   }
+}
 
-  /*
-    Initialize the iterator. It will return rows with n_keyparts matching the
-    curernt values.
 
-    @return  false - OK
-             true  - Error
-  */
-  bool init(uint n_keyparts)
-  {
-    if (!(rowid_buf= (uchar*)my_malloc(PSI_INSTRUMENT_ME, rowid_size, MYF(0))))
-      return true;
+/**
+  @brief
+  Create a column group from the value of column_group_stats.column_names
 
-    if (open_cached_file(&io_cache, mysql_tmpdir, TEMP_PREFIX,
-                         1024, MYF(MY_WME)))
-      return true;
+  @param
+  mem_root     The memory to allocate the group in
+  @param
+  table_share  The table of the group
+  @param
+  names        The names of the columns of the group
 
-    handler *h= owner->stat_file;
-    uchar key[MAX_KEY_LENGTH];
-    uint prefix_len= 0;
-    for (uint i= 0; i < n_keyparts; i++)
-      prefix_len += owner->stat_key_info->key_part[i].store_length;
+  @details
+  The statistical values of the created group are set as unknown.
 
-    key_copy(key, owner->record[0], owner->stat_key_info,
-             prefix_len);
-    key_part_map prefix_map= (key_part_map) ((1 << n_keyparts) - 1);
-    h->ha_index_init(owner->stat_key_idx, false);
-    int res= h->ha_index_read_map(owner->record[0], key, prefix_map,
-                                  HA_READ_KEY_EXACT);
-    if (res)
+  @retval
+  The group, or NULL if a column is not found in the table, a column is
+  used twice, the group has less than two columns or memory cannot be
+  allocated
+*/
+
+static Column_group_statistics *
+create_column_group(MEM_ROOT *mem_root, TABLE_SHARE *table_share,
+                    const LEX_CSTRING *names)
+{
+  const char *pos= names->str, *end= names->str + names->length;
+  uint columns= 1;
+  for (const char *c= pos; c < end; c++)
+  {
+    if (*c == column_group_separator)
+      columns++;
+  }
+  if (columns < 2)
+    return NULL;
+
+  Column_group_statistics *group;
+  uint *fieldnr;
+  if (!multi_alloc_root(mem_root, &group, sizeof(Column_group_statistics),
+                        &fieldnr, sizeof(uint) * columns, NullS))
+    return NULL;
+
+  for (uint i= 0; i < columns; i++)
+  {
+    const char *name_end= (const char *) memchr(pos, column_group_separator,
+                                                end - pos);
+    if (!name_end)
+      name_end= end;
+    int field_pos;
+    if (table_share->fieldnames.type_names == 0 ||
+        (field_pos= find_type(&table_share->fieldnames, pos, name_end - pos,
+                              FALSE)) <= 0)
+      return NULL;
+    fieldnr[i]= field_pos - 1;
+    for (uint j= 0; j < i; j++)
     {
-      reinit_io_cache(&io_cache, READ_CACHE, 0L, 0, 0);
-      /* "Key not found" is not considered an error */
-      return (res == HA_ERR_KEY_NOT_FOUND)? false: true;
+      if (fieldnr[j] == fieldnr[i])
+        return NULL;
     }
+    pos= name_end + 1;
+  }
 
-    do {
-      h->position(owner->record[0]);
-      my_b_write(&io_cache, h->ref, rowid_size);
-
-    } while (!h->ha_index_next_same(owner->record[0], key, prefix_len));
+  group->columns= columns;
+  group->fieldnr= fieldnr;
+  group->avg_frequency= 0;
+  group->dependency_degree= -1;
+  group->next= NULL;
+  return group;
+}
 
-    /* Prepare for reading */
-    reinit_io_cache(&io_cache, READ_CACHE, 0L, 0, 0);
-    h->ha_index_or_rnd_end();
-    if (h->ha_rnd_init(false))
-      return true;
 
-    return false;
-  }
+/*
+  An object of the class Column_group_stat is created to read statistical
+  data on groups of columns from the statistical table column_group_stats,
+  to update column_group_stats with such statistical data, or to update
+  columns of the primary key, or to delete the records by a prefix of their
+  primary key.
+  The statistics on all column groups of a table are read by the prefix
+  (db_name, table_name) of the primary key, the statistics on one group is
+  updated by the primary key.
+*/
 
-  /*
-     Read the next row.
+class Column_group_stat: public Stat_table
+{
 
-     @return
-        false   OK
-        true    No more rows or error.
-  */
-  bool get_next_row()
-  {
-    if (!my_b_inited(&io_cache) || my_b_read(&io_cache, rowid_buf, rowid_size))
-      return true; /* No more data */
+private:
 
-    handler *h= owner->stat_file;
-    /*
-      We should normally be able to find the row that we have rowid for. If we
-      don't, let's consider this an error.
-    */
-    int res= h->ha_rnd_pos(owner->record[0], rowid_buf);
+  Field *db_name_field;      /* Field for column_group_stats.db_name */
+  Field *table_name_field;   /* Field for column_group_stats.table_name */
+  Field *column_names_field; /* Field for column_group_stats.column_names */
 
-    return (res==0)? false : true;
-  }
+  /* Column group to read/update statistics on */
+  Column_group_statistics *group;
 
-  void cleanup()
+  void common_init_column_group_stat_table()
   {
-    if (rowid_buf)
-      my_free(rowid_buf);
-    rowid_buf= NULL;
-    owner->stat_file->ha_index_or_rnd_end();
-    close_cached_file(&io_cache);
-    my_b_clear(&io_cache);
+    db_name_field= stat_table->field[COLUMN_GROUP_STAT_DB_NAME];
+    table_name_field= stat_table->field[COLUMN_GROUP_STAT_TABLE_NAME];
+    column_names_field= stat_table->field[COLUMN_GROUP_STAT_COLUMN_NAMES];
   }
 
-  ~Stat_table_write_iter()
+  void change_full_table_name(const LEX_CSTRING *db, const LEX_CSTRING *tab)
   {
-    /* Ensure that cleanup has been run */
-    DBUG_ASSERT(rowid_buf == 0);
+     db_name_field->store(db->str, db->length, system_charset_info);
+     table_name_field->store(tab->str, tab->length, system_charset_info);
   }
-};
 
-/*
-  Histogram_builder is a helper class that is used to build histograms
-  for columns
-*/
+public:
 
-class Histogram_builder
-{
-  Field *column;           /* table field for which the histogram is built */
-  uint col_length;         /* size of this field                           */
-  ha_rows records;         /* number of records the histogram is built for */
-  Field *min_value;        /* pointer to the minimal value for the field   */
-  Field *max_value;        /* pointer to the maximal value for the field   */
-  Histogram *histogram;    /* the histogram location                       */
-  uint hist_width;         /* the number of points in the histogram        */
-  double bucket_capacity;  /* number of rows in a bucket of the histogram  */ 
-  uint curr_bucket;        /* number of the current bucket to be built     */
-  ulonglong count;         /* number of values retrieved                   */
-  ulonglong count_distinct;    /* number of distinct values retrieved      */
-  /* number of distinct values that occured only once  */
-  ulonglong count_distinct_single_occurence;
+  /**
+    @details
+    The constructor 'tunes' the private and protected members of the
+    constructed object for the statistical table column_group_stats to
+    read/update statistics on column groups of the table 'tab'.
+  */
 
-public: 
-  Histogram_builder(Field *col, uint col_len, ha_rows rows)
-    : column(col), col_length(col_len), records(rows)
+  Column_group_stat(TABLE *stat, TABLE *tab) :Stat_table(stat, tab)
   {
-    Column_statistics *col_stats= col->collected_stats;
-    min_value= col_stats->min_value;
-    max_value= col_stats->max_value;
-    histogram= &col_stats->histogram;
-    hist_width= histogram->get_width();
-    bucket_capacity= (double) records / (hist_width + 1);
-    curr_bucket= 0;
-    count= 0;
-    count_distinct= 0;
-    count_distinct_single_occurence= 0;
+    common_init_column_group_stat_table();
   }
 
-  ulonglong get_count_distinct() const { return count_distinct; }
-  ulonglong get_count_single_occurence() const
+
+  /**
+    @details
+    The constructor 'tunes' the private and protected members of the
+    object constructed for the statistical table column_group_stats for
+    the future updates/deletes of the records concerning the table 'tab'
+    from the database 'db'.
+  */
+
+  Column_group_stat(TABLE *stat, const LEX_CSTRING *db, const LEX_CSTRING *tab)
+    :Stat_table(stat, db, tab)
   {
-    return count_distinct_single_occurence;
+    common_init_column_group_stat_table();
   }
 
-  int next(void *elem, element_count elem_cnt)
-  {
-    count_distinct++;
-    if (elem_cnt == 1)
+
+  /**
+    @brief
+    Set table name fields for the statistical table column_group_stats
+  */
+
+  void set_full_table_name()
+  {
+    db_name_field->store(db_name->str, db_name->length, system_charset_info);
+    table_name_field->store(table_name->str, table_name->length,
+                            system_charset_info);
+  }
+
+
+  /**
+    @brief
+    Set the key fields for the statistical table column_group_stats
+
+    @param
+    grp       The column group of 'table' to read/update statistics on
+
+    @details
+    The function stores the values of the fields db_name, table_name and
+    column_names in the record buffer for the statistical table
+    column_group_stats. It also sets group to the passed parameter.
+  */
+
+  void set_key_fields(Column_group_statistics *grp)
+  {
+    StringBuffer<NAME_LEN> names(system_charset_info);
+    set_full_table_name();
+    column_group_names(table_share, grp, &names);
+    column_names_field->store(names.ptr(), names.length(),
+                              system_charset_info);
+    group= grp;
+  }
+
+
+  /**
+    @brief
+    Set the column group to read statistics on from the current record
+  */
+
+  void set_group(Column_group_statistics *grp) { group= grp; }
+
+
+  /**
+    @brief
+    Get the value of the column column_names from the current record
+  */
+
+  void get_column_names(String *names)
+  {
+    column_names_field->val_str(names);
+  }
+
+
+  /**
+    @brief
+    Replace the column names of the current record of column_group_stats
+
+    @retval
+    FALSE    success with the update of the record
+    @retval
+    TRUE     failure with the update of the record
+  */
+
+  bool update_column_names(const String *names)
+  {
+    store_record_for_update();
+    column_names_field->store(names->ptr(), names->length(),
+                              system_charset_info);
+    bool rc= update_record();
+    store_record_for_lookup();
+    return rc;
+  }
+
+
+  /**
+    @brief
+    Store statistical data into statistical fields of column_group_stats
+
+    @details
+    The unknown values of avg_frequency and dependency_degree of the
+    collected statistics on the group are stored as NULLs.
+  */
+
+  void store_stat_fields()
+  {
+    Field *stat_field= stat_table->field[COLUMN_GROUP_STAT_AVG_FREQUENCY];
+    if (group->avg_frequency == 0)
+      stat_field->set_null();
+    else
+    {
+      stat_field->set_notnull();
+      stat_field->store(group->avg_frequency);
+    }
+    stat_field= stat_table->field[COLUMN_GROUP_STAT_DEPENDENCY_DEGREE];
+    if (group->dependency_degree < 0)
+      stat_field->set_null();
+    else
+    {
+      stat_field->set_notnull();
+      stat_field->store(group->dependency_degree);
+    }
+  }
+
+
+  /**
+    @brief
+    Read statistical data from statistical fields of column_group_stats
+
+    @details
+    Unlike the other statistical tables the rows of column_group_stats
+    are read by the prefix of the primary key. This implementation of the
+    purely virtual method reads the statistics on the group from the
+    current record of the table. NULL values are read as unknown ones.
+  */
+
+  void get_stat_values()
+  {
+    Field *stat_field= stat_table->field[COLUMN_GROUP_STAT_AVG_FREQUENCY];
+    group->avg_frequency= stat_field->is_null() ? 0 : stat_field->val_real();
+    stat_field= stat_table->field[COLUMN_GROUP_STAT_DEPENDENCY_DEGREE];
+    group->dependency_degree=
+      stat_field->is_null() ? -1 : stat_field->val_real();
+  }
+};
+
+
+/*
+  An iterator to enumerate statistics table rows which allows to modify
+  the rows while reading them.
+
+  Used by RENAME TABLE handling to assign new dbname.tablename to statistic
+  rows.
+*/
+class Stat_table_write_iter
+{
+  Stat_table *owner;
+  IO_CACHE io_cache;
+  uchar *rowid_buf;
+  uint rowid_size;
+
+public:
+  Stat_table_write_iter(Stat_table *stat_table_arg)
+   : owner(stat_table_arg), rowid_buf(NULL),
+     rowid_size(owner->stat_file->ref_length)
+  {
+     my_b_clear(&io_cache);
+  }
+
+  /*
+    Initialize the iterator. It will return rows with n_keyparts matching the
+    curernt values.
+
+    @return  false - OK
+             true  - Error
+  */
+  bool init(uint n_keyparts)
+  {
+    if (!(rowid_buf= (uchar*)my_malloc(PSI_INSTRUMENT_ME, rowid_size, MYF(0))))
+      return true;
+
+    if (open_cached_file(&io_cache, mysql_tmpdir, TEMP_PREFIX,
+                         1024, MYF(MY_WME)))
+      return true;
+
+    handler *h= owner->stat_file;
+    uchar key[MAX_KEY_LENGTH];
+    uint prefix_len= 0;
+    for (uint i= 0; i < n_keyparts; i++)
+      prefix_len += owner->stat_key_info->key_part[i].store_length;
+
+    key_copy(key, owner->record[0], owner->stat_key_info,
+             prefix_len);
+    key_part_map prefix_map= (key_part_map) ((1 << n_keyparts) - 1);
+    h->ha_index_init(owner->stat_key_idx, false);
+    int res= h->ha_index_read_map(owner->record[0], key, prefix_map,
+                                  HA_READ_KEY_EXACT);
+    if (res)
+    {
+      reinit_io_cache(&io_cache, READ_CACHE, 0L, 0, 0);
+      /* "Key not found" is not considered an error */
+      return (res == HA_ERR_KEY_NOT_FOUND)? false: true;
+    }
+
+    do {
+      h->position(owner->record[0]);
+      my_b_write(&io_cache, h->ref, rowid_size);
+
+    } while (!h->ha_index_next_same(owner->record[0], key, prefix_len));
+
+    /* Prepare for reading */
+    reinit_io_cache(&io_cache, READ_CACHE, 0L, 0, 0);
+    h->ha_index_or_rnd_end();
+    if (h->ha_rnd_init(false))
+      return true;
+
+    return false;
+  }
+
+  /*
+     Read the next row.
+
+     @return
+        false   OK
+        true    No more rows or error.
+  */
+  bool get_next_row()
+  {
+    if (!my_b_inited(&io_cache) || my_b_read(&io_cache, rowid_buf, rowid_size))
+      return true; /* No more data */
+
+    handler *h= owner->stat_file;
+    /*
+      We should normally be able to find the row that we have rowid for. If we
+      don't, let's consider this an error.
+    */
+    int res= h->ha_rnd_pos(owner->record[0], rowid_buf);
+
+    return (res==0)? false : true;
+  }
+
+  void cleanup()
+  {
+    if (rowid_buf)
+      my_free(rowid_buf);
+    rowid_buf= NULL;
+    owner->stat_file->ha_index_or_rnd_end();
+    close_cached_file(&io_cache);
+    my_b_clear(&io_cache);
+  }
+
+  ~Stat_table_write_iter()
+  {
+    /* Ensure that cleanup has been run */
+    DBUG_ASSERT(rowid_buf == 0);
+  }
+};
+
+/*
+  Histogram_builder is a helper class that is used to build histograms
+  for columns
+*/
+
+class Histogram_builder
+{
+  Field *column;           /* table field for which the histogram is built */
+  uint col_length;         /* size of this field                           */
+  ha_rows records;         /* number of records the histogram is built for */
+  Field *min_value;        /* pointer to the minimal value for the field   */
+  Field *max_value;        /* pointer to the maximal value for the field   */
+  Histogram *histogram;    /* the histogram location                       */
+  uint hist_width;         /* the number of points in the histogram        */
+  double bucket_capacity;  /* number of rows in a bucket of the histogram  */ 
+  uint curr_bucket;        /* number of the current bucket to be built     */
+  ulonglong count;         /* number of values retrieved                   */
+  ulonglong count_distinct;    /* number of distinct values retrieved      */
+  /* number of distinct values that occured only once  */
+  ulonglong count_distinct_single_occurence;
+
+public: 
+  Histogram_builder(Field *col, uint col_len, ha_rows rows)
+    : column(col), col_length(col_len), records(rows)
+  {
+    Column_statistics *col_stats= col->collected_stats;
+    min_value= col_stats->min_value;
+    max_value= col_stats->max_value;
+    histogram= &col_stats->histogram;
+    hist_width= histogram->get_width();
+    bucket_capacity= (double) records / (hist_width + 1);
+    curr_bucket= 0;
+    count= 0;
+    count_distinct= 0;
+    count_distinct_single_occurence= 0;
+  }
+
+  ulonglong get_count_distinct() const { return count_distinct; }
+  ulonglong get_count_single_occurence() const
+  {
+    return count_distinct_single_occurence;
+  }
+
+  int next(void *elem, element_count elem_cnt)
+  {
+    count_distinct++;
+    if (elem_cnt == 1)
       count_distinct_single_occurence++;
     count+= elem_cnt;
     if (curr_bucket == hist_width)
@@ -1585,6 +2057,199 @@ class Histogram_builder
 };
 
 
+/*
+  Histogram_json_builder builds a JSON_HB histogram for a column
+
+  @details
+  The distinct values of the column are walked once in ascending order.
+  A value is one of the most common values if it takes at least as many
+  rows as a bucket would. The other values are put into equi-depth buckets,
+  every bucket gets an equal share of the rows that are left when it is
+  started. The most common values are written after the buckets.
+  The first hist_width values are kept back until a value beyond them is
+  met: if the column has no more distinct values than buckets, all of them
+  become the most common values.
+*/
+
+class Histogram_json_builder
+{
+  Field *column;           /* table field for which the histogram is built */
+  uint col_length;         /* size of the values in the tree               */
+  ha_rows records;         /* number of records the histogram is built for */
+  Histogram *histogram;    /* the histogram location                       */
+  uint hist_width;         /* the number of buckets in the histogram       */
+  ulonglong count_distinct;    /* number of distinct values retrieved      */
+  /* number of distinct values that occured only once  */
+  ulonglong count_distinct_single_occurence;
+  element_count mcv_min_count; /* minimal number of rows of a common value */
+
+  double bucket_capacity;  /* number of rows in the current bucket         */
+  uint curr_bucket;        /* number of the current bucket to be built     */
+  ulonglong count;         /* number of rows in the buckets and the mcvs   */
+  ulonglong bucket_rows;   /* number of rows in the current bucket         */
+  ulonglong bucket_ndv;    /* number of values in the current bucket       */
+  uchar *bucket_start;     /* the first value of the current bucket        */
+  uchar *bucket_end;       /* the last value of the current bucket         */
+  /*
+    The first hist_width values while they are kept back, then the most
+    common values. There are never more than hist_width of those.
+  */
+  uchar *mcv_values;
+  element_count *mcv_counts;
+  uint mcv_count;
+  Json_writer writer;
+  String value_buf;
+  String escaped_buf;
+
+  /* Write a value from the tree as a JSON string */
+  void add_value(const uchar *elem)
+  {
+    String *val;
+    int len;
+    if (column->type() == MYSQL_TYPE_BIT)
+      column->store((longlong) *((ulonglong *) elem), true);
+    else
+      column->store_field_value((uchar *) elem, col_length);
+    val= column->val_str(&value_buf);
+    /* A byte of the value takes at most 6 bytes when escaped */
+    if (escaped_buf.alloc(val->length() * 6))
+      len= -1;
+    else
+      len= json_escape(val->charset(), (const uchar *) val->ptr(),
+                       (const uchar *) val->end(), &my_charset_utf8mb4_bin,
+                       (uchar *) escaped_buf.ptr(),
+                       (uchar *) escaped_buf.ptr() + val->length() * 6);
+    writer.add_str(escaped_buf.ptr(), len > 0 ? len : 0);
+  }
+
+  void write_bucket()
+  {
+    writer.start_object();
+    writer.add_member("start");
+    add_value(bucket_start);
+    writer.add_member("end");
+    add_value(bucket_end);
+    writer.add_member("size").add_double((double) bucket_rows / records);
+    writer.add_member("ndv").add_ull(bucket_ndv);
+    writer.end_object();
+    curr_bucket++;
+    bucket_rows= bucket_ndv= 0;
+  }
+
+  /* Put a value into the most common values or into the current bucket */
+  void add_element(const uchar *elem, element_count elem_cnt)
+  {
+    count+= elem_cnt;
+    if (elem_cnt >= mcv_min_count)
+    {
+      DBUG_ASSERT(mcv_count < hist_width);
+      /* The value may be one of those kept back, they are not behind it */
+      memmove(mcv_values + mcv_count * col_length, elem, col_length);
+      mcv_counts[mcv_count++]= elem_cnt;
+      return;
+    }
+    if (!bucket_ndv)
+    {
+      memcpy(bucket_start, elem, col_length);
+      bucket_capacity= (double) (records - count + elem_cnt) /
+                       (hist_width - curr_bucket);
+    }
+    memcpy(bucket_end, elem, col_length);
+    bucket_ndv++;
+    bucket_rows+= elem_cnt;
+    if (bucket_rows >= bucket_capacity && curr_bucket + 1 < hist_width)
+      write_bucket();
+  }
+
+public:
+  Histogram_json_builder(Field *col, uint col_len, ha_rows rows)
+    : column(col), col_length(col_len), records(rows),
+      count_distinct(0), count_distinct_single_occurence(0),
+      curr_bucket(0), count(0), bucket_rows(0), bucket_ndv(0), mcv_count(0)
+  {
+    histogram= &col->collected_stats->histogram;
+    hist_width= histogram->get_size();
+    mcv_min_count= (element_count) ((records + hist_width - 1) / hist_width);
+    set_if_bigger(mcv_min_count, 2);
+  }
+
+  ulonglong get_count_distinct() const { return count_distinct; }
+  ulonglong get_count_single_occurence() const
+  {
+    return count_distinct_single_occurence;
+  }
+
+  /* Prepare the walk, return true if out of memory */
+  bool start(MEM_ROOT *mem_root)
+  {
+    if (!(bucket_start= (uchar *) alloc_root(mem_root, col_length * 2)) ||
+        !(mcv_values= (uchar *) alloc_root(mem_root,
+                                           col_length * hist_width)) ||
+        !(mcv_counts= (element_count *) alloc_root(mem_root,
+                                                   sizeof(element_count) *
+                                                   hist_width)))
+      return true;
+    bucket_end= bucket_start + col_length;
+    writer.start_object();
+    writer.add_member("buckets").start_array();
+    return false;
+  }
+
+  int next(void *elem, element_count elem_cnt)
+  {
+    count_distinct++;
+    if (elem_cnt == 1)
+      count_distinct_single_occurence++;
+    if (count_distinct <= hist_width)
+    {
+      /* Keep the value back */
+      memcpy(mcv_values + mcv_count * col_length, elem, col_length);
+      mcv_counts[mcv_count++]= elem_cnt;
+      return 0;
+    }
+    if (count_distinct == hist_width + 1)
+    {
+      /* There are more values than buckets, build the buckets */
+      uint kept= mcv_count;
+      mcv_count= 0;
+      for (uint i= 0; i < kept; i++)
+        add_element(mcv_values + i * col_length, mcv_counts[i]);
+    }
+    add_element((uchar *) elem, elem_cnt);
+    return 0;
+  }
+
+  /* Finish the JSON document and put it into the histogram */
+  bool finish(MEM_ROOT *mem_root)
+  {
+    uchar *text;
+    if (bucket_ndv)
+      write_bucket();
+    writer.end_array();
+    writer.add_member("most_common_values").start_array();
+    for (uint i= 0; i < mcv_count; i++)
+    {
+      writer.start_object();
+      writer.add_member("value");
+      add_value(mcv_values + i * col_length);
+      writer.add_member("frequency").add_double((double) mcv_counts[i] /
+                                                records);
+      writer.end_object();
+    }
+    writer.end_array();
+    writer.end_object();
+
+    const String *res= writer.output.get_string();
+    if (!(text= (uchar *) memdup_root(mem_root, res->ptr(), res->length())))
+      return true;
+    histogram->set_values(text);
+    histogram->set_size(res->length());
+    histogram->set_width(curr_bucket);
+    return false;
+  }
+};
+
+
 C_MODE_START
 
 int histogram_build_walk(void *elem, element_count elem_cnt, void *arg)
@@ -1594,6 +2259,13 @@ int histogram_build_walk(void *elem, element_count elem_cnt, void *arg)
 }
 
 
+static int json_histogram_build_walk(void *elem, element_count elem_cnt,
+                                     void *arg)
+{
+  return ((Histogram_json_builder *) arg)->next(elem, elem_cnt);
+}
+
+
 
 static int count_distinct_single_occurence_walk(void *elem,
                                                 element_count count, void *arg)
@@ -1664,7 +2336,7 @@ class Count_distinct_field: public Sql_alloc
     @brief
     Check whether the Unique object tree has been successfully created
   */
-  bool exists()
+  virtual bool exists()
   {
     return (tree != NULL);
   }
@@ -1683,7 +2355,7 @@ class Count_distinct_field: public Sql_alloc
     @brief
     Calculate the number of elements accumulated in the container of 'tree'
   */
-  void walk_tree()
+  virtual void walk_tree()
   {
     ulonglong counts[2] = {0, 0};
     tree->walk(table_field->table,
@@ -1698,12 +2370,33 @@ class Count_distinct_field: public Sql_alloc
   */
    void walk_tree_with_histogram(ha_rows rows)
   {
+    if (table_field->collected_stats->histogram.get_type() == JSON_HB)
+    {
+      walk_tree_with_json_histogram(rows);
+      return;
+    }
     Histogram_builder hist_builder(table_field, tree_key_length, rows);
     tree->walk(table_field->table,  histogram_build_walk, (void *) &hist_builder);
     distincts= hist_builder.get_count_distinct();
     distincts_single_occurence= hist_builder.get_count_single_occurence();
   }
 
+  /*
+    @brief
+    Calculate a JSON_HB histogram of the tree
+  */
+  void walk_tree_with_json_histogram(ha_rows rows)
+  {
+    TABLE *table= table_field->table;
+    Histogram_json_builder hist_builder(table_field, tree_key_length, rows);
+    if (hist_builder.start(&table->mem_root) ||
+        tree->walk(table, json_histogram_build_walk, (void *) &hist_builder) ||
+        hist_builder.finish(&table->mem_root))
+      table_field->collected_stats->histogram.set_size(0);
+    distincts= hist_builder.get_count_distinct();
+    distincts_single_occurence= hist_builder.get_count_single_occurence();
+  }
+
   ulonglong get_count_distinct()
   {
     return distincts;
@@ -1772,6 +2465,111 @@ class Count_distinct_field_bit: public Count_distinct_field
 };
 
 
+/*
+  The class Count_distinct_field_hll is derived from the class
+  Count_distinct_field to estimate the number of distinct values with a
+  HyperLogLog sketch instead of collecting them in a Unique object.
+  The sketch has 2^precision one byte registers, it never grows and never
+  goes to disk, the standard error of the estimate is 1.04/sqrt(2^precision).
+  It cannot count the values that occur only once, nor be used to build
+  a histogram.
+  The values are hashed by their sort keys, so the values that are equal
+  in the collation of the column get the same hash.
+*/
+
+class Count_distinct_field_hll: public Count_distinct_field
+{
+  uchar *registers;
+  uint precision;
+  uchar *sort_key;
+  uint sort_key_length;
+
+  static inline ulonglong mix(ulonglong h)
+  {
+    /* The MurmurHash3 finalizer */
+    h^= h >> 33;
+    h*= 0xff51afd7ed558ccdULL;
+    h^= h >> 33;
+    h*= 0xc4ceb9fe1a85ec53ULL;
+    h^= h >> 33;
+    return h;
+  }
+
+  ulonglong hash_sort_key()
+  {
+    const uchar *pos= sort_key, *end= sort_key + sort_key_length;
+    ulonglong h= sort_key_length;
+    for (; pos + 8 <= end; pos+= 8)
+      h= (h ^ mix(uint8korr(pos))) * 0x9e3779b97f4a7c15ULL;
+    if (pos < end)
+    {
+      uchar tail[8]= {0};
+      memcpy(tail, pos, end - pos);
+      h= (h ^ mix(uint8korr(tail))) * 0x9e3779b97f4a7c15ULL;
+    }
+    return mix(h);
+  }
+
+public:
+
+  Count_distinct_field_hll(Field *field, uint bits)
+  {
+    table_field= field;
+    tree= NULL;
+    tree_key_length= 0;
+    precision= bits;
+    sort_key_length= field->sort_length();
+    registers= (uchar *) my_malloc(PSI_INSTRUMENT_ME,
+                                   ((size_t) 1 << precision) + sort_key_length,
+                                   MYF(MY_ZEROFILL | MY_THREAD_SPECIFIC));
+    sort_key= registers + ((size_t) 1 << precision);
+  }
+
+  ~Count_distinct_field_hll()
+  {
+    my_free(registers);
+  }
+
+  bool exists() { return registers != NULL; }
+
+  bool add()
+  {
+    table_field->sort_string(sort_key, sort_key_length);
+    ulonglong hash= hash_sort_key();
+    /*
+      The first bits choose the register, it keeps the maximal position of
+      the first 1 bit in the rest of the hash
+    */
+    uint idx= (uint) (hash >> (64 - precision));
+    ulonglong rest= (hash << precision) | (1ULL << (precision - 1));
+    uchar rank= (uchar) (64 - my_bit_log2_uint64(rest));
+    set_if_bigger(registers[idx], rank);
+    return false;
+  }
+
+  void walk_tree()
+  {
+    uint m= 1U << precision;
+    uint zeros= 0;
+    double sum= 0, estimate;
+    for (uint i= 0; i < m; i++)
+    {
+      sum+= ldexp(1.0, -(int) registers[i]);
+      if (!registers[i])
+        zeros++;
+    }
+    double alpha= m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 :
+                  0.7213 / (1 + 1.079 / m);
+    estimate= alpha * m * m / sum;
+    /* Small cardinalities are estimated by the number of empty registers */
+    if (estimate <= 2.5 * m && zeros)
+      estimate= m * log((double) m / zeros);
+    distincts= (ulonglong) (estimate + 0.5);
+    distincts_single_occurence= 0;
+  }
+};
+
+
 /* 
   The class Index_prefix_calc is a helper class used to calculate the values
   for the column 'avg_frequency' of the statistical table index_stats.
@@ -2138,7 +2936,11 @@ int alloc_statistics_for_table(THD* thd, TABLE *table)
   uint hist_size= thd->variables.histogram_size;
   Histogram_type hist_type= (Histogram_type) (thd->variables.histogram_type);
   uchar *histogram= NULL;
-  if (hist_size > 0)
+  /*
+    A JSON_HB histogram has hist_size buckets, its text is allocated when
+    it is built
+  */
+  if (hist_size > 0 && hist_type != JSON_HB)
   {
     if ((histogram= (uchar *) alloc_root(&table->mem_root,
                                          hist_size * columns)))
@@ -2147,7 +2949,7 @@ int alloc_statistics_for_table(THD* thd, TABLE *table)
   }
 
   if (!table_stats || !column_stats || !index_stats || !idx_avg_frequency ||
-      (hist_size && !histogram))
+      (hist_size && hist_type != JSON_HB && !histogram))
     DBUG_RETURN(1);
 
   table->collected_stats= table_stats;
@@ -2155,8 +2957,9 @@ int alloc_statistics_for_table(THD* thd, TABLE *table)
   table_stats->index_stats= index_stats;
   table_stats->idx_avg_frequency= idx_avg_frequency;
   table_stats->histograms= histogram;
+  table_stats->column_groups= NULL;
   
-  memset(column_stats, 0, sizeof(Column_statistics) * (fields+1));
+  memset(column_stats, 0, sizeof(Column_statistics_collected) * (fields+1));
 
   for (field_ptr= table->field; *field_ptr; field_ptr++, column_stats++)
   {
@@ -2168,7 +2971,8 @@ int alloc_statistics_for_table(THD* thd, TABLE *table)
       column_stats->histogram.set_size(hist_size);
       column_stats->histogram.set_type(hist_type);
       column_stats->histogram.set_values(histogram);
-      histogram+= hist_size;
+      if (histogram)
+        histogram+= hist_size;
     }
   }
 
@@ -2190,6 +2994,136 @@ int alloc_statistics_for_table(THD* thd, TABLE *table)
 }
 
 
+/**
+  @brief
+  Allocate the structures to collect statistics on the column groups of a table
+
+  @param
+  thd         Thread handler
+  @param
+  table       Table for which statistics on column groups is to be collected
+  @param
+  groups      The column groups listed in ANALYZE, or NULL
+
+  @details
+  Statistics is collected on the column groups of 'table' defined in the
+  statistical table column_group_stats and on the column groups listed in
+  ANALYZE that are not defined yet. The groups that contain columns which
+  statistics is not collected for, or which do not exist in the table any
+  more, are skipped. The function must be called after
+  alloc_statistics_for_table().
+
+  @retval
+  0     If the memory has been successfully allocated
+  @retval
+  1     Otherwise
+*/
+
+int alloc_column_group_statistics_for_table(THD *thd, TABLE *table,
+                                       List<List<LEX_STRING> > *groups)
+{
+  TABLE_SHARE *table_share= table->s;
+  Column_group_statistics **last_group=
+    &table->collected_stats->column_groups;
+  Column_group_statistics *group;
+  StringBuffer<NAME_LEN> names(system_charset_info);
+  TABLE_LIST tables;
+  int rc= 0;
+  DBUG_ENTER("alloc_column_group_statistics_for_table");
+
+  start_new_trans new_trans(thd);
+
+  if (!open_stat_table_for_ddl(thd, &tables,
+                               &stat_table_name[COLUMN_GROUP_STAT]) &&
+      !stat_table_intact.check(tables.table, &column_group_stat_def))
+  {
+    Column_group_stat column_group_stat(tables.table, table);
+    column_group_stat.set_full_table_name();
+    for (bool found= column_group_stat.first_stat_for_prefix(2);
+         found;
+         found= column_group_stat.next_stat_for_prefix())
+    {
+      column_group_stat.get_column_names(&names);
+      LEX_CSTRING group_names= { names.ptr(), names.length() };
+      if (!(group= create_column_group(&table->mem_root, table_share,
+                                       &group_names)))
+        continue;
+      *last_group= group;
+      last_group= &group->next;
+    }
+    column_group_stat.end_stat_for_prefix();
+  }
+  thd->commit_whole_transaction_and_close_tables();
+  new_trans.restore_old_transaction();
+
+  if (groups)
+  {
+    List_iterator_fast<List<LEX_STRING> > it(*groups);
+    List<LEX_STRING> *column_names;
+    while ((column_names= it++))
+    {
+      List_iterator_fast<LEX_STRING> name_it(*column_names);
+      LEX_STRING *name;
+      names.length(0);
+      while ((name= name_it++))
+      {
+        if (names.length())
+          names.append(column_group_separator);
+        names.append(name->str, name->length);
+      }
+      LEX_CSTRING group_names= { names.ptr(), names.length() };
+      if (!(group= create_column_group(&table->mem_root, table_share,
+                                       &group_names)))
+        continue;
+      Column_group_statistics *defined;
+      for (defined= table->collected_stats->column_groups; defined;
+           defined= defined->next)
+      {
+        if (defined->columns == group->columns &&
+            !memcmp(defined->fieldnr, group->fieldnr,
+                    sizeof(uint) * group->columns))
+          break;
+      }
+      if (defined)
+        continue;
+      *last_group= group;
+      last_group= &group->next;
+    }
+  }
+
+  /* Replace the groups by the structures to collect statistics on them */
+  for (last_group= &table->collected_stats->column_groups;
+       (group= *last_group); )
+  {
+    uint i;
+    for (i= 0; i < group->columns; i++)
+    {
+      if (!bitmap_is_set(table->read_set, group->fieldnr[i]))
+        break;
+    }
+    if (i < group->columns)
+    {
+      *last_group= group->next;
+      continue;
+    }
+    Column_group_statistics_collected *collected=
+      (Column_group_statistics_collected *)
+        alloc_root(&table->mem_root,
+                   sizeof(Column_group_statistics_collected));
+    if (!collected)
+    {
+      rc= 1;
+      break;
+    }
+    memset((void *) collected, 0, sizeof(Column_group_statistics_collected));
+    *static_cast<Column_group_statistics *>(collected)= *group;
+    *last_group= collected;
+    last_group= &collected->next;
+  }
+  DBUG_RETURN(rc);
+}
+
+
 /**
   @brief 
   Allocate memory for the statistical data used by a table share
@@ -2318,10 +3252,15 @@ static int alloc_statistics_for_table_share(THD* thd, TABLE_SHARE *table_share)
   thd            Thread handler
   @param
   table_field    Column to collect statistics for
+  @param
+  hll_precision  If not 0 and no histogram is built for the column, the
+                 number of distinct values is estimated with a HyperLogLog
+                 sketch of this precision
 */
 
 inline
-void Column_statistics_collected::init(THD *thd, Field *table_field)
+void Column_statistics_collected::init(THD *thd, Field *table_field,
+                                       uint hll_precision)
 {
   size_t max_heap_table_size= (size_t)thd->variables.max_heap_table_size;
   TABLE *table= table_field->table;
@@ -2343,6 +3282,8 @@ void Column_statistics_collected::init(THD *thd, Field *table_field)
     count_distinct= NULL;
   if (table_field->flags & BLOB_FLAG)
     count_distinct= NULL;
+  else if (hll_precision && !histogram.get_size())
+    count_distinct= new Count_distinct_field_hll(table_field, hll_precision);
   else
   {
     count_distinct=
@@ -2419,7 +3360,11 @@ void Column_statistics_collected::finish(ha_rows rows, double sample_fraction)
     if (hist_size == 0)
       count_distinct->walk_tree();
     else
+    {
       count_distinct->walk_tree_with_histogram(rows - nulls);
+      /* A JSON_HB histogram gets its size when it is built */
+      hist_size= count_distinct->get_hist_size();
+    }
 
     ulonglong distincts= count_distinct->get_count_distinct();
     ulonglong distincts_single_occurence=
@@ -2450,44 +3395,147 @@ void Column_statistics_collected::finish(ha_rows rows, double sample_fraction)
         val = std::fmax(estimate_total_distincts * (rows - nulls) / rows, 1.0);
       }
 
-      set_avg_frequency(val);
-      set_not_null(COLUMN_STAT_AVG_FREQUENCY);
-    }
+      set_avg_frequency(val);
+      set_not_null(COLUMN_STAT_AVG_FREQUENCY);
+    }
+    else
+      hist_size= 0;
+    histogram.set_size(hist_size);
+    set_not_null(COLUMN_STAT_HIST_SIZE);
+    if (hist_size && distincts)
+    {
+      set_not_null(COLUMN_STAT_HIST_TYPE);
+      histogram.set_values(count_distinct->get_histogram());
+      set_not_null(COLUMN_STAT_HISTOGRAM);
+    } 
+    delete count_distinct;
+    count_distinct= NULL;
+  }
+  else if (is_single_pk_col)
+  {
+    val= 1.0;
+    set_avg_frequency(val); 
+    set_not_null(COLUMN_STAT_AVG_FREQUENCY);
+  } 
+}
+
+
+/**
+  @brief
+  Clean up auxiliary structures used for aggregation
+*/
+
+inline
+void Column_statistics_collected::cleanup()
+{
+  if (count_distinct)
+  { 
+    delete count_distinct;
+    count_distinct= NULL;
+  }
+}
+
+
+/**
+  @brief
+  Initialize the aggregation fields to collect statistics on a column group
+
+  @retval
+  0         If the container for the keys has been created
+  @retval
+  1         Otherwise
+*/
+
+inline
+bool Column_group_statistics_collected::init(THD *thd, TABLE *tab)
+{
+  table= tab;
+  key_length= 0;
+  for (uint i= 0; i < columns; i++)
+  {
+    prefix_length= key_length;
+    key_length+= table->field[fieldnr[i]]->sort_length();
+  }
+  rows= 0;
+  avg_frequency= 0;
+  dependency_degree= -1;
+  if (!(key= (uchar *) alloc_root(&table->mem_root, key_length * 2)))
+    return 1;
+  prev_key= key + key_length;
+  tree= new Unique((qsort_cmp2) column_group_key_cmp, (void *) &key_length,
+                   key_length,
+                   (size_t) thd->variables.max_heap_table_size, 1);
+  return tree == NULL;
+}
+
+
+/**
+  @brief
+  Perform aggregation for a row when collecting statistics on a column group
+*/
+
+inline
+bool Column_group_statistics_collected::add()
+{
+  uchar *pos= key;
+  for (uint i= 0; i < columns; i++)
+  {
+    Field *field= table->field[fieldnr[i]];
+    if (field->is_null())
+      return 0;
+    field->sort_string(pos, field->sort_length());
+    pos+= field->sort_length();
+  }
+  rows++;
+  return tree->unique_add(key);
+}
+
+
+/**
+  @brief
+  Get the results of aggregation when collecting statistics on a column group
+
+  @details
+  The average frequency is estimated from a sample in the same way as for
+  a column. The dependency degree is the share of the sampled rows in
+  which the values of the other columns determine the last column.
+*/
+
+inline
+void Column_group_statistics_collected::finish(double sample_fraction)
+{
+  distincts= distincts_single_occurence= 0;
+  prefix_rows= prefix_distincts= determined_rows= 0;
+  if (rows && !tree->walk(table, walk_action, (void *) this))
+  {
+    end_prefix();
+    if (sample_fraction > 0.8)
+      avg_frequency= (double) rows / distincts;
     else
-      hist_size= 0;
-    histogram.set_size(hist_size);
-    set_not_null(COLUMN_STAT_HIST_SIZE);
-    if (hist_size && distincts)
     {
-      set_not_null(COLUMN_STAT_HIST_TYPE);
-      histogram.set_values(count_distinct->get_histogram());
-      set_not_null(COLUMN_STAT_HISTOGRAM);
-    } 
-    delete count_distinct;
-    count_distinct= NULL;
+      double fraction_single_occurence=
+        static_cast<double>(distincts_single_occurence) / rows;
+      double estimate_total_distincts= distincts /
+        (1.0 - (1.0 - sample_fraction) * fraction_single_occurence);
+      avg_frequency= std::fmax(rows / sample_fraction /
+                               estimate_total_distincts, 1.0);
+    }
+    dependency_degree= (double) determined_rows / rows;
   }
-  else if (is_single_pk_col)
-  {
-    val= 1.0;
-    set_avg_frequency(val); 
-    set_not_null(COLUMN_STAT_AVG_FREQUENCY);
-  } 
+  cleanup();
 }
 
 
 /**
   @brief
-  Clean up auxiliary structures used for aggregation
+  Clean up auxiliary structures used for aggregation on a column group
 */
 
 inline
-void Column_statistics_collected::cleanup()
+void Column_group_statistics_collected::cleanup()
 {
-  if (count_distinct)
-  { 
-    delete count_distinct;
-    count_distinct= NULL;
-  }
+  delete tree;
+  tree= NULL;
 }
 
 
@@ -2660,22 +3708,40 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
     }
   }
 
+  /*
+    The sketches cannot count the values that occur once, which is needed
+    to extrapolate the number of distinct values from a sample
+  */
+  uint hll_precision= 0;
+  if (sample_fraction >= 1 && thd->variables.analyze_hll_precision)
+    hll_precision= (uint) MY_MAX(thd->variables.analyze_hll_precision, 4);
+
   for (field_ptr= table->field; *field_ptr; field_ptr++)
   {
     table_field= *field_ptr;   
     if (!bitmap_is_set(table->read_set, table_field->field_index))
       continue; 
-    table_field->collected_stats->init(thd, table_field);
+    table_field->collected_stats->init(thd, table_field, hll_precision);
+  }
+
+  Column_group_statistics_collected *group;
+  for (group= (Column_group_statistics_collected *)
+         table->collected_stats->column_groups;
+       group;
+       group= (Column_group_statistics_collected *) group->next)
+  {
+    if (group->init(thd, table))
+      DBUG_RETURN(1);
   }
 
   restore_record(table, s->default_values);
 
-  /* Perform a full table scan to collect statistics on 'table's columns */
-  if (!(rc= file->ha_rnd_init(TRUE)))
+  /* Read a sample of the rows to collect statistics on 'table's columns */
+  if (!(rc= file->ha_sample_init(sample_fraction)))
   {
     DEBUG_SYNC(table->in_use, "statistics_collection_start");
 
-    while ((rc= file->ha_rnd_next(table->record[0])) != HA_ERR_END_OF_FILE)
+    while ((rc= file->ha_sample_next(table->record[0])) != HA_ERR_END_OF_FILE)
     {
       if (thd->killed)
         break;
@@ -2683,22 +3749,24 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
       if (rc)
         break;
 
-      if (thd_rnd(thd) <= sample_fraction)
+      for (field_ptr= table->field; *field_ptr; field_ptr++)
       {
-        for (field_ptr= table->field; *field_ptr; field_ptr++)
-        {
-          table_field= *field_ptr;
-          if (!bitmap_is_set(table->read_set, table_field->field_index))
-            continue;
-          if ((rc= table_field->collected_stats->add()))
-            break;
-        }
-        if (rc)
+        table_field= *field_ptr;
+        if (!bitmap_is_set(table->read_set, table_field->field_index))
+          continue;
+        if ((rc= table_field->collected_stats->add()))
           break;
-        rows++;
       }
+      for (group= (Column_group_statistics_collected *)
+             table->collected_stats->column_groups;
+           group && !rc;
+           group= (Column_group_statistics_collected *) group->next)
+        rc= group->add();
+      if (rc)
+        break;
+      rows++;
     }
-    file->ha_rnd_end();
+    file->ha_sample_end();
   }
   rc= (rc == HA_ERR_END_OF_FILE && !thd->killed) ? 0 : 1;
 
@@ -2728,6 +3796,17 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
   }
   bitmap_clear_all(table->write_set);
 
+  for (group= (Column_group_statistics_collected *)
+         table->collected_stats->column_groups;
+       group;
+       group= (Column_group_statistics_collected *) group->next)
+  {
+    if (!rc)
+      group->finish(sample_fraction);
+    else
+      group->cleanup();
+  }
+
   if (!rc)
   {
     uint key;
@@ -2851,6 +3930,20 @@ int update_statistics_for_table(THD *thd, TABLE *table)
     }
   }
 
+  /* Update the statistical table column_group_stats */
+  stat_table= tables[COLUMN_GROUP_STAT].table;
+  Column_group_stat column_group_stat(stat_table, table);
+  for (Column_group_statistics *group= table->collected_stats->column_groups;
+       group;
+       group= group->next)
+  {
+    restore_record(stat_table, s->default_values);
+    column_group_stat.set_key_fields(group);
+    err= column_group_stat.update_stat();
+    if (err && !rc)
+      rc= 1;
+  }
+
   thd->restore_stmt_binlog_format(save_binlog_format);
   if (thd->commit_whole_transaction_and_close_tables())
     rc= 1;
@@ -2999,6 +4092,30 @@ int read_statistics_for_table(THD *thd, TABLE *table, TABLE_LIST *stat_tables)
     }
   }
 
+  /* Read statistics from the statistical table column_group_stats */
+  stat_table= stat_tables[COLUMN_GROUP_STAT].table;
+  Column_group_stat column_group_stat(stat_table, table);
+  Column_group_statistics **last_group= &read_stats->column_groups;
+  StringBuffer<NAME_LEN> names(system_charset_info);
+  *last_group= NULL;
+  column_group_stat.set_full_table_name();
+  for (bool found= column_group_stat.first_stat_for_prefix(2);
+       found;
+       found= column_group_stat.next_stat_for_prefix())
+  {
+    Column_group_statistics *group;
+    column_group_stat.get_column_names(&names);
+    LEX_CSTRING group_names= { names.ptr(), names.length() };
+    if (!(group= create_column_group(&table_share->stats_cb.mem_root,
+                                     table_share, &group_names)))
+      continue;
+    column_group_stat.set_group(group);
+    column_group_stat.get_stat_values();
+    *last_group= group;
+    last_group= &group->next;
+  }
+  column_group_stat.end_stat_for_prefix();
+
   table_share->stats_cb.end_stats_load();
   DBUG_RETURN(0);
 }
@@ -3090,12 +4207,17 @@ int read_histograms_for_table(THD *thd, TABLE *table, TABLE_LIST *stat_tables)
     for (Field **field_ptr= table->s->field; *field_ptr; field_ptr++)
     {
       Field *table_field= *field_ptr;
-      if (uint hist_size= table_field->read_stats->histogram.get_size())
+      Histogram *hist= &table_field->read_stats->histogram;
+      if (uint hist_size= hist->get_size())
       {
         column_stat.set_key_fields(table_field);
-        table_field->read_stats->histogram.set_values(histogram);
+        hist->set_values(histogram);
         column_stat.get_histogram_value();
         histogram+= hist_size;
+        if (hist->get_type() == JSON_HB)
+          (void) hist->parse_json(thd, &stats_cb->mem_root,
+                                  table->field[table_field->field_index],
+                                  table_field->read_stats);
       }
     }
     stats_cb->end_histograms_load();
@@ -3256,7 +4378,8 @@ int read_statistics_for_tables(THD *thd, TABLE_LIST *tables)
 
   @details
   The function delete statistics on the table called 'tab' of the database
-  'db' from all statistical tables: table_stats, column_stats, index_stats.
+  'db' from all statistical tables: table_stats, column_stats, index_stats,
+  column_group_stats.
 
   @retval
   0         If all deletions are successful or we couldn't open statistics table
@@ -3296,6 +4419,17 @@ int delete_statistics_for_table(THD *thd, const LEX_CSTRING *db,
       rc= 1;
   }
 
+  /* Delete statistics on table from the statistical table column_group_stats */
+  stat_table= tables[COLUMN_GROUP_STAT].table;
+  Column_group_stat column_group_stat(stat_table, db, tab);
+  column_group_stat.set_full_table_name();
+  while (column_group_stat.find_next_stat_for_prefix(2))
+  {
+    err= column_group_stat.delete_stat();
+    if (err & !rc)
+      rc= 1;
+  }
+
   /* Delete statistics on table from the statistical table column_stats */
   stat_table= tables[COLUMN_STAT].table;
   Column_stat column_stat(stat_table, db, tab);
@@ -3330,6 +4464,95 @@ int delete_statistics_for_table(THD *thd, const LEX_CSTRING *db,
 }
 
 
+/**
+  @brief
+  Delete or rename a column in the column groups of a table
+
+  @param thd         The thread handle
+  @param tab         The table the column belongs to
+  @param col         The column
+  @param new_name    The new name of the column, or NULL
+
+  @details
+  If 'new_name' is NULL the function deletes the statistics on the column
+  groups that contain the column 'col' of the table 'tab' from the
+  statistical table column_group_stats. Otherwise the column is renamed
+  in the definitions of these groups.
+
+  @retval 0  If all updates are successful or we couldn't open the table
+  @retval 1  Otherwise
+*/
+
+static int update_column_groups_for_column(THD *thd, TABLE *tab, Field *col,
+                                           const char *new_name)
+{
+  int err;
+  enum_binlog_format save_binlog_format;
+  TABLE_LIST tables;
+  StringBuffer<NAME_LEN> names(system_charset_info);
+  StringBuffer<NAME_LEN> new_names(system_charset_info);
+  int rc= 0;
+  DBUG_ENTER("update_column_groups_for_column");
+
+  start_new_trans new_trans(thd);
+
+  if (open_stat_table_for_ddl(thd, &tables,
+                              &stat_table_name[COLUMN_GROUP_STAT]))
+    DBUG_RETURN(0);
+
+  save_binlog_format= thd->set_current_stmt_binlog_format_stmt();
+
+  Column_group_stat column_group_stat(tables.table, tab);
+  column_group_stat.set_full_table_name();
+  Stat_table_write_iter column_group_iter(&column_group_stat);
+  if (column_group_iter.init(2))
+    rc= 1;
+  while (!column_group_iter.get_next_row())
+  {
+    bool found= FALSE;
+    column_group_stat.get_column_names(&names);
+    const char *pos= names.ptr(), *end= names.ptr() + names.length();
+    new_names.length(0);
+    while (pos <= end)
+    {
+      const char *name_end= (const char *) memchr(pos, column_group_separator,
+                                                  end - pos);
+      if (!name_end)
+        name_end= end;
+      LEX_CSTRING name= { pos, (size_t) (name_end - pos) };
+      if (new_names.length())
+        new_names.append(column_group_separator);
+      if (!my_strnncoll(system_charset_info,
+                        (const uchar *) col->field_name.str,
+                        col->field_name.length,
+                        (const uchar *) name.str, name.length))
+      {
+        found= TRUE;
+        if (new_name)
+          new_names.append(new_name, strlen(new_name));
+      }
+      else
+        new_names.append(name.str, name.length);
+      pos= name_end + 1;
+    }
+    if (!found)
+      continue;
+    err= new_name ? column_group_stat.update_column_names(&new_names) :
+                    column_group_stat.delete_stat();
+    if (err && !rc)
+      rc= 1;
+  }
+  column_group_iter.cleanup();
+
+  thd->restore_stmt_binlog_format(save_binlog_format);
+  if (thd->commit_whole_transaction_and_close_tables())
+    rc= 1;
+  new_trans.restore_old_transaction();
+
+  DBUG_RETURN(rc);
+}
+
+
 /**
   @brief
   Delete statistics on a column of the specified table
@@ -3340,7 +4563,8 @@ int delete_statistics_for_table(THD *thd, const LEX_CSTRING *db,
 
   @details
   The function delete statistics on the column 'col' belonging to the table 
-  'tab' from the statistical table column_stats. 
+  'tab' from the statistical table column_stats, and the statistics on the
+  column groups containing the column from column_group_stats.
 
   @retval 0  If all deletions are successful or we couldn't open statistics table
   @retval 1  Otherwise
@@ -3381,6 +4605,9 @@ int delete_statistics_for_column(THD *thd, TABLE *tab, Field *col)
     rc= 1;
   new_trans.restore_old_transaction();
 
+  if (update_column_groups_for_column(thd, tab, col, NULL))
+    rc= 1;
+
   DBUG_RETURN(rc);
 }
 
@@ -3479,7 +4706,7 @@ int delete_statistics_for_index(THD *thd, TABLE *tab, KEY *key_info,
   @details
   The function replaces the name of the table 'tab' from the database 'db' 
   for 'new_tab' in all all statistical tables: table_stats, column_stats,
-  index_stats.
+  index_stats, column_group_stats.
 
   @retval
   0         If all updates of the table name are successful
@@ -3526,6 +4753,22 @@ int rename_table_in_stat_tables(THD *thd, const LEX_CSTRING *db,
   }
   index_iter.cleanup();
 
+  /* Rename table in the statistical table column_group_stats */
+  stat_table= tables[COLUMN_GROUP_STAT].table;
+  Column_group_stat column_group_stat(stat_table, db, tab);
+  column_group_stat.set_full_table_name();
+  Stat_table_write_iter column_group_iter(&column_group_stat);
+  if (column_group_iter.init(2))
+    rc= 1;
+  while (!column_group_iter.get_next_row())
+  {
+    err= column_group_stat.update_table_name_key_parts(new_db, new_tab);
+    if (err & !rc)
+      rc= 1;
+    column_group_stat.set_full_table_name();
+  }
+  column_group_iter.cleanup();
+
   /* Rename table in the statistical table column_stats */
   stat_table= tables[COLUMN_STAT].table;
   Column_stat column_stat(stat_table, db, tab);
@@ -3618,6 +4861,9 @@ int rename_column_in_stat_tables(THD *thd, TABLE *tab, Field *col,
     rc= 1;
   new_trans.restore_old_transaction();
 
+  if (update_column_groups_for_column(thd, tab, col, new_name))
+    rc= 1;
+
   DBUG_RETURN(rc);
 }
 
@@ -3711,6 +4957,59 @@ double get_column_avg_frequency(Field * field)
 } 
 
 
+/**
+  @brief
+  Get the selectivity of equalities on all columns of a column group
+
+  @param
+  table       The table of the group
+  @param
+  group       The column group
+
+  @details
+  The selectivities of the equalities on the columns must be set in
+  Field::cond_selectivity. The selectivity of the equalities on all columns
+  but the last one is taken as the product of their selectivities. The
+  selectivity of the equality on the last column is corrected with the
+  degree of its functional dependency on the other columns d:
+    sel(c1..cn) = sel(c1..cn-1) * (d + (1 - d) * sel(cn))
+  The result is not less than the average selectivity of the combination
+  of values of the columns, which covers correlations the functional
+  dependency misses, and is not greater than the selectivity of the
+  equality on any column of the group.
+
+  @retval
+  The estimated selectivity
+*/
+
+double get_column_group_selectivity(TABLE *table,
+                                    Column_group_statistics *group)
+{
+  uint last= group->columns - 1;
+  double sel= 1.0;
+  double min_sel= 1.0;
+  for (uint i= 0; i < last; i++)
+  {
+    double col_sel= table->field[group->fieldnr[i]]->cond_selectivity;
+    sel*= col_sel;
+    set_if_smaller(min_sel, col_sel);
+  }
+  double last_sel= table->field[group->fieldnr[last]]->cond_selectivity;
+  set_if_smaller(min_sel, last_sel);
+  if (group->dependency_degree >= 0)
+    sel*= group->dependency_degree +
+          (1.0 - group->dependency_degree) * last_sel;
+  else
+    sel*= last_sel;
+
+  double rows= (double) table->stat_records();
+  if (group->avg_frequency > 0 && rows > 0)
+    set_if_bigger(sel, group->avg_frequency / rows);
+  set_if_smaller(sel, min_sel);
+  return sel;
+}
+
+
 /**
   @brief
   Estimate the number of rows in a column range using data from stat tables 
@@ -3794,7 +5093,10 @@ double get_column_range_cardinality(Field *field,
           double pos= field->pos_in_interval(col_stats->min_value,
                                              col_stats->max_value);
           res= col_non_nulls * 
-	       hist->point_selectivity(pos,
+	       hist->point_selectivity(field,
+                                       (uchar *) min_endp->key +
+                                       MY_TEST(field->null_ptr),
+                                       pos,
                                        avg_frequency / col_non_nulls);
         }
       }
@@ -3810,6 +5112,7 @@ double get_column_range_cardinality(Field *field,
     if (col_stats->min_max_values_are_provided())
     {
       double sel, min_mp_pos, max_mp_pos;
+      const uchar *min_key= NULL, *max_key= NULL;
 
       if (min_endp && !(field->null_ptr && min_endp->key[0]))
       {
@@ -3817,6 +5120,7 @@ double get_column_range_cardinality(Field *field,
                                field->key_length());
         min_mp_pos= field->pos_in_interval(col_stats->min_value,
                                            col_stats->max_value);
+        min_key= min_endp->key + MY_TEST(field->null_ptr);
       }
       else
         min_mp_pos= 0.0;
@@ -3826,6 +5130,7 @@ double get_column_range_cardinality(Field *field,
                                field->key_length());
         max_mp_pos= field->pos_in_interval(col_stats->min_value,
                                            col_stats->max_value);
+        max_key= max_endp->key + MY_TEST(field->null_ptr);
       }
       else
         max_mp_pos= 1.0;
@@ -3834,7 +5139,8 @@ double get_column_range_cardinality(Field *field,
       if (!hist->is_available())
         sel= (max_mp_pos - min_mp_pos);
       else
-        sel= hist->range_selectivity(min_mp_pos, max_mp_pos);
+        sel= hist->range_selectivity(field, min_key, min_mp_pos,
+                                     max_key, max_mp_pos, range_flag);
       res= col_non_nulls * sel;
       set_if_bigger(res, col_stats->get_avg_frequency());
     }
@@ -3848,9 +5154,377 @@ double get_column_range_cardinality(Field *field,
 
 
 
+/*
+  Parsed JSON_HB histogram
+
+  The values are kept as key images of the column. Sizes of the buckets and
+  frequencies of the most common values are fractions of the rows with not
+  NULL values, together they add up to 1.
+*/
+
+class Histogram_json :public Sql_alloc
+{
+public:
+  struct Bucket
+  {
+    uchar *start, *end;          /* the first and the last value      */
+    double start_pos, end_pos;   /* their positions between min..max  */
+    double size;
+    double ndv;                  /* number of distinct values         */
+  };
+  struct Common_value
+  {
+    uchar *value;
+    double frequency;
+  };
+
+  Bucket *buckets;
+  uint n_buckets;
+  Common_value *mcvs;
+  uint n_mcvs;
+  /* Selectivity of a value that ANALYZE has not seen */
+  double unseen_sel;
+
+  double point_selectivity(Field *field, const uchar *key, double avg_sel);
+  double range_selectivity(Field *field, const uchar *min_key, double min_pos,
+                           const uchar *max_key, double max_pos,
+                           uint range_flag);
+
+private:
+  /* The first bucket that ends at or after the key */
+  uint find_bucket(Field *field, const uchar *key)
+  {
+    uint lo= 0, hi= n_buckets;
+    while (lo < hi)
+    {
+      uint mid= (lo + hi) / 2;
+      if (field->key_cmp(buckets[mid].end, key) < 0)
+        lo= mid + 1;
+      else
+        hi= mid;
+    }
+    return lo;
+  }
+  double fraction_below(Field *field, Bucket *bucket, const uchar *key,
+                        double pos, bool inclusive);
+};
+
+
+double Histogram_json::point_selectivity(Field *field, const uchar *key,
+                                         double avg_sel)
+{
+  uint i;
+  for (i= 0; i < n_mcvs; i++)
+  {
+    if (!field->key_cmp(mcvs[i].value, key))
+      return mcvs[i].frequency;
+  }
+  if ((i= find_bucket(field, key)) < n_buckets &&
+      field->key_cmp(key, buckets[i].start) >= 0)
+    return buckets[i].size / buckets[i].ndv;
+  return MY_MIN(avg_sel, unseen_sel);
+}
+
+
+/*
+  Fraction of the rows of the bucket with values below the key, or not
+  above the key if 'inclusive' is set.
+  Inside the bucket the values are assumed to be distributed uniformly
+  between the positions of its endpoints.
+*/
+
+double Histogram_json::fraction_below(Field *field, Bucket *bucket,
+                                      const uchar *key, double pos,
+                                      bool inclusive)
+{
+  int cmp= field->key_cmp(key, bucket->start);
+  if (cmp < 0 || (cmp == 0 && !inclusive))
+    return 0.0;
+  if (cmp == 0)
+    return 1.0 / bucket->ndv;
+  cmp= field->key_cmp(key, bucket->end);
+  if (cmp > 0 || (cmp == 0 && inclusive))
+    return 1.0;
+  if (cmp == 0)
+    return 1.0 - 1.0 / bucket->ndv;
+
+  double frac= 0.5;
+  if (bucket->end_pos > bucket->start_pos)
+    frac= (pos - bucket->start_pos) / (bucket->end_pos - bucket->start_pos);
+  set_if_smaller(frac, 1.0 - 1.0 / bucket->ndv);
+  set_if_bigger(frac, 1.0 / bucket->ndv);
+  return frac;
+}
+
+
+double Histogram_json::range_selectivity(Field *field,
+                                         const uchar *min_key, double min_pos,
+                                         const uchar *max_key, double max_pos,
+                                         uint range_flag)
+{
+  double sel= 0.0;
+  uint i;
+
+  for (i= 0; i < n_mcvs; i++)
+  {
+    int cmp;
+    if (min_key && ((cmp= field->key_cmp(mcvs[i].value, min_key)) < 0 ||
+                    (cmp == 0 && (range_flag & NEAR_MIN))))
+      continue;
+    if (max_key && ((cmp= field->key_cmp(mcvs[i].value, max_key)) > 0 ||
+                    (cmp == 0 && (range_flag & NEAR_MAX))))
+      continue;
+    sel+= mcvs[i].frequency;
+  }
+
+  for (i= min_key ? find_bucket(field, min_key) : 0; i < n_buckets; i++)
+  {
+    Bucket *bucket= buckets + i;
+    double lo= 0.0, hi= 1.0;
+    if (min_key)
+      lo= fraction_below(field, bucket, min_key, min_pos,
+                         MY_TEST(range_flag & NEAR_MIN));
+    if (max_key)
+    {
+      if (field->key_cmp(bucket->start, max_key) > 0)
+        break;
+      hi= fraction_below(field, bucket, max_key, max_pos,
+                         !(range_flag & NEAR_MAX));
+    }
+    if (hi > lo)
+      sel+= bucket->size * (hi - lo);
+  }
+  set_if_smaller(sel, 1.0);
+  return sel;
+}
+
+
+/*
+  Read a value of the JSON_HB histogram into a key image of the column
+
+  @param field   The column of a TABLE, its record buffer is used
+  @param js      The value of a JSON string, not unescaped
+
+  @return the key image, NULL on error
+*/
+
+static uchar *json_histogram_value(MEM_ROOT *mem_root, Field *field,
+                                   Column_statistics *stats,
+                                   const char *js, int js_len, double *pos)
+{
+  CHARSET_INFO *cs= field->charset();
+  uint buf_len= js_len * cs->mbmaxlen;
+  uchar *buf, *key;
+  int len;
+
+  if (!(buf= (uchar *) alloc_root(mem_root, buf_len + 1)) ||
+      (len= json_unescape(&my_charset_utf8mb4_bin, (const uchar *) js,
+                          (const uchar *) js + js_len, cs,
+                          buf, buf + buf_len)) < 0 ||
+      !(key= (uchar *) alloc_root(mem_root,
+                                  field->key_length() + HA_KEY_BLOB_LENGTH)))
+    return NULL;
+  field->set_notnull();
+  field->store((const char *) buf, len, cs);
+  field->get_key_image(key, field->key_length(), Field::itRAW);
+  *pos= stats->min_max_values_are_provided() ?
+        field->pos_in_interval(stats->min_value, stats->max_value) : 0.0;
+  return key;
+}
+
+
+/* Read a number of the JSON_HB histogram */
+
+static bool json_histogram_number(const char *obj, const char *obj_end,
+                                  const char *name, double *val)
+{
+  const char *js;
+  char *end;
+  int js_len, error;
+  if (json_get_object_key(obj, obj_end, name, &js, &js_len) != JSV_NUMBER)
+    return true;
+  end= (char *) js + js_len;
+  *val= my_strtod(js, &end, &error);
+  return error != 0;
+}
+
+
+/*
+  Iterate over the objects of an array of the JSON_HB histogram
+
+  @return the number of objects, -1 on error
+*/
+
+static int json_histogram_array(const char *js, const char *js_end,
+                                const char *name,
+                                const char **objs, const char **objs_end,
+                                int max_objs)
+{
+  json_engine_t je;
+  const char *arr;
+  int arr_len, n= 0;
+
+  if (json_get_object_key(js, js_end, name, &arr, &arr_len) != JSV_ARRAY)
+    return -1;
+  json_scan_start(&je, &my_charset_utf8mb4_bin, (const uchar *) arr,
+                  (const uchar *) arr + arr_len);
+  if (json_read_value(&je))
+    return -1;
+  while (!json_scan_next(&je) && je.state == JST_VALUE)
+  {
+    if (n == max_objs || json_read_value(&je) ||
+        je.value_type != JSON_VALUE_OBJECT)
+      return -1;
+    objs[n]= (const char *) je.value;
+    if (json_skip_level(&je))
+      return -1;
+    objs_end[n++]= (const char *) je.s.c_str;
+  }
+  return je.s.error ? -1 : n;
+}
+
+
+/*
+  Parse the JSON_HB histogram read into the values
+
+  @param field  The column of a TABLE, its record buffer is used to convert
+                the values into key images
+  @param stats  The statistics of the column with the minimal and the
+                maximal value
+
+  @details
+  The parsed histogram is allocated on mem_root. If the histogram can't be
+  parsed it is not used.
+
+  @retval FALSE OK
+  @retval TRUE  Error
+*/
+
+bool Histogram::parse_json(THD *thd, MEM_ROOT *mem_root, Field *field,
+                           Column_statistics *stats)
+{
+  const char *js= (const char *) values, *js_end= js + size;
+  const char **objs, **objs_end;
+  Histogram_json *hist;
+  int n_objs;
+  bool error= true;
+  /* An object of the arrays takes more than 16 bytes */
+  uint max_objs= size / 16 + 1;
+  TABLE *table= field->table;
+  DBUG_ENTER("Histogram::parse_json");
+
+  json= NULL;
+  if (!(objs= (const char **) alloc_root(thd->mem_root,
+                                         sizeof(char *) * max_objs * 2)) ||
+      !(hist= new (mem_root) Histogram_json))
+    DBUG_RETURN(true);
+  objs_end= objs + max_objs;
+
+  Check_level_instant_set check_level_save(thd, CHECK_FIELD_IGNORE);
+  MY_BITMAP *old_read_map= dbug_tmp_use_all_columns(table, &table->read_set);
+  MY_BITMAP *old_write_map= dbug_tmp_use_all_columns(table,
+                                                     &table->write_set);
+
+  hist->unseen_sel= 1.0;
+  if ((n_objs= json_histogram_array(js, js_end, "buckets", objs, objs_end,
+                                    max_objs)) < 0 ||
+      !(hist->buckets= (Histogram_json::Bucket *)
+        alloc_root(mem_root, sizeof(Histogram_json::Bucket) * (n_objs + 1))))
+    goto end;
+  hist->n_buckets= n_objs;
+  for (int i= 0; i < n_objs; i++)
+  {
+    Histogram_json::Bucket *bucket= hist->buckets + i;
+    const char *val;
+    int val_len;
+    if (json_get_object_key(objs[i], objs_end[i], "start",
+                            &val, &val_len) != JSV_STRING ||
+        !(bucket->start= json_histogram_value(mem_root, field, stats,
+                                              val, val_len,
+                                              &bucket->start_pos)) ||
+        json_get_object_key(objs[i], objs_end[i], "end",
+                            &val, &val_len) != JSV_STRING ||
+        !(bucket->end= json_histogram_value(mem_root, field, stats,
+                                            val, val_len,
+                                            &bucket->end_pos)) ||
+        json_histogram_number(objs[i], objs_end[i], "size", &bucket->size) ||
+        json_histogram_number(objs[i], objs_end[i], "ndv", &bucket->ndv) ||
+        bucket->ndv < 1.0)
+      goto end;
+    set_if_smaller(hist->unseen_sel, bucket->size / bucket->ndv);
+  }
+
+  if ((n_objs= json_histogram_array(js, js_end, "most_common_values",
+                                    objs, objs_end, max_objs)) < 0 ||
+      !(hist->mcvs= (Histogram_json::Common_value *)
+        alloc_root(mem_root,
+                   sizeof(Histogram_json::Common_value) * (n_objs + 1))))
+    goto end;
+  hist->n_mcvs= n_objs;
+  for (int i= 0; i < n_objs; i++)
+  {
+    Histogram_json::Common_value *mcv= hist->mcvs + i;
+    const char *val;
+    int val_len;
+    double pos;
+    if (json_get_object_key(objs[i], objs_end[i], "value",
+                            &val, &val_len) != JSV_STRING ||
+        !(mcv->value= json_histogram_value(mem_root, field, stats,
+                                           val, val_len, &pos)) ||
+        json_histogram_number(objs[i], objs_end[i], "frequency",
+                              &mcv->frequency))
+      goto end;
+    set_if_smaller(hist->unseen_sel, mcv->frequency);
+  }
+  json= hist;
+  error= false;
+
+end:
+  dbug_tmp_restore_column_map(&table->read_set, old_read_map);
+  dbug_tmp_restore_column_map(&table->write_set, old_write_map);
+  DBUG_RETURN(error);
+}
+
+
+/*
+  Estimate selectivity of a range of the column using a histogram
+
+  @param field      The column, its record buffer is used
+  @param min_key    Key image of the left end of the range, NULL if there
+                    is no left end
+  @param min_pos    Position of the left end between column's min_value and
+                    max_value
+  @param max_key    Key image of the right end of the range, NULL if there
+                    is no right end
+  @param max_pos    Position of the right end
+  @param range_flag NEAR_MIN and NEAR_MAX tell that the ends are excluded
+
+  @return
+     Expected selectivity of the range (a number between 0 and 1)
+*/
+
+double Histogram::range_selectivity(Field *field,
+                                    const uchar *min_key, double min_pos,
+                                    const uchar *max_key, double max_pos,
+                                    uint range_flag)
+{
+  double sel;
+  if (type == JSON_HB)
+    return json->range_selectivity(field, min_key, min_pos, max_key, max_pos,
+                                   range_flag);
+  double bucket_sel= 1.0/(get_width() + 1);  
+  uint min= find_bucket(min_pos, TRUE);
+  uint max= find_bucket(max_pos, FALSE);
+  sel= bucket_sel * (max - min + 1);
+  return sel;
+}
+
+
 /*
   Estimate selectivity of "col=const" using a histogram
   
+  @param field    The column
+  @param key      Key image of the "const", used by JSON_HB histograms
   @param pos      Position of the "const" between column's min_value and 
                   max_value.  This is a number in [0..1] range.
   @param avg_sel  Average selectivity of condition "col=const" in this table.
@@ -3881,9 +5555,12 @@ double get_column_range_cardinality(Field *field,
       value.
 */
 
-double Histogram::point_selectivity(double pos, double avg_sel)
+double Histogram::point_selectivity(Field *field, const uchar *key,
+                                    double pos, double avg_sel)
 {
   double sel;
+  if (type == JSON_HB)
+    return json->point_selectivity(field, key, avg_sel);
   /* Find the bucket that contains the value 'pos'. */
   uint min= find_bucket(pos, TRUE);
   uint pos_value= (uint) (pos * prec_factor());
@@ -42,7 +42,8 @@ typedef
 enum enum_histogram_type
 {
   SINGLE_PREC_HB,
-  DOUBLE_PREC_HB
+  DOUBLE_PREC_HB,
+  JSON_HB
 } Histogram_type;
 
 enum enum_stat_tables
@@ -50,12 +51,14 @@ enum enum_stat_tables
   TABLE_STAT,
   COLUMN_STAT,
   INDEX_STAT,
+  COLUMN_GROUP_STAT,
 };
 
 
 /* 
-  These enumeration types comprise the dictionary of three
-  statistical tables table_stat, column_stat and index_stat
+  These enumeration types comprise the dictionary of four
+  statistical tables table_stat, column_stat, index_stat and
+  column_group_stats
   as they defined in ../scripts/mysql_system_tables.sql.
 
   It would be nice if the declarations of these types were
@@ -96,6 +99,19 @@ enum enum_index_stat_col
   INDEX_STAT_N_FIELDS
 };
 
+/* The maximal length of column_group_stats.column_names */
+#define COLUMN_GROUP_NAMES_MAX_LENGTH 255
+
+enum enum_column_group_stat_col
+{
+  COLUMN_GROUP_STAT_DB_NAME,
+  COLUMN_GROUP_STAT_TABLE_NAME,
+  COLUMN_GROUP_STAT_COLUMN_NAMES,
+  COLUMN_GROUP_STAT_AVG_FREQUENCY,
+  COLUMN_GROUP_STAT_DEPENDENCY_DEGREE,
+  COLUMN_GROUP_STAT_N_FIELDS
+};
+
 inline
 Use_stat_tables_mode get_use_stat_tables_mode(THD *thd)
 { 
@@ -115,6 +131,8 @@ bool check_eits_preferred(THD *thd)
           get_use_stat_tables_mode(thd) == PREFERABLY_FOR_QUERIES);
 }
 
+extern Atomic_counter<ulonglong> statistics_version;
+
 int read_statistics_for_tables_if_needed(THD *thd, TABLE_LIST *tables);
 int read_statistics_for_tables(THD *thd, TABLE_LIST *tables);
 int collect_statistics_for_table(THD *thd, TABLE *table);
@@ -132,6 +150,11 @@ int rename_column_in_stat_tables(THD *thd, TABLE *tab, Field *col,
 void set_statistics_for_table(THD *thd, TABLE *table);
 
 double get_column_avg_frequency(Field * field);
+int alloc_column_group_statistics_for_table(THD *thd, TABLE *table,
+                                       List<List<LEX_STRING> > *groups);
+class Column_group_statistics;
+double get_column_group_selectivity(TABLE *table,
+                                    Column_group_statistics *group);
 
 double get_column_range_cardinality(Field *field,
                                     key_range *min_endp,
@@ -140,13 +163,30 @@ double get_column_range_cardinality(Field *field,
 bool is_stat_table(const LEX_CSTRING *db, LEX_CSTRING *table);
 bool is_eits_usable(Field* field);
 
+class Histogram_json;
+class Column_statistics;
+
+/*
+  Histogram of a column
+
+  The height-balanced histograms SINGLE_PREC_HB and DOUBLE_PREC_HB keep the
+  positions of the bucket endpoints between the minimal and the maximal
+  value of the column with a fixed precision.
+  A JSON_HB histogram is a JSON document with equi-depth buckets of real
+  endpoint values and the number of distinct values in every bucket, and
+  with the list of the most common values that are kept out of the buckets.
+  It is parsed into a Histogram_json object when it is read.
+*/
+
 class Histogram
 {
 
 private:
   Histogram_type type;
-  uint8 size; /* Size of values array, in bytes */
+  uint size; /* Size of values array, in bytes */
   uchar *values;
+  uint buckets;         /* Number of buckets of a JSON_HB histogram */
+  Histogram_json *json; /* Parsed JSON_HB histogram */
 
   uint prec_factor()
   {
@@ -155,6 +195,8 @@ class Histogram
       return ((uint) (1 << 8) - 1);
     case DOUBLE_PREC_HB:
       return ((uint) (1 << 16) - 1);
+    case JSON_HB:
+      break;
     }
     return 1;
   }
@@ -167,6 +209,8 @@ class Histogram
       return size;
     case DOUBLE_PREC_HB:
       return size / 2;
+    case JSON_HB:
+      return buckets;
     }
     return 0;
   }
@@ -180,6 +224,8 @@ class Histogram
       return (uint) (((uint8 *) values)[i]);
     case DOUBLE_PREC_HB:
       return (uint) uint2korr(values + i * 2);
+    case JSON_HB:
+      DBUG_ASSERT(0);
     }
     return 0;
   }
@@ -231,13 +277,23 @@ class Histogram
 
   uchar *get_values() { return (uchar *) values; }
 
-  void set_size (ulonglong sz) { size= (uint8) sz; }
+  void set_size (ulonglong sz) { size= (uint) sz; }
 
   void set_type (Histogram_type t) { type= t; }
 
   void set_values (uchar *vals) { values= (uchar *) vals; }
 
-  bool is_available() { return get_size() > 0 && get_values(); }
+  void set_width (uint n) { buckets= n; }
+
+  bool is_available()
+  {
+    if (type == JSON_HB)
+      return json != NULL;
+    return get_size() > 0 && get_values();
+  }
+
+  bool parse_json(THD *thd, MEM_ROOT *mem_root, Field *field,
+                  Column_statistics *stats);
 
   void set_value(uint i, double val)
   {
@@ -248,6 +304,8 @@ class Histogram
     case DOUBLE_PREC_HB:
       int2store(values + i * 2, val * prec_factor());
       return;
+    case JSON_HB:
+      DBUG_ASSERT(0);
     }
   }
 
@@ -260,29 +318,61 @@ class Histogram
     case DOUBLE_PREC_HB:
       int2store(values + i * 2, uint2korr(values + i * 2 - 2));
       return;
+    case JSON_HB:
+      DBUG_ASSERT(0);
     }
   }
 
-  double range_selectivity(double min_pos, double max_pos)
-  {
-    double sel;
-    double bucket_sel= 1.0/(get_width() + 1);  
-    uint min= find_bucket(min_pos, TRUE);
-    uint max= find_bucket(max_pos, FALSE);
-    sel= bucket_sel * (max - min + 1);
-    return sel;
-  } 
+  /*
+    Estimate selectivity of a range of the column using a histogram.
+    The keys are key images of the endpoints, NULL for an open end.
+  */
+  double range_selectivity(Field *field, const uchar *min_key, double min_pos,
+                           const uchar *max_key, double max_pos,
+                           uint range_flag);
   
   /*
     Estimate selectivity of "col=const" using a histogram
   */
-  double point_selectivity(double pos, double avg_sel);
+  double point_selectivity(Field *field, const uchar *key, double pos,
+                           double avg_sel);
 };
 
 
 class Columns_statistics;
 class Index_statistics;
 
+
+/*
+  Statistical data on a group of columns
+
+  A group is defined by the list of its columns in the column
+  column_group_stats.column_names. Its statistics allow to estimate the
+  selectivity of equalities on all columns of the group without assuming
+  that the columns are independent.
+*/
+
+class Column_group_statistics
+{
+public:
+  uint columns;             /* Number of columns in the group        */
+  uint *fieldnr;            /* Field indexes of the columns          */
+  /*
+    Average number of rows with the same values in all columns of the group
+    among the rows without NULLs in them, 0 if unknown
+  */
+  double avg_frequency;
+  /*
+    Share of the rows for which the value of the last column of the group
+    is functionally determined by the values of the other columns, that is,
+    the rows in the groups of equal values of the other columns with one
+    value of the last column. Negative if unknown.
+  */
+  double dependency_degree;
+  Column_group_statistics *next;
+};
+
+
 /* Statistical data on a table */
 
 class Table_statistics
@@ -298,6 +388,7 @@ class Table_statistics
   /* Array of records per key for index prefixes */
   ulonglong *idx_avg_frequency;
   uchar *histograms;                /* Sequence of histograms       */                    
+  Column_group_statistics *column_groups; /* Statistics on column groups */
 };
 
 
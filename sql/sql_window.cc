@@ -1137,7 +1137,8 @@ class Frame_cursor : public Sql_alloc
 };
 
 /*
-  A class that owns cursor objects associated with a specific window function.
+  A class that owns cursor objects associated with a specific window function,
+  or with several window functions that have the same window specification.
 */
 class Cursor_manager
 {
@@ -1147,6 +1148,34 @@ class Cursor_manager
     return cursors.push_back(cursor);
   }
 
+  bool add_window_func(Item_window_func *win_func)
+  {
+    return window_funcs.push_back(win_func);
+  }
+
+  /* All the window functions of the manager share its window specification */
+  Window_spec *window_spec()
+  {
+    return window_funcs.head()->window_spec;
+  }
+
+  /* Make the cursors compute one more window function */
+  void add_sum_func_to_cursors(Item_sum *sum_func)
+  {
+    List_iterator_fast<Frame_cursor> iter(cursors);
+    Frame_cursor *cursor;
+    while ((cursor= iter++))
+      cursor->add_sum_func(sum_func);
+  }
+
+  void clear_window_funcs()
+  {
+    List_iterator_fast<Item_window_func> iter(window_funcs);
+    Item_window_func *win_func;
+    while ((win_func= iter++))
+      win_func->window_func()->clear();
+  }
+
   void initialize_cursors(READ_RECORD *info)
   {
     List_iterator_fast<Frame_cursor> iter(cursors);
@@ -1184,6 +1213,8 @@ class Cursor_manager
 private:
   /* List of the cursors that this manager owns. */
   List<Frame_cursor> cursors;
+  /* Window functions computed by the cursors */
+  List<Item_window_func> window_funcs;
 };
 
 
@@ -2604,6 +2635,41 @@ static bool is_computed_with_remove(Item_sum::Sumfunctype sum_func)
       return true;
   }
 }
+
+
+/*
+  Check if the window function can't remove rows from its value, and the
+  frame has to be scanned for every row.
+*/
+
+static bool is_computed_with_scan(Item_sum *sum_func)
+{
+  return is_computed_with_remove(sum_func->sum_func()) &&
+         !sum_func->supports_removal();
+}
+
+
+/*
+  Check if two window functions can be computed by the same frame cursors.
+  order_window_funcs_by_window_specs() makes equal window specifications
+  share their partition and order lists and their frames.
+*/
+
+static bool can_share_frame_cursors(Item_window_func *win_func1,
+                                    Item_window_func *win_func2)
+{
+  Window_spec *spec1= win_func1->window_spec;
+  Window_spec *spec2= win_func2->window_spec;
+  if (spec1 != spec2 &&
+      (spec1->partition_list != spec2->partition_list ||
+       spec1->order_list != spec2->order_list ||
+       spec1->window_frame != spec2->window_frame))
+    return false;
+  return is_computed_with_scan(win_func1->window_func()) ==
+         is_computed_with_scan(win_func2->window_func());
+}
+
+
 /*
    Create required frame cursors for the list of window functions.
    Register all functions to their appropriate cursors.
@@ -2618,10 +2684,26 @@ void get_window_functions_required_cursors(
   List_iterator_fast<Item_window_func> it(window_functions);
   Item_window_func* item_win_func;
   Item_sum *sum_func;
+  /* The last window function that uses the regular frame cursors */
+  Item_window_func *shared_win_func= NULL;
+  Cursor_manager *shared_cursor_manager= NULL;
   while ((item_win_func= it++))
   {
-    Cursor_manager *cursor_manager = new Cursor_manager();
     sum_func = item_win_func->window_func();
+    if (shared_win_func &&
+        !item_win_func->requires_partition_size() &&
+        !item_win_func->is_frame_prohibited() &&
+        !item_win_func->requires_special_cursors() &&
+        can_share_frame_cursors(shared_win_func, item_win_func))
+    {
+      shared_cursor_manager->add_window_func(item_win_func);
+      shared_cursor_manager->add_sum_func_to_cursors(sum_func);
+      continue;
+    }
+    shared_win_func= NULL;
+
+    Cursor_manager *cursor_manager = new Cursor_manager();
+    cursor_manager->add_window_func(item_win_func);
     Frame_cursor *fc;
     /*
       Some window functions require the partition size for computing values.
@@ -2682,8 +2764,7 @@ void get_window_functions_required_cursors(
     */
     cursor_manager->add_cursor(frame_bottom);
     cursor_manager->add_cursor(frame_top);
-    if (is_computed_with_remove(sum_func->sum_func()) &&
-        !sum_func->supports_removal())
+    if (is_computed_with_scan(sum_func))
     {
       frame_bottom->set_no_action();
       frame_top->set_no_action();
@@ -2694,6 +2775,11 @@ void get_window_functions_required_cursors(
 
     }
     cursor_managers->push_back(cursor_manager);
+    if (!item_win_func->requires_partition_size())
+    {
+      shared_win_func= item_win_func;
+      shared_cursor_manager= cursor_manager;
+    }
   }
 }
 
@@ -2788,7 +2874,6 @@ bool compute_window_func(THD *thd,
                          TABLE *tbl,
                          SORT_INFO *filesort_result)
 {
-  List_iterator_fast<Item_window_func> iter_win_funcs(window_functions);
   List_iterator_fast<Cursor_manager> iter_cursor_managers(cursor_managers);
   uint err;
 
@@ -2802,13 +2887,13 @@ bool compute_window_func(THD *thd,
   while ((cursor_manager= iter_cursor_managers++))
     cursor_manager->initialize_cursors(&info);
 
-  /* One partition tracker for each window function. */
+  /* One partition tracker for each cursor manager. */
   List<Group_bound_tracker> partition_trackers;
-  Item_window_func *win_func;
-  while ((win_func= iter_win_funcs++))
+  iter_cursor_managers.rewind();
+  while ((cursor_manager= iter_cursor_managers++))
   {
     Group_bound_tracker *tracker= new Group_bound_tracker(thd,
-                                        win_func->window_spec->partition_list);
+                                  cursor_manager->window_spec()->partition_list);
     // TODO(cvicentiu) This should be removed and placed in constructor.
     tracker->init();
     partition_trackers.push_back(tracker);
@@ -2828,20 +2913,18 @@ bool compute_window_func(THD *thd,
     tbl->file->position(tbl->record[0]);
     memcpy(rowid_buf, tbl->file->ref, tbl->file->ref_length);
 
-    iter_win_funcs.rewind();
     iter_part_trackers.rewind();
     iter_cursor_managers.rewind();
 
     Group_bound_tracker *tracker;
-    while ((win_func= iter_win_funcs++) &&
-           (tracker= iter_part_trackers++) &&
+    while ((tracker= iter_part_trackers++) &&
            (cursor_manager= iter_cursor_managers++))
     {
       if (tracker->check_if_next_group() || (rownum == 0))
       {
         /* TODO(cvicentiu)
            Clearing window functions should happen through cursors. */
-        win_func->window_func()->clear();
+        cursor_manager->clear_window_funcs();
         cursor_manager->notify_cursors_partition_changed(rownum);
       }
       else
@@ -2944,6 +3027,10 @@ bool Window_func_runner::add_function_to_run(Item_window_func *win_func)
       my_error(ER_NOT_SUPPORTED_YET, MYF(0),
                "JSON_OBJECTAGG() aggregate as window function");
       return true;
+    case Item_sum::APPROX_COUNT_DISTINCT_FUNC:
+      my_error(ER_NOT_SUPPORTED_YET, MYF(0),
+               "APPROX_COUNT_DISTINCT() aggregate as window function");
+      return true;
     default:
       break;
   }
@@ -441,6 +441,7 @@ End SQL_MODE_ORACLE_SPECIFIC */
 %token  <kwd> ALTER                         /* SQL-2003-R */
 %token  <kwd> ANALYZE_SYM
 %token  <kwd> AND_SYM                       /* SQL-2003-R */
+%token  <kwd> APPROX_COUNT_DISTINCT_SYM
 %token  <kwd> ASC                           /* SQL-2003-N */
 %token  <kwd> ASENSITIVE_SYM                /* FUTURE-USE */
 %token  <kwd> AS                            /* SQL-2003-R */
@@ -1622,6 +1623,7 @@ End SQL_MODE_ORACLE_SPECIFIC */
         opt_persistent_stat_clause persistent_stat_spec
         persistent_column_stat_spec persistent_index_stat_spec
         table_column_list table_index_list table_index_name
+        table_column_group table_column_group_list
         check start checksum opt_returning
         field_list field_list_item kill key_def constraint_def
         keycache_list keycache_list_or_parts assign_to_keycache
@@ -8246,6 +8248,41 @@ table_column_list:
             Lex->column_list->push_back((LEX_STRING*)
                 thd->memdup(&$3, sizeof(LEX_STRING)), thd->mem_root);
           }
+        | table_column_group
+        | table_column_list ',' table_column_group
+        ;
+
+table_column_group:
+          '('
+          {
+            LEX *lex= thd->lex;
+            List<LEX_STRING> *group= new (thd->mem_root) List<LEX_STRING>;
+            if (unlikely(group == NULL))
+              MYSQL_YYABORT;
+            if (!lex->column_group_list &&
+                unlikely(!(lex->column_group_list=
+                           new (thd->mem_root) List<List<LEX_STRING> >)))
+              MYSQL_YYABORT;
+            if (unlikely(lex->column_group_list->push_front(group,
+                                                            thd->mem_root)))
+              MYSQL_YYABORT;
+          }
+          table_column_group_list
+          ')'
+          { }
+        ;
+
+table_column_group_list:
+          ident
+          {
+            Lex->column_group_list->head()->push_back((LEX_STRING*)
+                thd->memdup(&$1, sizeof(LEX_STRING)), thd->mem_root);
+          }
+        | table_column_group_list ',' ident
+          {
+            Lex->column_group_list->head()->push_back((LEX_STRING*)
+                thd->memdup(&$3, sizeof(LEX_STRING)), thd->mem_root);
+          }
         ;
 
 table_index_list:
@@ -10767,6 +10804,12 @@ sum_expr:
             if (unlikely($$ == NULL))
               MYSQL_YYABORT;
           }
+        | APPROX_COUNT_DISTINCT_SYM '(' in_sum_expr ')'
+          {
+            $$= new (thd->mem_root) Item_sum_approx_count_distinct(thd, $3);
+            if (unlikely($$ == NULL))
+              MYSQL_YYABORT;
+          }
         | BIT_AND  '(' in_sum_expr ')'
           {
             $$= new (thd->mem_root) Item_sum_and(thd, $3);
@@ -15865,6 +15908,7 @@ reserved_keyword_udt_not_param_type:
         | ALTER
         | ANALYZE_SYM
         | AND_SYM
+        | APPROX_COUNT_DISTINCT_SYM
         | AS
         | ASC
         | ASENSITIVE_SYM
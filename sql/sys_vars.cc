@@ -64,6 +64,7 @@
 #include "rpl_parallel.h"
 #include "semisync_master.h"
 #include "semisync_slave.h"
+#include "sql_plan_cache.h"
 #include <ssl_compat.h>
 
 #define PCRE2_STATIC 1             /* Important on Windows */
@@ -442,6 +443,16 @@ static Sys_var_double Sys_analyze_sample_percentage(
        CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 100),
        DEFAULT(100));
 
+static Sys_var_ulong Sys_analyze_hll_precision(
+       "analyze_hll_precision",
+       "When ANALYZE TABLE reads all rows of the table, estimate the number "
+       "of distinct values of the columns without histograms with "
+       "HyperLogLog sketches of 2^N registers instead of counting them "
+       "exactly. Values from 1 to 3 mean 4. "
+       "Set to 0 to count the distinct values exactly.",
+       SESSION_VAR(analyze_hll_precision), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 18), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_auto_increment_increment(
        "auto_increment_increment",
        "Auto-increment columns are incremented by this",
@@ -3564,6 +3575,31 @@ static Sys_var_ulonglong Sys_sort_buffer(
        VALID_RANGE(MIN_SORT_MEMORY, SIZE_T_MAX), DEFAULT(MAX_SORT_MEMORY),
        BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_sort_threads(
+       "sort_threads",
+       "Number of threads that sort the sort buffer of a filesort in "
+       "parallel. The buffer is split between the threads only if each of "
+       "them gets at least 8192 keys to sort",
+       SESSION_VAR(sort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, MAX_SORT_THREADS), DEFAULT(1), BLOCK_SIZE(1));
+
+static Sys_var_ulonglong Sys_hash_aggregation_buffer_size(
+       "hash_aggregation_buffer_size",
+       "The size of the in-memory hash table that GROUP BY uses to "
+       "aggregate groups before they are written into the temporary table. "
+       "When the hash table is full, partitions of the groups are moved "
+       "into the temporary table. 0 disables hash aggregation",
+       SESSION_VAR(hash_aggr_buff_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, SIZE_T_MAX), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulonglong Sys_subquery_cache_hash_size(
+       "subquery_cache_hash_size",
+       "The memory bound of the in-memory hash table that caches the "
+       "results of a subquery. When it is full, the least recently used "
+       "result is replaced. 0 caches the results in a temporary table",
+       SESSION_VAR(subquery_cache_hash_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, SIZE_T_MAX), DEFAULT(0), BLOCK_SIZE(1));
+
 export sql_mode_t expand_sql_mode(sql_mode_t sql_mode)
 {
   if (sql_mode & MODE_ANSI)
@@ -6341,6 +6377,21 @@ static Sys_var_ulong Sys_join_cache_level(
        SESSION_VAR(join_cache_level), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, 8), DEFAULT(2), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_join_cache_spill_partitions(
+       "join_cache_spill_partitions",
+       "Number of partitions into which a hash join spills both its inputs "
+       "on disk when they do not fit into the join buffer. The partitions "
+       "are then joined pairwise in the buffer. 0 disables spilling",
+       SESSION_VAR(join_cache_spill_partitions), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 256), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_mybool Sys_join_cache_bloom_filter(
+       "join_cache_bloom_filter",
+       "Build a Bloom filter over the join keys put into the buffer of a "
+       "hash join and skip the rows of the joined table whose keys are "
+       "rejected by the filter before their other conditions are checked",
+       SESSION_VAR(join_cache_bloom_filter), CMD_LINE(OPT_ARG), DEFAULT(TRUE));
+
 static Sys_var_ulong Sys_mrr_buffer_size(
        "mrr_buffer_size",
        "Size of buffer to use when using MRR with range access",
@@ -6405,7 +6456,8 @@ static Sys_var_enum Sys_optimizer_use_stat_tables(
 
 static Sys_var_ulong Sys_histogram_size(
        "histogram_size",
-       "Number of bytes used for a histogram. "
+       "Number of bytes used for a histogram, or the number of buckets "
+       "of a JSON_HB histogram. "
        "If set to 0, no histograms are created by ANALYZE.",
        SESSION_VAR(histogram_size), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, 255), DEFAULT(254), BLOCK_SIZE(1));
@@ -6416,7 +6468,8 @@ static Sys_var_enum Sys_histogram_type(
        "Specifies type of the histograms created by ANALYZE. "
        "Possible values are: "
        "SINGLE_PREC_HB - single precision height-balanced, "
-       "DOUBLE_PREC_HB - double precision height-balanced.",
+       "DOUBLE_PREC_HB - double precision height-balanced, "
+       "JSON_HB - equi-depth buckets and the most common values in JSON.",
        SESSION_VAR(histogram_type), CMD_LINE(REQUIRED_ARG),
        histogram_types, DEFAULT(1));
 
@@ -6698,6 +6751,54 @@ static Sys_var_ulong Sys_optimizer_max_sel_arg_weight(
        SESSION_VAR(optimizer_max_sel_arg_weight), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, ULONG_MAX), DEFAULT(SEL_ARG::MAX_WEIGHT), BLOCK_SIZE(1));
 
+static Sys_var_mybool Sys_optimizer_join_partition_pruning(
+       "optimizer_join_partition_pruning",
+       "Scan only the partitions of a table joined by a full scan that the "
+       "values of the previous tables, equal to the fields of the "
+       "partitioning function, fall into",
+       SESSION_VAR(optimizer_join_partition_pruning), CMD_LINE(OPT_ARG),
+       DEFAULT(TRUE));
+
+static Sys_var_mybool Sys_optimizer_plan_cache(
+       "optimizer_plan_cache",
+       "Reuse the join order chosen for a SELECT of a prepared statement or "
+       "of a stored routine in its later executions as long as the tables, "
+       "their statistics and the estimated numbers of rows do not change",
+       SESSION_VAR(optimizer_plan_cache), CMD_LINE(OPT_ARG), DEFAULT(TRUE));
+
+static Sys_var_ulong Sys_optimizer_join_dp_limit(
+       "optimizer_join_dp_limit",
+       "The search for the best join order skips the partial plans that are "
+       "more expensive and produce more rows than a plan over the same "
+       "tables. Joins of more tables than this are optimized by the greedy "
+       "search with optimizer_search_depth limited to this value. 0 "
+       "disables both",
+       SESSION_VAR(optimizer_join_dp_limit), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, MAX_TABLES), DEFAULT(10), BLOCK_SIZE(1));
+
+static Sys_var_mybool Sys_optimizer_skip_scan(
+       "optimizer_skip_scan",
+       "Allow a range scan on a later part of a covering index, repeated "
+       "for every distinct value of the leading key parts that have no "
+       "condition",
+       SESSION_VAR(optimizer_skip_scan), CMD_LINE(OPT_ARG), DEFAULT(TRUE));
+
+static bool fix_optimizer_plan_cache_size(sys_var *, THD *, enum_var_type)
+{
+  digest_plan_cache_resize();
+  return false;
+}
+static Sys_var_ulong Sys_optimizer_plan_cache_size(
+       "optimizer_plan_cache_size",
+       "Number of join orders of non-prepared statements kept by the digest "
+       "of the statement, to be reused by the statements with the same "
+       "digest in the sessions with optimizer_plan_cache on. 0 disables the "
+       "cache",
+       GLOBAL_VAR(digest_plan_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024), DEFAULT(0), BLOCK_SIZE(1),
+       NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(fix_optimizer_plan_cache_size));
+
 static Sys_var_enum Sys_secure_timestamp(
        "secure_timestamp", "Restricts direct setting of a session "
        "timestamp. Possible levels are: YES - timestamp cannot deviate from "
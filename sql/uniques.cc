@@ -38,6 +38,7 @@
 #include "queues.h"                             // QUEUE
 #include "my_tree.h"                            // element_count
 #include "uniques.h"	                        // Unique
+#include "sql_base.h"                            // simple_raw_key_cmp
 #include "sql_sort.h"
 
 int unique_write_to_file(uchar* key, element_count count, Unique *unique)
@@ -831,3 +832,295 @@ bool Unique::get(TABLE *table)
   my_free(sort_buffer);  
   DBUG_RETURN(rc);
 }
+
+
+/*
+  Unique_hash
+*/
+
+/* Number of entries of the hash set before its first resize */
+#define UNIQUE_HASH_MIN_ENTRIES 1024
+
+Unique_hash::Unique_hash(uint size_arg, size_t max_in_memory_size_arg)
+  :size(size_arg), max_in_memory_size(max_in_memory_size_arg),
+   keys(NULL), tags(NULL), capacity(0), elements(0), spilled(false)
+{
+  for (uint i= 0; i < PARTITIONS; i++)
+    my_b_clear(&files[i]);
+}
+
+
+Unique_hash::~Unique_hash()
+{
+  my_free(keys);
+  my_free(tags);
+  for (uint i= 0; i < PARTITIONS; i++)
+    close_cached_file(&files[i]);
+}
+
+
+ulonglong Unique_hash::hash_key(const uchar *key, uint length)
+{
+  ulonglong hash= 0xcbf29ce484222325ULL ^ length;
+  for (; length >= 8; key+= 8, length-= 8)
+  {
+    hash^= uint8korr(key);
+    hash*= 0x9e3779b97f4a7c15ULL;
+    hash^= hash >> 29;
+  }
+  for (; length; key++, length--)
+    hash= (hash ^ *key) * 0x100000001b3ULL;
+  /* Make every bit of the result depend on every byte of the key */
+  hash^= hash >> 33;
+  hash*= 0xff51afd7ed558ccdULL;
+  hash^= hash >> 33;
+  hash*= 0xc4ceb9fe1a85ec53ULL;
+  hash^= hash >> 33;
+  return hash;
+}
+
+
+/*
+  Insert a key into the hash set
+
+  RETURN
+    INSERTED      The key was added
+    FOUND         The key was in the set already
+    FULL          The key is new, but the set can't grow any more
+    INSERT_ERROR  Out of memory
+*/
+
+Unique_hash::insert_result Unique_hash::insert(const uchar *key)
+{
+  ulonglong hash= hash_key(key, size);
+  uint32 key_tag= tag(hash);
+  ulong idx= 0;
+
+  if (capacity)
+  {
+    ulong mask= capacity - 1;
+    for (idx= (ulong) hash & mask; tags[idx]; idx= (idx + 1) & mask)
+    {
+      if (tags[idx] == key_tag && !memcmp(keys + (size_t) idx * size, key, size))
+        return FOUND;
+    }
+  }
+  /* Keep the load factor below 3/4 */
+  if ((ulonglong) (elements + 1) * 4 > (ulonglong) capacity * 3)
+  {
+    ulong new_capacity= capacity ? capacity * 2 : UNIQUE_HASH_MIN_ENTRIES;
+    if (capacity &&
+        (ulonglong) new_capacity * (size + sizeof(uint32)) > max_in_memory_size)
+      return FULL;
+    if (resize(new_capacity))
+      return INSERT_ERROR;
+    ulong mask= capacity - 1;
+    for (idx= (ulong) hash & mask; tags[idx]; idx= (idx + 1) & mask)
+    {}
+  }
+  tags[idx]= key_tag;
+  memcpy(keys + (size_t) idx * size, key, size);
+  elements++;
+  return INSERTED;
+}
+
+
+bool Unique_hash::resize(ulong new_capacity)
+{
+  uchar *new_keys;
+  uint32 *new_tags;
+  ulong mask= new_capacity - 1;
+
+  if (!(new_keys= (uchar*) my_malloc(PSI_INSTRUMENT_ME,
+                                     (size_t) new_capacity * size,
+                                     MYF(MY_WME | MY_THREAD_SPECIFIC))) ||
+      !(new_tags= (uint32*) my_malloc(PSI_INSTRUMENT_ME,
+                                      new_capacity * sizeof(uint32),
+                                      MYF(MY_WME | MY_THREAD_SPECIFIC |
+                                          MY_ZEROFILL))))
+  {
+    my_free(new_keys);
+    return true;
+  }
+  for (ulong i= 0; i < capacity; i++)
+  {
+    if (!tags[i])
+      continue;
+    uchar *key= keys + (size_t) i * size;
+    ulong idx;
+    for (idx= (ulong) hash_key(key, size) & mask; new_tags[idx];
+         idx= (idx + 1) & mask)
+    {}
+    new_tags[idx]= tags[i];
+    memcpy(new_keys + (size_t) idx * size, key, size);
+  }
+  my_free(keys);
+  my_free(tags);
+  keys= new_keys;
+  tags= new_tags;
+  capacity= new_capacity;
+  return false;
+}
+
+
+void Unique_hash::clear_set()
+{
+  if (elements)
+    bzero(tags, capacity * sizeof(uint32));
+  elements= 0;
+}
+
+
+/*
+  Write all keys of the set into the partition files and empty the set.
+  The top 4 bits of the hash value of a key select its partition.
+*/
+
+bool Unique_hash::spill()
+{
+  if (!my_b_inited(&files[0]))
+  {
+    for (uint i= 0; i < PARTITIONS; i++)
+    {
+      if (open_cached_file(&files[i], mysql_tmpdir, TEMP_PREFIX,
+                           DISK_BUFFER_SIZE, MYF(MY_WME)))
+        return true;
+    }
+  }
+  spilled= true;
+  for (ulong idx= 0; idx < capacity; idx++)
+  {
+    if (tags[idx] &&
+        my_b_write(&files[tags[idx] >> 28], keys + (size_t) idx * size, size))
+      return true;
+  }
+  clear_set();
+  return false;
+}
+
+
+bool Unique_hash::unique_add(const uchar *key)
+{
+  switch (insert(key)) {
+  case INSERTED:
+  case FOUND:
+    return false;
+  case FULL:
+    return spill() || insert(key) == INSERT_ERROR;
+  case INSERT_ERROR:
+    break;
+  }
+  return true;
+}
+
+
+bool Unique_hash::walk_set(tree_walk_action action, void *walk_action_arg)
+{
+  for (ulong idx= 0; idx < capacity; idx++)
+  {
+    if (tags[idx] &&
+        action(keys + (size_t) idx * size, 1, walk_action_arg))
+      return true;
+  }
+  return false;
+}
+
+
+static int unique_add_action(void *key, element_count count, void *unique)
+{
+  return ((Unique*) unique)->unique_add(key);
+}
+
+
+/*
+  Read back the keys of one partition and walk the distinct ones.
+  Equal keys always land in the same partition, so the partitions can
+  be processed independently. If the distinct keys of the partition don't
+  fit into the set, they are passed through Unique instead.
+*/
+
+bool Unique_hash::walk_partition(TABLE *table, IO_CACHE *file,
+                                 tree_walk_action action,
+                                 void *walk_action_arg)
+{
+  Unique *tree= NULL;
+  uchar *buff;
+  bool res= true;
+  my_off_t count= my_b_tell(file) / size;
+
+  if (!count)
+    return false;
+  if (!(buff= (uchar*) my_malloc(PSI_INSTRUMENT_ME, size,
+                                 MYF(MY_WME | MY_THREAD_SPECIFIC))))
+    return true;
+  if (flush_io_cache(file) || reinit_io_cache(file, READ_CACHE, 0L, 0, 0))
+    goto err;
+  clear_set();
+  for (; count; count--)
+  {
+    if (my_b_read(file, buff, size))
+      goto err;
+    if (tree)
+    {
+      if (tree->unique_add(buff))
+        goto err;
+      continue;
+    }
+    switch (insert(buff)) {
+    case INSERTED:
+    case FOUND:
+      break;
+    case FULL:
+      if (!(tree= new Unique(simple_raw_key_cmp, &size, size,
+                             max_in_memory_size)))
+        goto err;
+      if (walk_set(unique_add_action, tree) ||
+          tree->unique_add(buff))
+        goto err;
+      clear_set();
+      break;
+    case INSERT_ERROR:
+      goto err;
+    }
+  }
+  res= tree ? tree->walk(table, action, walk_action_arg) :
+              walk_set(action, walk_action_arg);
+err:
+  delete tree;
+  my_free(buff);
+  return res;
+}
+
+
+/*
+  Walk all distinct keys
+
+  Unlike Unique::walk(), the keys are walked in no particular order.
+*/
+
+bool Unique_hash::walk(TABLE *table, tree_walk_action action,
+                       void *walk_action_arg)
+{
+  if (!spilled)
+    return walk_set(action, walk_action_arg);
+  if (spill())
+    return true;
+  for (uint i= 0; i < PARTITIONS; i++)
+  {
+    if (walk_partition(table, &files[i], action, walk_action_arg))
+      return true;
+  }
+  return false;
+}
+
+
+void Unique_hash::reset()
+{
+  clear_set();
+  if (spilled)
+  {
+    for (uint i= 0; i < PARTITIONS; i++)
+      reinit_io_cache(&files[i], WRITE_CACHE, 0L, 0, 1);
+    spilled= false;
+  }
+}
@@ -107,4 +107,60 @@ class Unique :public Sql_alloc
 				            Unique *unique);
 };
 
+
+/*
+   Unique_hash -- removing of duplicates of fixed length keys that can be
+   compared as binary strings.
+   Puts all values into an open addressing hash set. If the set becomes too
+   big, its keys are written into one of PARTITIONS files selected by the
+   high bits of their hash values, and the set is emptied. When the values
+   are walked, the files are read back one partition at a time, so that a
+   partition has to fit into memory only on its own. A partition that
+   still doesn't fit is passed through Unique.
+   The values are walked in no particular order.
+ */
+
+class Unique_hash :public Sql_alloc
+{
+public:
+  static const uint PARTITIONS= 16;
+
+  Unique_hash(uint size_arg, size_t max_in_memory_size_arg);
+  ~Unique_hash();
+
+  /* Returns true on error */
+  bool unique_add(const uchar *key);
+  bool is_in_memory() const { return !spilled; }
+  ulong elements_in_set() const { return elements; }
+  bool walk(TABLE *table, tree_walk_action action, void *walk_action_arg);
+  void reset();
+
+private:
+  enum insert_result { INSERTED, FOUND, FULL, INSERT_ERROR };
+
+  uint size;
+  size_t max_in_memory_size;
+  /*
+    The keys are stored in keys[], the entry is empty if its tag is 0.
+    A tag holds the high bits of the hash value, to skip most of the
+    comparisons of different keys.
+  */
+  uchar *keys;
+  uint32 *tags;
+  ulong capacity;                               // A power of 2
+  ulong elements;
+  bool spilled;
+  IO_CACHE files[PARTITIONS];
+
+  static ulonglong hash_key(const uchar *key, uint length);
+  static uint32 tag(ulonglong hash) { return (uint32) (hash >> 32) | 1; }
+  insert_result insert(const uchar *key);
+  bool resize(ulong new_capacity);
+  void clear_set();
+  bool spill();
+  bool walk_set(tree_walk_action action, void *walk_action_arg);
+  bool walk_partition(TABLE *table, IO_CACHE *file, tree_walk_action action,
+                      void *walk_action_arg);
+};
+
 #endif /* UNIQUE_INCLUDED */
@@ -166,20 +166,40 @@ static int check_one_rb_key(const HP_INFO *info, uint keynr, ulong records,
 			    my_bool print_status)
 {
   HP_KEYDEF *keydef= info->s->keydef + keynr;
+  HP_BTREE *bt= &keydef->btree;
+  HP_BTREE_NODE *leaf, *prev_leaf= 0;
   int error= 0;
   ulong found= 0;
-  uchar *key, *recpos;
-  uint key_length;
+  uchar *key, *recpos, *prev_key= 0;
+  uint key_length, i;
   uint not_used[2];
-  TREE_ELEMENT **last_pos;
-  TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1];
-  
-  if ((key= tree_search_edge(&keydef->rb_tree, parents,
-			     &last_pos, offsetof(TREE_ELEMENT, left))))
+
+  if ((leaf= bt->root))
+  {
+    while (leaf->level)
+      leaf= hp_bt_children(bt, leaf)[0];
+  }
+  for (; leaf; prev_leaf= leaf, leaf= leaf->next)
   {
-    do
+    if (leaf->prev != prev_leaf)
     {
-      memcpy(&recpos, key + (*keydef->get_key_length)(keydef,key), sizeof(uchar*));
+      error= 1;
+      DBUG_PRINT("error",("Wrong leaf link: key: %u", keynr));
+    }
+    for (i= 0; i < leaf->keys; i++)
+    {
+      key= hp_bt_key(bt, leaf, i);
+      key_length= (*keydef->get_key_length)(keydef, key);
+      memcpy(&recpos, key + key_length, sizeof(uchar*));
+      if (prev_key &&
+          ha_key_cmp(keydef->seg, prev_key, key, key_length, SEARCH_SAME,
+                     not_used) >= 0)
+      {
+	error= 1;
+	DBUG_PRINT("error",("Key out of order:  key: %u  Record: %p\n",
+			    keynr, recpos));
+      }
+      prev_key= key;
       key_length= hp_rb_make_key(keydef, info->recbuf, recpos, 0);
       if (ha_key_cmp(keydef->seg, (uchar*) info->recbuf, (uchar*) key,
 		     key_length, SEARCH_FIND | SEARCH_SAME, not_used))
@@ -190,10 +210,12 @@ static int check_one_rb_key(const HP_INFO *info, uint keynr, ulong records,
       }
       else
 	found++;
-      key= tree_search_next(&keydef->rb_tree, &last_pos,
-			    offsetof(TREE_ELEMENT, left), 
-			    offsetof(TREE_ELEMENT, right));
-    } while (key);
+    }
+  }
+  if (found != bt->records)
+  {
+    DBUG_PRINT("error",("Found %lu of %lu keys", found, (ulong) bt->records));
+    error= 1;
   }
   if (found != records)
   {
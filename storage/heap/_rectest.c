@@ -23,7 +23,8 @@ int hp_rectest(register HP_INFO *info, register const uchar *old)
 {
   DBUG_ENTER("hp_rectest");
 
-  if (memcmp(info->current_ptr,old,(size_t) info->s->reclength))
+  if (info->s->blobs ? hp_rec_blob_cmp(info->s, info->current_ptr, old) :
+      memcmp(info->current_ptr,old,(size_t) info->s->reclength))
   {
     DBUG_RETURN((my_errno=HA_ERR_RECORD_CHANGED)); /* Record have changed */
   }
@@ -42,6 +42,31 @@ static int heap_drop_table(handlerton *hton, const char *path)
   return error == ENOENT ? -1 : error;
 }
 
+
+/*
+  INSERT can run while other threads read the table (see hp_create.c).
+  Reads share HP_SHARE::latch, changes of rows and keys take it
+  exclusively. Internal temporary tables are used by one thread only.
+*/
+
+static inline void heap_read_latch(HP_INFO *file)
+{
+  if (file->s->concurrent_insert)
+    mysql_rwlock_rdlock(&file->s->latch);
+}
+
+static inline void heap_write_latch(HP_INFO *file)
+{
+  if (file->s->concurrent_insert)
+    mysql_rwlock_wrlock(&file->s->latch);
+}
+
+static inline void heap_unlatch(HP_INFO *file)
+{
+  if (file->s->concurrent_insert)
+    mysql_rwlock_unlock(&file->s->latch);
+}
+
 int heap_init(void *p)
 {
   handlerton *heap_hton;
@@ -236,23 +261,26 @@ int ha_heap::write_row(const uchar * buf)
     if ((res= update_auto_increment()))
       return res;
   }
+  heap_write_latch(file);
   res= heap_write(file,buf);
   if (!res && (++records_changed*HEAP_STATS_UPDATE_THRESHOLD > 
                file->s->records))
   {
     /*
-       We can perform this safely since only one writer at the time is
-       allowed on the table.
+       We can perform this safely as concurrent inserts are serialized
+       by the latch.
     */
     records_changed= 0;
     file->s->key_stat_version++;
   }
+  heap_unlatch(file);
   return res;
 }
 
 int ha_heap::update_row(const uchar * old_data, const uchar * new_data)
 {
   int res;
+  heap_write_latch(file);
   res= heap_update(file,old_data,new_data);
   if (!res && ++records_changed*HEAP_STATS_UPDATE_THRESHOLD > 
               file->s->records)
@@ -264,12 +292,14 @@ int ha_heap::update_row(const uchar * old_data, const uchar * new_data)
     records_changed= 0;
     file->s->key_stat_version++;
   }
+  heap_unlatch(file);
   return res;
 }
 
 int ha_heap::delete_row(const uchar * buf)
 {
   int res;
+  heap_write_latch(file);
   res= heap_delete(file,buf);
   if (!res && table->s->tmp_table == NO_TMP_TABLE && 
       ++records_changed*HEAP_STATS_UPDATE_THRESHOLD > file->s->records)
@@ -281,6 +311,7 @@ int ha_heap::delete_row(const uchar * buf)
     records_changed= 0;
     file->s->key_stat_version++;
   }
+  heap_unlatch(file);
   return res;
 }
 
@@ -289,7 +320,9 @@ int ha_heap::index_read_map(uchar *buf, const uchar *key,
                             enum ha_rkey_function find_flag)
 {
   DBUG_ASSERT(inited==INDEX);
+  heap_read_latch(file);
   int error = heap_rkey(file,buf,active_index, key, keypart_map, find_flag);
+  heap_unlatch(file);
   return error;
 }
 
@@ -297,8 +330,10 @@ int ha_heap::index_read_last_map(uchar *buf, const uchar *key,
                                  key_part_map keypart_map)
 {
   DBUG_ASSERT(inited==INDEX);
+  heap_read_latch(file);
   int error= heap_rkey(file, buf, active_index, key, keypart_map,
 		       HA_READ_PREFIX_LAST);
+  heap_unlatch(file);
   return error;
 }
 
@@ -306,35 +341,45 @@ int ha_heap::index_read_idx_map(uchar *buf, uint index, const uchar *key,
                                 key_part_map keypart_map,
                                 enum ha_rkey_function find_flag)
 {
+  heap_read_latch(file);
   int error = heap_rkey(file, buf, index, key, keypart_map, find_flag);
+  heap_unlatch(file);
   return error;
 }
 
 int ha_heap::index_next(uchar * buf)
 {
   DBUG_ASSERT(inited==INDEX);
+  heap_read_latch(file);
   int error=heap_rnext(file,buf);
+  heap_unlatch(file);
   return error;
 }
 
 int ha_heap::index_prev(uchar * buf)
 {
   DBUG_ASSERT(inited==INDEX);
+  heap_read_latch(file);
   int error=heap_rprev(file,buf);
+  heap_unlatch(file);
   return error;
 }
 
 int ha_heap::index_first(uchar * buf)
 {
   DBUG_ASSERT(inited==INDEX);
+  heap_read_latch(file);
   int error=heap_rfirst(file, buf, active_index);
+  heap_unlatch(file);
   return error;
 }
 
 int ha_heap::index_last(uchar * buf)
 {
   DBUG_ASSERT(inited==INDEX);
+  heap_read_latch(file);
   int error=heap_rlast(file, buf, active_index);
+  heap_unlatch(file);
   return error;
 }
 
@@ -345,7 +390,9 @@ int ha_heap::rnd_init(bool scan)
 
 int ha_heap::rnd_next(uchar *buf)
 {
+  heap_read_latch(file);
   int error=heap_scan(file, buf);
+  heap_unlatch(file);
   return error;
 }
 
@@ -354,7 +401,9 @@ int ha_heap::rnd_pos(uchar * buf, uchar *pos)
   int error;
   HEAP_PTR heap_position;
   memcpy(&heap_position, pos, sizeof(HEAP_PTR));
+  heap_read_latch(file);
   error=heap_rrnd(file, buf, heap_position);
+  heap_unlatch(file);
   return error;
 }
 
@@ -367,6 +416,7 @@ int ha_heap::info(uint flag)
 {
   HEAPINFO hp_info;
 
+  heap_read_latch(file);
   (void) heap_info(file,&hp_info,flag);
 
   errkey=                     hp_info.errkey;
@@ -387,6 +437,7 @@ int ha_heap::info(uint flag)
   */
   if (key_stat_version != file->s->key_stat_version)
     update_key_stats();
+  heap_unlatch(file);
   return 0;
 }
 
@@ -405,7 +456,9 @@ int ha_heap::reset()
 
 int ha_heap::delete_all_rows()
 {
+  heap_write_latch(file);
   heap_clear(file);
+  heap_unlatch(file);
   if (table->s->tmp_table == NO_TMP_TABLE)
   {
     /*
@@ -428,8 +481,15 @@ int ha_heap::reset_auto_increment(ulonglong value)
 int ha_heap::external_lock(THD *thd, int lock_type)
 {
 #ifndef DBUG_OFF
-  if (lock_type == F_UNLCK && file->s->changed && heap_check_heap(file, 0))
-    return HA_ERR_CRASHED;
+  if (lock_type == F_UNLCK && file->s->changed)
+  {
+    int error;
+    heap_read_latch(file);
+    error= heap_check_heap(file, 0);
+    heap_unlatch(file);
+    if (error)
+      return HA_ERR_CRASHED;
+  }
 #endif
   return 0;					// No external locking
 }
@@ -581,7 +641,13 @@ ha_rows ha_heap::records_in_range(uint inx, const key_range *min_key,
 {
   KEY *key=table->key_info+inx;
   if (key->algorithm == HA_KEY_ALG_BTREE)
-    return hp_rb_records_in_range(file, inx, min_key, max_key);
+  {
+    ha_rows rows;
+    heap_read_latch(file);
+    rows= hp_rb_records_in_range(file, inx, min_key, max_key);
+    heap_unlatch(file);
+    return rows;
+  }
 
   if (!min_key || !max_key ||
       min_key->length != max_key->length ||
@@ -593,8 +659,12 @@ ha_rows ha_heap::records_in_range(uint inx, const key_range *min_key,
   if (stats.records <= 1)
     return stats.records;
 
-  /* Assert that info() did run. We need current statistics here. */
-  DBUG_ASSERT(key_stat_version == file->s->key_stat_version);
+  /*
+    Assert that info() did run. We need current statistics here. A
+    concurrent insert may have changed them since.
+  */
+  DBUG_ASSERT(key_stat_version == file->s->key_stat_version ||
+              file->s->concurrent_insert);
   return key->rec_per_key[key->user_defined_key_parts-1];
 }
 
@@ -608,6 +678,7 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   ha_rows max_rows;
   HP_KEYDEF *keydef;
   HA_KEYSEG *seg;
+  HP_BLOBDEF *blobdef;
   bool found_real_auto_increment= 0;
 
   bzero(hp_create_info, sizeof(*hp_create_info));
@@ -619,6 +690,7 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
                        MYF(MY_WME | MY_THREAD_SPECIFIC),
                        &keydef, keys * sizeof(HP_KEYDEF),
                        &seg, parts * sizeof(HA_KEYSEG),
+                       &blobdef, share->blob_fields * sizeof(HP_BLOBDEF),
                        NULL))
     return my_errno;
   for (key= 0; key < keys; key++)
@@ -639,7 +711,8 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
       break;
     case HA_KEY_ALG_BTREE:
       keydef[key].algorithm= HA_KEY_ALG_BTREE;
-      mem_per_row+=sizeof(TREE_ELEMENT)+pos->key_length+sizeof(char*);
+      /* Key and row position in B+tree nodes that are about 2/3 full */
+      mem_per_row+= (pos->key_length + sizeof(char*)) * 3 / 2;
       break;
     default:
       DBUG_ASSERT(0); // cannot happen
@@ -705,6 +778,26 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
     }
   }
   mem_per_row+= MY_ALIGN(MY_MAX(share->reclength, sizeof(char*)) + 1, sizeof(char*));
+  for (uint i= 0; i < share->blob_fields; i++)
+  {
+    Field_blob *field= (Field_blob*) table_arg->field[share->blob_field[i]];
+    /* Information schema replaces unused columns with empty strings */
+    if (!(field->flags & BLOB_FLAG))
+      continue;
+    HP_BLOBDEF *blob= blobdef + hp_create_info->blobs++;
+    blob->offset= (uint) (field->ptr - table_arg->record[0]);
+    blob->packlength= field->pack_length_no_ptr();
+    if (field->null_ptr)
+    {
+      blob->null_bit= field->null_bit;
+      blob->null_pos= (uint) (field->null_ptr - table_arg->record[0]);
+    }
+    else
+    {
+      blob->null_bit= 0;
+      blob->null_pos= 0;
+    }
+  }
   if (table_arg->found_next_number_field)
   {
     keydef[share->next_number_index].flag|= HA_AUTO_KEY;
@@ -725,6 +818,7 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->keys= share->keys;
   hp_create_info->reclength= share->reclength;
   hp_create_info->keydef= keydef;
+  hp_create_info->blobdef= blobdef;
   return 0;
 }
 
@@ -820,6 +914,8 @@ int ha_heap::find_unique_row(uchar *record, uint unique_idx)
         records.
       */
       memcpy(record, file->current_ptr, (size_t) share->reclength);
+      if (share->blobs && hp_read_blobs(file, record))
+        DBUG_RETURN(-1);
 
       DBUG_RETURN(0); // found and position set
     }
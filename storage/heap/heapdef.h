@@ -20,7 +20,6 @@
 C_MODE_START
 #include <my_pthread.h>
 #include "heap.h"			/* Structs & some defines */
-#include "my_tree.h"
 
 /*
   When allocating keys /rows in the internal block structure, do it
@@ -33,6 +32,23 @@ C_MODE_START
 #define HP_MIN_RECORDS_IN_BLOCK 16
 #define HP_MAX_RECORDS_IN_BLOCK 8192
 
+/*
+  Length of one continuation block of blob data, including the pointer to
+  the next block of the same blob.
+*/
+
+#define HP_BLOB_BLOCK_LENGTH 256
+#define HP_BLOB_DATA_LENGTH (HP_BLOB_BLOCK_LENGTH - sizeof(uchar*))
+
+/*
+  Preferred length of a BTREE node. Nodes are made longer for long keys,
+  so that they can hold at least HP_BTREE_MIN_KEYS keys.
+*/
+
+#define HP_BTREE_NODE_LENGTH 1024
+#define HP_BTREE_MIN_KEYS 4
+#define HP_BTREE_MAX_HEIGHT 32
+
 	/* Some extern variables */
 
 extern LIST *heap_open_list,*heap_share_list;
@@ -52,11 +68,26 @@ typedef struct st_hp_hash_info
   ulong hash_of_key;
 } HASH_INFO;
 
-typedef struct {
-  HA_KEYSEG *keyseg;
-  uint key_length;
-  uint search_flag;
-} heap_rb_param;
+/*
+  A BTREE node. The header is followed, in interior nodes, by the number
+  of keys under every child, the child pointers and the keys; in leaves
+  only by the keys. Every key is a slot of HP_BTREE::key_length bytes
+  holding a key made by hp_rb_make_key().
+*/
+
+typedef struct st_hp_btree_node
+{
+  struct st_hp_btree_node *prev, *next;	/* Neighbour leaves in key order */
+  uint keys;				/* Keys in the node */
+  uint level;				/* 0 for leaves */
+} HP_BTREE_NODE;
+
+#define hp_bt_counts(node) ((ha_rows*) ((node) + 1))
+#define hp_bt_children(bt, node) \
+  ((HP_BTREE_NODE**) (hp_bt_counts(node) + (bt)->node_keys + 1))
+#define hp_bt_key(bt, node, i) \
+  ((uchar*) (node) + ((node)->level ? (bt)->node_key_offset : \
+                      sizeof(HP_BTREE_NODE)) + (size_t) (i) * (bt)->key_length)
       
 	/* Prototypes for intern functions */
 
@@ -100,6 +131,26 @@ extern void hp_clear(HP_SHARE *info);
 extern void hp_clear_keys(HP_SHARE *info);
 extern uint hp_rb_pack_key(HP_KEYDEF *keydef, uchar *key, const uchar *old,
                            key_part_map keypart_map);
+extern void hp_btree_init(HP_KEYDEF *keyinfo);
+extern void hp_btree_free(HP_KEYDEF *keyinfo);
+extern int hp_btree_insert(HP_SHARE *share, HP_KEYDEF *keyinfo,
+                           const uchar *key, uint key_length);
+extern int hp_btree_delete(HP_SHARE *share, HP_KEYDEF *keyinfo,
+                           const uchar *key, uint key_length);
+extern uchar *hp_btree_search(HP_INFO *info, HP_KEYDEF *keyinfo,
+                              const uchar *key, uint key_length,
+                              enum ha_rkey_function find_flag);
+extern uchar *hp_btree_first(HP_INFO *info, HP_KEYDEF *keyinfo);
+extern uchar *hp_btree_last(HP_INFO *info, HP_KEYDEF *keyinfo);
+extern uchar *hp_btree_next(HP_INFO *info, HP_KEYDEF *keyinfo);
+extern uchar *hp_btree_prev(HP_INFO *info, HP_KEYDEF *keyinfo);
+extern int hp_alloc_blobs(HP_INFO *info, const uchar *record);
+extern void hp_free_blob_chains(HP_SHARE *share, uchar **chains);
+extern void hp_store_blob_chains(HP_SHARE *share, uchar *pos, uchar **chains);
+extern void hp_free_blobs(HP_SHARE *share, uchar *pos);
+extern int hp_read_blobs(HP_INFO *info, uchar *record);
+extern int hp_rec_blob_cmp(HP_SHARE *share, const uchar *pos,
+                           const uchar *record);
 
 extern mysql_mutex_t THR_LOCK_heap;
 
@@ -108,6 +159,8 @@ extern PSI_memory_key hp_key_memory_HP_INFO;
 extern PSI_memory_key hp_key_memory_HP_PTRS;
 extern PSI_memory_key hp_key_memory_HP_KEYDEF;
 
+extern PSI_rwlock_key hp_key_rwlock_HP_SHARE_latch;
+
 #ifdef HAVE_PSI_INTERFACE
 void init_heap_psi_keys();
 #else
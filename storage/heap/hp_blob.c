@@ -0,0 +1,321 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1335  USA */
+
+/*
+  Storage of BLOB columns.
+
+  The fixed length part of a row keeps, for every blob column, the length
+  of the blob followed by a pointer to the first continuation block of the
+  blob (or a null pointer for NULL and empty blobs).
+  Continuation blocks are fixed size records of share->blob_block. Each
+  block starts with a pointer to the next block of the same blob, the rest
+  of the block (HP_BLOB_DATA_LENGTH bytes) holds blob data. Free blocks
+  are linked together through the same pointer, starting from
+  share->blob_del_link.
+
+  When a row is read, blobs that fit into one block are returned by
+  pointing into the block. Longer blobs are copied together into
+  info->blob_buff, which is valid until the next read with the same handle.
+*/
+
+#include "heapdef.h"
+
+
+/* Length of the blob and the pointer to its first block in a stored row */
+
+static inline uint32 hp_blob_length(HP_BLOBDEF *blob, const uchar *row)
+{
+  const uchar *pos= row + blob->offset;
+  switch (blob->packlength) {
+  case 1:
+    return (uint32) *pos;
+  case 2:
+    return uint2korr(pos);
+  case 3:
+    return uint3korr(pos);
+  case 4:
+    return uint4korr(pos);
+  default:
+    DBUG_ASSERT(0);
+    return 0;
+  }
+}
+
+static inline uchar *hp_blob_chain(HP_BLOBDEF *blob, const uchar *row)
+{
+  uchar *chain;
+  memcpy(&chain, row + blob->offset + blob->packlength, sizeof(chain));
+  return chain;
+}
+
+static inline my_bool hp_blob_is_null(HP_BLOBDEF *blob, const uchar *record)
+{
+  return blob->null_bit && (record[blob->null_pos] & blob->null_bit);
+}
+
+
+/* Find a free continuation block */
+
+static uchar *next_free_blob_pos(HP_SHARE *share)
+{
+  ulong block_pos;
+  size_t length;
+  uchar *pos;
+
+  if ((pos= share->blob_del_link))
+  {
+    share->blob_del_link= *((uchar**) pos);
+    share->blob_deleted--;
+    return pos;
+  }
+  if (share->data_length + share->index_length >= share->max_table_size)
+  {
+    my_errno= HA_ERR_RECORD_FILE_FULL;
+    return NULL;
+  }
+  if (!(block_pos= (share->blob_records %
+                    share->blob_block.records_in_block)))
+  {
+    if (hp_get_new_block(share, &share->blob_block, &length))
+      return NULL;
+    share->data_length+= length;
+  }
+  share->blob_records++;
+  return ((uchar*) share->blob_block.level_info[0].last_blocks +
+          block_pos * share->blob_block.recbuffer);
+}
+
+
+/* Return a chain of continuation blocks to the free list */
+
+static void free_blob_chain(HP_SHARE *share, uchar *pos)
+{
+  while (pos)
+  {
+    uchar *next= *((uchar**) pos);
+    *((uchar**) pos)= share->blob_del_link;
+    share->blob_del_link= pos;
+    share->blob_deleted++;
+    pos= next;
+  }
+}
+
+
+/*
+  Copy the blobs of a row into new chains of continuation blocks
+
+  SYNOPSIS
+    hp_alloc_blobs()
+    info		Heap handler
+    record		Row with the blobs
+
+  NOTES
+    The chains are stored in info->blob_chains, one per blob column. They
+    are put in the stored row with hp_store_blob_chains() or released with
+    hp_free_blob_chains().
+
+  RETURN
+    0      Ok
+    other  Error code. No blocks are kept allocated.
+*/
+
+int hp_alloc_blobs(HP_INFO *info, const uchar *record)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+  DBUG_ENTER("hp_alloc_blobs");
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    HP_BLOBDEF *blob= share->blobdef + i;
+    uint32 length= hp_blob_length(blob, record);
+    const uchar *data;
+    uchar **prev= info->blob_chains + i;
+
+    *prev= NULL;
+    if (hp_blob_is_null(blob, record) || !length)
+      continue;
+    memcpy(&data, record + blob->offset + blob->packlength, sizeof(data));
+    while (length)
+    {
+      uint32 part= MY_MIN(length, (uint32) HP_BLOB_DATA_LENGTH);
+      uchar *pos;
+      if (!(pos= next_free_blob_pos(share)))
+      {
+        /* Release this blob and all the blobs copied before it */
+        do
+          free_blob_chain(share, info->blob_chains[i]);
+        while (i--);
+        DBUG_RETURN(my_errno);
+      }
+      *((uchar**) pos)= NULL;
+      memcpy(pos + sizeof(uchar*), data, part);
+      *prev= pos;
+      prev= (uchar**) pos;
+      data+= part;
+      length-= part;
+    }
+  }
+  DBUG_RETURN(0);
+}
+
+
+/* Release the chains allocated by hp_alloc_blobs() */
+
+void hp_free_blob_chains(HP_SHARE *share, uchar **chains)
+{
+  uint i;
+  for (i= 0; i < share->blobs; i++)
+    free_blob_chain(share, chains[i]);
+}
+
+
+/*
+  Replace the blob pointers of a stored row with the chains allocated by
+  hp_alloc_blobs(). NULL and empty blobs are stored with length 0.
+*/
+
+void hp_store_blob_chains(HP_SHARE *share, uchar *pos, uchar **chains)
+{
+  uint i;
+  for (i= 0; i < share->blobs; i++)
+  {
+    HP_BLOBDEF *blob= share->blobdef + i;
+    if (!chains[i])
+      bzero(pos + blob->offset, blob->packlength);
+    memcpy(pos + blob->offset + blob->packlength, chains + i,
+           sizeof(uchar*));
+  }
+}
+
+
+/* Release the continuation blocks of a stored row */
+
+void hp_free_blobs(HP_SHARE *share, uchar *pos)
+{
+  uint i;
+  for (i= 0; i < share->blobs; i++)
+    free_blob_chain(share, hp_blob_chain(share->blobdef + i, pos));
+}
+
+
+/*
+  Make the blob pointers of a row copied from the table point to the data
+
+  SYNOPSIS
+    hp_read_blobs()
+    info		Heap handler
+    record		Row copied from a stored row
+
+  RETURN
+    0      Ok
+    other  Error code
+*/
+
+int hp_read_blobs(HP_INFO *info, uchar *record)
+{
+  HP_SHARE *share= info->s;
+  size_t buff_length= 0;
+  uchar *buff;
+  uint i;
+  DBUG_ENTER("hp_read_blobs");
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    HP_BLOBDEF *blob= share->blobdef + i;
+    uint32 length= hp_blob_length(blob, record);
+    if (length > HP_BLOB_DATA_LENGTH)
+      buff_length+= length;
+  }
+  if (buff_length > info->blob_buff_length)
+  {
+    if (!(buff= (uchar*) my_realloc(hp_key_memory_HP_INFO, info->blob_buff,
+                                    buff_length,
+                                    MYF(MY_ALLOW_ZERO_PTR | MY_WME |
+                                        (share->internal ?
+                                         MY_THREAD_SPECIFIC : 0)))))
+      DBUG_RETURN(my_errno= HA_ERR_OUT_OF_MEM);
+    info->blob_buff= buff;
+    info->blob_buff_length= buff_length;
+  }
+
+  buff= info->blob_buff;
+  for (i= 0; i < share->blobs; i++)
+  {
+    HP_BLOBDEF *blob= share->blobdef + i;
+    uint32 length= hp_blob_length(blob, record);
+    uchar *pos= hp_blob_chain(blob, record);
+    uchar *data;
+
+    if (!pos)
+      data= NULL;
+    else if (length <= HP_BLOB_DATA_LENGTH)
+      data= pos + sizeof(uchar*);
+    else
+    {
+      data= buff;
+      for (; pos; pos= *((uchar**) pos))
+      {
+        uint32 part= MY_MIN(length, (uint32) HP_BLOB_DATA_LENGTH);
+        memcpy(buff, pos + sizeof(uchar*), part);
+        buff+= part;
+        length-= part;
+      }
+    }
+    memcpy(record + blob->offset + blob->packlength, &data, sizeof(data));
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Compare a stored row with a row given by the caller
+
+  RETURN
+    0      The rows are equal
+    1      The rows differ
+*/
+
+int hp_rec_blob_cmp(HP_SHARE *share, const uchar *pos, const uchar *record)
+{
+  uint i, start= 0;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    HP_BLOBDEF *blob= share->blobdef + i;
+    uint32 length= hp_blob_length(blob, pos);
+    const uchar *chain= hp_blob_chain(blob, pos);
+    const uchar *data;
+
+    if (memcmp(pos + start, record + start, blob->offset - start))
+      return 1;
+    start= blob->offset + blob->packlength + sizeof(uchar*);
+    if (hp_blob_is_null(blob, record))
+      continue;
+    if (length != hp_blob_length(blob, record))
+      return 1;
+    memcpy(&data, record + blob->offset + blob->packlength, sizeof(data));
+    for (; chain; chain= *((uchar**) chain))
+    {
+      uint32 part= MY_MIN(length, (uint32) HP_BLOB_DATA_LENGTH);
+      if (memcmp(chain + sizeof(uchar*), data, part))
+        return 1;
+      data+= part;
+      length-= part;
+    }
+  }
+  return MY_TEST(memcmp(pos + start, record + start,
+                        share->reclength - start));
+}
@@ -0,0 +1,840 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1335  USA */
+
+/*
+  B+tree used for BTREE indexes.
+
+  A key is stored as made by hp_rb_make_key(): the key image followed by
+  the position of the row. The row position makes all keys of the tree
+  different, also for non unique indexes. Every key takes a slot of
+  HP_BTREE::key_length bytes, so a node is a sorted array of keys that is
+  searched with a binary search.
+
+  All keys are in the leaves, which are linked in key order. An interior
+  node with n keys has n+1 children; the keys under child i are >= key i-1
+  and < key i of the node. For every child the node also holds the number
+  of keys under it, which gives the rank of any key with one descent.
+
+  Full nodes are split on the way down when inserting. A node that gets
+  less than a quarter full by a delete is merged with a neighbour if both
+  fit into one node.
+
+  Every insert and delete increments HP_BTREE::version. The read position
+  of a handler (HP_INFO::last_leaf and last_slot) is only used as long as
+  the version is unchanged; otherwise reading continues from the last read
+  key, which is kept in HP_INFO::lastkey.
+*/
+
+#include "heapdef.h"
+
+
+static inline int bt_cmp(HP_KEYDEF *keyinfo, const uchar *stored,
+                         const uchar *key, uint key_length, uint nextflag)
+{
+  uint not_used[2];
+  return ha_key_cmp(keyinfo->seg, stored, key, key_length, nextflag,
+                    not_used);
+}
+
+
+/*
+  Find the first key in a node that is >= key, or > key if after is set.
+  Returns the slot of the key or node->keys if there is no such key.
+*/
+
+static uint bt_bsearch(HP_KEYDEF *keyinfo, HP_BTREE_NODE *node,
+                       const uchar *key, uint key_length, uint nextflag,
+                       my_bool after)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  uint low= 0, high= node->keys;
+
+  while (low < high)
+  {
+    uint mid= (low + high) / 2;
+    int cmp= bt_cmp(keyinfo, hp_bt_key(bt, node, mid), key, key_length,
+                    nextflag);
+    if (cmp < 0 || (cmp == 0 && after))
+      low= mid + 1;
+    else
+      high= mid;
+  }
+  return low;
+}
+
+
+/*
+  Find the leaf with the first key >= key (or > key)
+
+  SYNOPSIS
+    bt_find()
+    keyinfo		Key definition
+    key, key_length	Key to search for
+    nextflag		Flags for ha_key_cmp()
+    after		Search for the first key > key
+    slot	  OUT	Slot of the key in the leaf, may be leaf->keys
+    rank	  OUT	If not 0, number of keys before the found key
+
+  RETURN
+    The leaf or 0 if the tree is empty
+*/
+
+static HP_BTREE_NODE *bt_find(HP_KEYDEF *keyinfo, const uchar *key,
+                              uint key_length, uint nextflag, my_bool after,
+                              uint *slot, ha_rows *rank)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  HP_BTREE_NODE *node= bt->root;
+  ha_rows before= 0;
+  uint pos, i;
+
+  *slot= 0;
+  if (!node)
+  {
+    if (rank)
+      *rank= 0;
+    return 0;
+  }
+  while (node->level)
+  {
+    pos= bt_bsearch(keyinfo, node, key, key_length, nextflag, after);
+    if (rank)
+    {
+      ha_rows *counts= hp_bt_counts(node);
+      for (i= 0; i < pos; i++)
+        before+= counts[i];
+    }
+    node= hp_bt_children(bt, node)[pos];
+  }
+  *slot= bt_bsearch(keyinfo, node, key, key_length, nextflag, after);
+  if (rank)
+    *rank= before + *slot;
+  return node;
+}
+
+
+/* Move a position after the end of a leaf to the start of the next leaf */
+
+static inline HP_BTREE_NODE *bt_forward(HP_BTREE_NODE *leaf, uint *slot)
+{
+  if (leaf && *slot == leaf->keys)
+  {
+    leaf= leaf->next;
+    *slot= 0;
+  }
+  return leaf;
+}
+
+
+/* Move a position to the key before it */
+
+static inline HP_BTREE_NODE *bt_backward(HP_BTREE_NODE *leaf, uint *slot)
+{
+  if (!leaf)
+    return 0;
+  if (*slot)
+  {
+    (*slot)--;
+    return leaf;
+  }
+  if ((leaf= leaf->prev))
+    *slot= leaf->keys - 1;
+  return leaf;
+}
+
+
+/*
+  Remember a read position and the key in it, so that reading can
+  continue from the key if the tree is changed
+*/
+
+static uchar *bt_set_pos(HP_INFO *info, HP_KEYDEF *keyinfo,
+                         HP_BTREE_NODE *leaf, uint slot)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  uchar *key;
+
+  if (!(info->last_leaf= leaf))
+    return 0;
+  key= hp_bt_key(bt, leaf, slot);
+  info->last_slot= slot;
+  info->last_version= bt->version;
+  info->lastkey_len= (*keyinfo->get_key_length)(keyinfo, key);
+  info->last_find_flag= HA_READ_AFTER_KEY;
+  memcpy(info->lastkey, key, info->lastkey_len + sizeof(uchar*));
+  return key;
+}
+
+
+static HP_BTREE_NODE *bt_new_node(HP_SHARE *share, HP_BTREE *bt, uint level)
+{
+  HP_BTREE_NODE *node;
+  if (!(node= (HP_BTREE_NODE*) my_malloc(hp_key_memory_HP_KEYDEF,
+                                         bt->node_length,
+                                         MYF(share->internal ?
+                                             MY_THREAD_SPECIFIC : 0))))
+    return 0;
+  node->prev= node->next= 0;
+  node->keys= 0;
+  node->level= level;
+  share->index_length+= bt->node_length;
+  return node;
+}
+
+
+static void bt_free_node(HP_SHARE *share, HP_BTREE *bt, HP_BTREE_NODE *node)
+{
+  share->index_length-= bt->node_length;
+  my_free(node);
+}
+
+
+static inline uint bt_max_keys(HP_BTREE *bt, HP_BTREE_NODE *node)
+{
+  return node->level ? bt->node_keys : bt->leaf_keys;
+}
+
+
+/*
+  Split a full child of a node into two
+
+  SYNOPSIS
+    bt_split()
+    share		Heap share
+    bt			The tree
+    parent		Node that has room for one more key
+    pos			Child of parent to split
+
+  NOTES
+    The upper half of the child is moved to a new node that is put after
+    the child in parent.
+
+  RETURN
+    0      Ok
+    1      Out of memory
+*/
+
+static int bt_split(HP_SHARE *share, HP_BTREE *bt, HP_BTREE_NODE *parent,
+                    uint pos)
+{
+  HP_BTREE_NODE **children= hp_bt_children(bt, parent);
+  ha_rows *counts= hp_bt_counts(parent);
+  HP_BTREE_NODE *left= children[pos], *right;
+  uint keep, move, tail= parent->keys - pos;
+
+  if (!(right= bt_new_node(share, bt, left->level)))
+    return 1;
+
+  memmove(hp_bt_key(bt, parent, pos + 1), hp_bt_key(bt, parent, pos),
+          (size_t) tail * bt->key_length);
+  memmove(children + pos + 2, children + pos + 1, tail * sizeof(*children));
+  memmove(counts + pos + 2, counts + pos + 1, tail * sizeof(*counts));
+  children[pos + 1]= right;
+  parent->keys++;
+
+  if (!left->level)
+  {
+    keep= left->keys / 2;
+    move= left->keys - keep;
+    memcpy(hp_bt_key(bt, right, 0), hp_bt_key(bt, left, keep),
+           (size_t) move * bt->key_length);
+    right->keys= move;
+    left->keys= keep;
+    if ((right->next= left->next))
+      right->next->prev= right;
+    right->prev= left;
+    left->next= right;
+    memcpy(hp_bt_key(bt, parent, pos), hp_bt_key(bt, right, 0),
+           bt->key_length);
+    counts[pos]= keep;
+    counts[pos + 1]= move;
+  }
+  else
+  {
+    ha_rows moved= 0;
+    uint i;
+
+    /* The key in the middle goes up to the parent */
+    keep= left->keys / 2;
+    move= left->keys - keep - 1;
+    memcpy(hp_bt_key(bt, parent, pos), hp_bt_key(bt, left, keep),
+           bt->key_length);
+    memcpy(hp_bt_key(bt, right, 0), hp_bt_key(bt, left, keep + 1),
+           (size_t) move * bt->key_length);
+    memcpy(hp_bt_children(bt, right), hp_bt_children(bt, left) + keep + 1,
+           (move + 1) * sizeof(HP_BTREE_NODE*));
+    memcpy(hp_bt_counts(right), hp_bt_counts(left) + keep + 1,
+           (move + 1) * sizeof(ha_rows));
+    for (i= 0; i <= move; i++)
+      moved+= hp_bt_counts(right)[i];
+    right->keys= move;
+    left->keys= keep;
+    counts[pos]-= moved;
+    counts[pos + 1]= moved;
+  }
+  return 0;
+}
+
+
+/*
+  Merge child pos+1 of a node into child pos if both fit into one node
+
+  RETURN
+    0      The children were not merged
+    1      Merged
+*/
+
+static my_bool bt_merge(HP_SHARE *share, HP_BTREE *bt, HP_BTREE_NODE *parent,
+                        uint pos)
+{
+  HP_BTREE_NODE **children= hp_bt_children(bt, parent);
+  ha_rows *counts= hp_bt_counts(parent);
+  HP_BTREE_NODE *left= children[pos], *right= children[pos + 1];
+  uint tail;
+
+  if (!left->level)
+  {
+    if (left->keys + right->keys > bt->leaf_keys)
+      return 0;
+    memcpy(hp_bt_key(bt, left, left->keys), hp_bt_key(bt, right, 0),
+           (size_t) right->keys * bt->key_length);
+    if ((left->next= right->next))
+      left->next->prev= left;
+  }
+  else
+  {
+    if (left->keys + right->keys + 1 > bt->node_keys)
+      return 0;
+    /* The separating key comes down from the parent */
+    memcpy(hp_bt_key(bt, left, left->keys), hp_bt_key(bt, parent, pos),
+           bt->key_length);
+    memcpy(hp_bt_key(bt, left, left->keys + 1), hp_bt_key(bt, right, 0),
+           (size_t) right->keys * bt->key_length);
+    memcpy(hp_bt_children(bt, left) + left->keys + 1,
+           hp_bt_children(bt, right),
+           (right->keys + 1) * sizeof(HP_BTREE_NODE*));
+    memcpy(hp_bt_counts(left) + left->keys + 1, hp_bt_counts(right),
+           (right->keys + 1) * sizeof(ha_rows));
+    left->keys++;
+  }
+  left->keys+= right->keys;
+  counts[pos]+= counts[pos + 1];
+
+  tail= parent->keys - pos - 1;
+  memmove(hp_bt_key(bt, parent, pos), hp_bt_key(bt, parent, pos + 1),
+          (size_t) tail * bt->key_length);
+  memmove(children + pos + 1, children + pos + 2, tail * sizeof(*children));
+  memmove(counts + pos + 1, counts + pos + 2, tail * sizeof(*counts));
+  parent->keys--;
+  bt_free_node(share, bt, right);
+  return 1;
+}
+
+
+/*
+  Give an interior node without keys one key and child from a neighbour.
+  Used when the node can't be merged with the neighbour.
+*/
+
+static void bt_borrow(HP_BTREE *bt, HP_BTREE_NODE *parent, uint pos)
+{
+  HP_BTREE_NODE **children= hp_bt_children(bt, parent);
+  ha_rows *counts= hp_bt_counts(parent);
+  HP_BTREE_NODE *node= children[pos];
+  ha_rows moved;
+
+  DBUG_ASSERT(node->level && !node->keys);
+  if (pos < parent->keys)
+  {
+    HP_BTREE_NODE *right= children[pos + 1];
+    moved= hp_bt_counts(right)[0];
+    memcpy(hp_bt_key(bt, node, 0), hp_bt_key(bt, parent, pos),
+           bt->key_length);
+    hp_bt_children(bt, node)[1]= hp_bt_children(bt, right)[0];
+    hp_bt_counts(node)[1]= moved;
+    memcpy(hp_bt_key(bt, parent, pos), hp_bt_key(bt, right, 0),
+           bt->key_length);
+    memmove(hp_bt_key(bt, right, 0), hp_bt_key(bt, right, 1),
+            (size_t) (right->keys - 1) * bt->key_length);
+    memmove(hp_bt_children(bt, right), hp_bt_children(bt, right) + 1,
+            right->keys * sizeof(HP_BTREE_NODE*));
+    memmove(hp_bt_counts(right), hp_bt_counts(right) + 1,
+            right->keys * sizeof(ha_rows));
+    right->keys--;
+    counts[pos]+= moved;
+    counts[pos + 1]-= moved;
+  }
+  else
+  {
+    HP_BTREE_NODE *left= children[pos - 1];
+    moved= hp_bt_counts(left)[left->keys];
+    hp_bt_children(bt, node)[1]= hp_bt_children(bt, node)[0];
+    hp_bt_counts(node)[1]= hp_bt_counts(node)[0];
+    memcpy(hp_bt_key(bt, node, 0), hp_bt_key(bt, parent, pos - 1),
+           bt->key_length);
+    hp_bt_children(bt, node)[0]= hp_bt_children(bt, left)[left->keys];
+    hp_bt_counts(node)[0]= moved;
+    memcpy(hp_bt_key(bt, parent, pos - 1),
+           hp_bt_key(bt, left, left->keys - 1), bt->key_length);
+    left->keys--;
+    counts[pos]+= moved;
+    counts[pos - 1]-= moved;
+  }
+  node->keys= 1;
+}
+
+
+/*
+  Compute the node layout of a BTREE index
+
+  NOTES
+    Called when the table is created, after keyinfo->length is known.
+*/
+
+void hp_btree_init(HP_KEYDEF *keyinfo)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  uint key_length= keyinfo->length + sizeof(uchar*);
+  uint child_length= sizeof(ha_rows) + sizeof(HP_BTREE_NODE*);
+  uint length= HP_BTREE_NODE_LENGTH;
+
+  bzero((char*) bt, sizeof(*bt));
+  set_if_bigger(length, sizeof(HP_BTREE_NODE) + child_length +
+                        HP_BTREE_MIN_KEYS * (key_length + child_length));
+  bt->key_length= key_length;
+  bt->node_length= length;
+  bt->leaf_keys= (length - sizeof(HP_BTREE_NODE)) / key_length;
+  bt->node_keys= ((length - sizeof(HP_BTREE_NODE) - child_length) /
+                  (key_length + child_length));
+  bt->node_key_offset= (sizeof(HP_BTREE_NODE) +
+                        (bt->node_keys + 1) * child_length);
+}
+
+
+static void bt_free_nodes(HP_BTREE *bt, HP_BTREE_NODE *node)
+{
+  if (node->level)
+  {
+    uint i;
+    for (i= 0; i <= node->keys; i++)
+      bt_free_nodes(bt, hp_bt_children(bt, node)[i]);
+  }
+  my_free(node);
+}
+
+
+/* Free all nodes of a BTREE index. The caller resets index_length */
+
+void hp_btree_free(HP_KEYDEF *keyinfo)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  if (bt->root)
+    bt_free_nodes(bt, bt->root);
+  bt->root= 0;
+  bt->records= 0;
+  bt->version++;
+}
+
+
+/*
+  Insert a key into a BTREE index
+
+  SYNOPSIS
+    hp_btree_insert()
+    share		Heap share
+    keyinfo		Key definition
+    key			Key made by hp_rb_make_key()
+    key_length		Length of key without the row position
+
+  RETURN
+    0      Ok
+    1      Error, my_errno is set. The key is not inserted.
+*/
+
+int hp_btree_insert(HP_SHARE *share, HP_KEYDEF *keyinfo, const uchar *key,
+                    uint key_length)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  HP_BTREE_NODE *path[HP_BTREE_MAX_HEIGHT];
+  uint path_pos[HP_BTREE_MAX_HEIGHT];
+  HP_BTREE_NODE *node;
+  uint depth= 0, pos;
+  DBUG_ENTER("hp_btree_insert");
+
+  bt->version++;
+  if (!(node= bt->root))
+  {
+    if (!(node= bt_new_node(share, bt, 0)))
+      DBUG_RETURN(1);
+    bt->root= node;
+  }
+  else if (node->keys == bt_max_keys(bt, node))
+  {
+    HP_BTREE_NODE *root;
+    DBUG_ASSERT(node->level + 1 < HP_BTREE_MAX_HEIGHT);
+    if (!(root= bt_new_node(share, bt, node->level + 1)))
+      DBUG_RETURN(1);
+    hp_bt_children(bt, root)[0]= node;
+    hp_bt_counts(root)[0]= bt->records;
+    bt->root= root;
+    if (bt_split(share, bt, root, 0))
+      DBUG_RETURN(1);
+    node= root;
+  }
+
+  while (node->level)
+  {
+    HP_BTREE_NODE *child;
+    pos= bt_bsearch(keyinfo, node, key, key_length, SEARCH_SAME, 1);
+    child= hp_bt_children(bt, node)[pos];
+    if (child->keys == bt_max_keys(bt, child))
+    {
+      if (bt_split(share, bt, node, pos))
+        DBUG_RETURN(1);
+      if (bt_cmp(keyinfo, hp_bt_key(bt, node, pos), key, key_length,
+                 SEARCH_SAME) <= 0)
+        pos++;
+      child= hp_bt_children(bt, node)[pos];
+    }
+    path[depth]= node;
+    path_pos[depth++]= pos;
+    node= child;
+  }
+
+  pos= bt_bsearch(keyinfo, node, key, key_length, SEARCH_SAME, 1);
+  if (keyinfo->flag & HA_NOSAME)
+  {
+    /* Keys that are equal apart from the row position are next to it */
+    HP_BTREE_NODE *leaf;
+    uint slot= pos;
+    const uint flag= SEARCH_FIND | SEARCH_UPDATE | SEARCH_INSERT;
+
+    if (((leaf= bt_forward(node, &slot)) &&
+         !bt_cmp(keyinfo, hp_bt_key(bt, leaf, slot), key, key_length, flag)) ||
+        ((slot= pos, leaf= bt_backward(node, &slot)) &&
+         !bt_cmp(keyinfo, hp_bt_key(bt, leaf, slot), key, key_length, flag)))
+    {
+      my_errno= HA_ERR_FOUND_DUPP_KEY;
+      DBUG_RETURN(1);
+    }
+  }
+
+  memmove(hp_bt_key(bt, node, pos + 1), hp_bt_key(bt, node, pos),
+          (size_t) (node->keys - pos) * bt->key_length);
+  memcpy(hp_bt_key(bt, node, pos), key, key_length + sizeof(uchar*));
+  node->keys++;
+  bt->records++;
+  while (depth--)
+    hp_bt_counts(path[depth])[path_pos[depth]]++;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Delete a key from a BTREE index
+
+  SYNOPSIS
+    hp_btree_delete()
+    share		Heap share
+    keyinfo		Key definition
+    key			Key made by hp_rb_make_key()
+    key_length		Length of key without the row position
+
+  RETURN
+    0      Ok
+    1      The key was not found
+*/
+
+int hp_btree_delete(HP_SHARE *share, HP_KEYDEF *keyinfo, const uchar *key,
+                    uint key_length)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  HP_BTREE_NODE *path[HP_BTREE_MAX_HEIGHT];
+  uint path_pos[HP_BTREE_MAX_HEIGHT];
+  HP_BTREE_NODE *node, *root;
+  uint depth= 0, pos;
+  DBUG_ENTER("hp_btree_delete");
+
+  if (!(node= bt->root))
+    DBUG_RETURN(my_errno= HA_ERR_CRASHED);
+  bt->version++;
+  while (node->level)
+  {
+    pos= bt_bsearch(keyinfo, node, key, key_length, SEARCH_SAME, 1);
+    path[depth]= node;
+    path_pos[depth++]= pos;
+    node= hp_bt_children(bt, node)[pos];
+  }
+  pos= bt_bsearch(keyinfo, node, key, key_length, SEARCH_SAME, 0);
+  if (pos == node->keys ||
+      bt_cmp(keyinfo, hp_bt_key(bt, node, pos), key, key_length, SEARCH_SAME))
+    DBUG_RETURN(my_errno= HA_ERR_CRASHED);
+
+  memmove(hp_bt_key(bt, node, pos), hp_bt_key(bt, node, pos + 1),
+          (size_t) (node->keys - pos - 1) * bt->key_length);
+  node->keys--;
+  bt->records--;
+  for (pos= 0; pos < depth; pos++)
+    hp_bt_counts(path[pos])[path_pos[pos]]--;
+
+  /* Merge nodes that got too empty, from the leaf upwards */
+  while (depth-- && node->keys <= bt_max_keys(bt, node) / 4)
+  {
+    HP_BTREE_NODE *parent= path[depth];
+    uint i= path_pos[depth];
+
+    if (!parent->keys)
+      break;
+    if (!bt_merge(share, bt, parent, i < parent->keys ? i : i - 1))
+    {
+      if (!node->keys)
+        bt_borrow(bt, parent, i);
+      break;
+    }
+    node= parent;
+  }
+
+  /* Remove levels that have only one child */
+  while ((root= bt->root)->level && !root->keys)
+  {
+    bt->root= hp_bt_children(bt, root)[0];
+    bt_free_node(share, bt, root);
+  }
+  if (!root->keys)
+  {
+    bt->root= 0;
+    bt_free_node(share, bt, root);
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Position on a key
+
+  SYNOPSIS
+    hp_btree_search()
+    info		Heap handler
+    keyinfo		Key definition
+    key			Key packed by hp_rb_pack_key()
+    key_length		Length of key
+    find_flag		How to search
+
+  RETURN
+    The found key or 0
+*/
+
+uchar *hp_btree_search(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
+                       uint key_length, enum ha_rkey_function find_flag)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  const uint nextflag= SEARCH_FIND | SEARCH_SAME;
+  HP_BTREE_NODE *leaf, *found;
+  uint slot, found_slot;
+
+  switch (find_flag) {
+  case HA_READ_KEY_EXACT:
+  case HA_READ_KEY_OR_NEXT:
+  case HA_READ_KEY_OR_PREV:
+  case HA_READ_BEFORE_KEY:
+    leaf= bt_find(keyinfo, key, key_length, nextflag, 0, &slot, 0);
+    found_slot= slot;
+    found= bt_forward(leaf, &found_slot);
+    if (find_flag == HA_READ_KEY_OR_NEXT)
+      leaf= found;
+    else if (found && find_flag != HA_READ_BEFORE_KEY &&
+             !bt_cmp(keyinfo, hp_bt_key(bt, found, found_slot), key,
+                     key_length, nextflag))
+      leaf= found;
+    else if (find_flag == HA_READ_KEY_EXACT)
+      leaf= 0;
+    else
+    {
+      leaf= bt_backward(leaf, &slot);
+      found_slot= slot;
+    }
+    break;
+  case HA_READ_AFTER_KEY:
+    leaf= bt_find(keyinfo, key, key_length, nextflag, 1, &found_slot, 0);
+    leaf= bt_forward(leaf, &found_slot);
+    break;
+  case HA_READ_PREFIX_LAST:
+  case HA_READ_PREFIX_LAST_OR_PREV:
+    leaf= bt_find(keyinfo, key, key_length, nextflag, 1, &found_slot, 0);
+    leaf= bt_backward(leaf, &found_slot);
+    if (leaf && find_flag == HA_READ_PREFIX_LAST &&
+        bt_cmp(keyinfo, hp_bt_key(bt, leaf, found_slot), key, key_length,
+               nextflag))
+      leaf= 0;
+    break;
+  default:
+    leaf= 0;
+    break;
+  }
+  return bt_set_pos(info, keyinfo, leaf, found_slot);
+}
+
+
+/* Position on the first key of the index */
+
+uchar *hp_btree_first(HP_INFO *info, HP_KEYDEF *keyinfo)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  HP_BTREE_NODE *node;
+
+  if (!(node= bt->root))
+  {
+    /* heap_rnext() will start from the first key */
+    info->lastkey_len= 0;
+    info->last_find_flag= HA_READ_KEY_OR_NEXT;
+    return bt_set_pos(info, keyinfo, 0, 0);
+  }
+  while (node->level)
+    node= hp_bt_children(bt, node)[0];
+  return bt_set_pos(info, keyinfo, node, 0);
+}
+
+
+/* Position on the last key of the index */
+
+uchar *hp_btree_last(HP_INFO *info, HP_KEYDEF *keyinfo)
+{
+  HP_BTREE *bt= &keyinfo->btree;
+  HP_BTREE_NODE *node;
+
+  if (!(node= bt->root))
+  {
+    info->lastkey_len= 0;
+    info->last_find_flag= HA_READ_KEY_OR_NEXT;
+    return bt_set_pos(info, keyinfo, 0, 0);
+  }
+  while (node->level)
+    node= hp_bt_children(bt, node)[node->keys];
+  return bt_set_pos(info, keyinfo, node, node->keys - 1);
+}
+
+
+/*
+  Position on the key after the last read key
+
+  NOTES
+    If the tree has changed since the last read, the key is searched for
+    again. info->lastkey is then either the last read key, including the
+    row position, or (after a failed search) the searched key.
+*/
+
+uchar *hp_btree_next(HP_INFO *info, HP_KEYDEF *keyinfo)
+{
+  HP_BTREE_NODE *leaf= info->last_leaf;
+  uint slot;
+
+  if (leaf && info->last_version == keyinfo->btree.version)
+    slot= info->last_slot + 1;
+  else if (info->last_find_flag == HA_READ_AFTER_KEY)
+    leaf= bt_find(keyinfo, info->lastkey, info->lastkey_len, SEARCH_SAME, 1,
+                  &slot, 0);
+  else
+    leaf= bt_find(keyinfo, info->lastkey, info->lastkey_len,
+                  SEARCH_FIND | SEARCH_SAME, 0, &slot, 0);
+  leaf= bt_forward(leaf, &slot);
+  return bt_set_pos(info, keyinfo, leaf, slot);
+}
+
+
+/* Position on the key before the last read key */
+
+uchar *hp_btree_prev(HP_INFO *info, HP_KEYDEF *keyinfo)
+{
+  HP_BTREE_NODE *leaf= info->last_leaf;
+  uint slot;
+
+  if (leaf && info->last_version == keyinfo->btree.version)
+    slot= info->last_slot;
+  else
+    leaf= bt_find(keyinfo, info->lastkey, info->lastkey_len,
+                  (info->last_find_flag == HA_READ_AFTER_KEY ?
+                   SEARCH_SAME : SEARCH_FIND | SEARCH_SAME), 0, &slot, 0);
+  leaf= bt_backward(leaf, &slot);
+  return bt_set_pos(info, keyinfo, leaf, slot);
+}
+
+
+/*
+  Find out how many rows there is in the given range
+
+  SYNOPSIS
+    hp_rb_records_in_range()
+    info		HEAP handler
+    inx			Index to use
+    min_key		Min key. Is = 0 if no min range
+    max_key		Max key. Is = 0 if no max range
+
+  NOTES
+    min_key.flag can have one of the following values:
+      HA_READ_KEY_EXACT		Include the key in the range
+      HA_READ_AFTER_KEY		Don't include key in range
+
+    max_key.flag can have one of the following values:
+      HA_READ_BEFORE_KEY	Don't include key in range
+      HA_READ_AFTER_KEY		Include all 'end_key' values in the range
+
+    The number of keys before each end of the range is exact, as interior
+    nodes know the number of keys under every child.
+
+  RETURN
+   HA_POS_ERROR		Something is wrong with the index tree.
+   0			There is no matching keys in the given range
+   number > 0		There is approximately 'number' matching rows in
+			the range.
+*/
+
+static ha_rows bt_key_pos(HP_INFO *info, HP_KEYDEF *keyinfo,
+                          const key_range *range)
+{
+  uint key_length, slot;
+  ha_rows rank;
+
+  if (range->flag != HA_READ_KEY_EXACT && range->flag != HA_READ_AFTER_KEY &&
+      range->flag != HA_READ_BEFORE_KEY)
+    return HA_POS_ERROR;
+  key_length= hp_rb_pack_key(keyinfo, info->recbuf, range->key,
+                             range->keypart_map);
+  bt_find(keyinfo, info->recbuf, key_length, SEARCH_FIND | SEARCH_SAME,
+          range->flag == HA_READ_AFTER_KEY, &slot, &rank);
+  return rank;
+}
+
+
+ha_rows hp_rb_records_in_range(HP_INFO *info, int inx,
+                               const key_range *min_key,
+                               const key_range *max_key)
+{
+  ha_rows start_pos, end_pos;
+  HP_KEYDEF *keyinfo= info->s->keydef + inx;
+  DBUG_ENTER("hp_rb_records_in_range");
+
+  info->lastinx= inx;
+  info->last_leaf= 0;
+  start_pos= min_key ? bt_key_pos(info, keyinfo, min_key) : 0;
+  end_pos= max_key ? bt_key_pos(info, keyinfo, max_key) :
+                     keyinfo->btree.records;
+
+  DBUG_PRINT("info",("start_pos: %lu  end_pos: %lu", (ulong) start_pos,
+		     (ulong) end_pos));
+  if (start_pos == HA_POS_ERROR || end_pos == HA_POS_ERROR)
+    DBUG_RETURN(HA_POS_ERROR);
+  DBUG_RETURN(end_pos < start_pos ? (ha_rows) 0 :
+	      (end_pos == start_pos ? (ha_rows) 1 : end_pos - start_pos));
+}
@@ -35,12 +35,18 @@ void hp_clear(HP_SHARE *info)
     (void) hp_free_level(&info->block,info->block.levels,info->block.root,
 			(uchar*) 0);
   info->block.levels=0;
+  if (info->blob_block.levels)
+    (void) hp_free_level(&info->blob_block, info->blob_block.levels,
+                         info->blob_block.root, (uchar*) 0);
+  info->blob_block.levels=0;
   hp_clear_keys(info);
   info->records= info->deleted= 0;
+  info->blob_records= info->blob_deleted= 0;
   info->data_length= 0;
   info->blength=1;
   info->changed=0;
   info->del_link=0;
+  info->blob_del_link=0;
   info->key_version++;
   info->file_version++;
   DBUG_VOID_RETURN;
@@ -91,7 +97,7 @@ void hp_clear_keys(HP_SHARE *info)
     HP_KEYDEF *keyinfo = info->keydef + key;
     if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
     {
-      delete_tree(&keyinfo->rb_tree, 0);
+      hp_btree_free(keyinfo);
     }
     else
     {
@@ -16,16 +16,16 @@
 
 #include "heapdef.h"
 
-static int keys_compare(heap_rb_param *param, uchar *key1, uchar *key2);
 static void init_block(HP_BLOCK *block,uint reclength,ulong min_records,
 		       ulong max_records);
+static my_bool hp_check_status(void *param);
 
 /* Create a heap table */
 
 int heap_create(const char *name, HP_CREATE_INFO *create_info,
                 HP_SHARE **res, my_bool *created_new_share)
 {
-  uint i, j, key_segs, max_length, length;
+  uint i, j, key_segs, max_length, length, null_parts;
   HP_SHARE *share= 0;
   HA_KEYSEG *keyseg;
   HP_KEYDEF *keydef= create_info->keydef;
@@ -66,8 +66,7 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     for (i= key_segs= max_length= 0, keyinfo= keydef; i < keys; i++, keyinfo++)
     {
       bzero((char*) &keyinfo->block,sizeof(keyinfo->block));
-      bzero((char*) &keyinfo->rb_tree ,sizeof(keyinfo->rb_tree));
-      for (j= length= 0; j < keyinfo->keysegs; j++)
+      for (j= length= null_parts= 0; j < keyinfo->keysegs; j++)
       {
 	length+= keyinfo->seg[j].length;
 	if (keyinfo->seg[j].null_bit)
@@ -76,7 +75,7 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
 	  if (!(keyinfo->flag & HA_NULL_ARE_EQUAL))
 	    keyinfo->flag|= HA_NULL_PART_KEY;
 	  if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
-	    keyinfo->rb_tree.size_of_element++;
+	    null_parts++;
 	}
 	switch (keyinfo->seg[j].type) {
 	case HA_KEYTYPE_SHORT_INT:
@@ -143,8 +142,8 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
 	}
       }
       keyinfo->length= length;
-      length+= keyinfo->rb_tree.size_of_element + 
-	       ((keyinfo->algorithm == HA_KEY_ALG_BTREE) ? sizeof(uchar*) : 0);
+      if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
+        length+= null_parts + sizeof(uchar*);
       if (length > max_length)
 	max_length= length;
       key_segs+= keyinfo->keysegs;
@@ -162,7 +161,8 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     if (!(share= (HP_SHARE*) my_malloc(hp_key_memory_HP_SHARE,
                                        sizeof(HP_SHARE)+
 				       keys*sizeof(HP_KEYDEF)+
-				       key_segs*sizeof(HA_KEYSEG),
+				       key_segs*sizeof(HA_KEYSEG)+
+				       create_info->blobs*sizeof(HP_BLOBDEF),
 				       MYF(MY_ZEROFILL |
                                            (create_info->internal_table ?
                                             MY_THREAD_SPECIFIC : 0)))))
@@ -171,6 +171,14 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     share->key_stat_version= 1;
     keyseg= (HA_KEYSEG*) (share->keydef + keys);
     init_block(&share->block, visible_offset + 1, min_records, max_records);
+    if ((share->blobs= create_info->blobs))
+    {
+      share->blobdef= (HP_BLOBDEF*) (keyseg + key_segs);
+      memcpy(share->blobdef, create_info->blobdef,
+             (size_t) (sizeof(HP_BLOBDEF) * create_info->blobs));
+      init_block(&share->blob_block, HP_BLOB_BLOCK_LENGTH, min_records,
+                 max_records);
+    }
 	/* Fix keys */
     memcpy(share->keydef, keydef, (size_t) (sizeof(keydef[0]) * keys));
     for (i= 0, keyinfo= share->keydef; i < keys; i++, keyinfo++)
@@ -189,10 +197,7 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
 	keyseg->null_bit= 0;
 	keyseg++;
 
-	init_tree(&keyinfo->rb_tree, 0, 0, sizeof(uchar*),
-		  (qsort_cmp2)keys_compare, NULL, NULL,
-                  MYF((create_info->internal_table ? MY_THREAD_SPECIFIC : 0) |
-                      MY_TREE_WITH_DELETE));
+	hp_btree_init(keyinfo);
 	keyinfo->delete_key= hp_rb_delete_key;
 	keyinfo->write_key= hp_rb_write_key;
       }
@@ -232,6 +237,15 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     if (!create_info->internal_table)
     {
       thr_lock_init(&share->lock);
+      /*
+        INSERT can run while the table is read. Several INSERTs can run
+        together unless they have to generate auto_increment values.
+        Handler calls that read or change rows take share->latch.
+      */
+      share->lock.check_status= hp_check_status;
+      share->lock.allow_multiple_concurrent_insert= share->auto_key == 0;
+      share->concurrent_insert= 1;
+      mysql_rwlock_init(hp_key_rwlock_HP_SHARE_latch, &share->latch);
       share->open_list.data= (void*) share;
       heap_share_list= list_add(heap_share_list,&share->open_list);
     }
@@ -255,13 +269,6 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
 } /* heap_create */
 
 
-static int keys_compare(heap_rb_param *param, uchar *key1, uchar *key2)
-{
-  uint not_used[2];
-  return ha_key_cmp(param->keyseg, key1, key2, param->key_length, 
-		    param->search_flag, not_used);
-}
-
 static void init_block(HP_BLOCK *block, uint reclength, ulong min_records,
 		       ulong max_records)
 {
@@ -308,6 +315,18 @@ static void init_block(HP_BLOCK *block, uint reclength, ulong min_records,
 }
 
 
+/*
+  Concurrent inserts are always allowed: the rows and keys are changed
+  under HP_SHARE::latch and a read never depends on the number of rows
+  at the time the table was locked.
+*/
+
+static my_bool hp_check_status(void *param __attribute__((unused)))
+{
+  return 0;
+}
+
+
 static inline void heap_try_free(HP_SHARE *share)
 {
   DBUG_ENTER("heap_try_free");
@@ -360,6 +379,7 @@ void hp_free(HP_SHARE *share)
   {
     heap_share_list= list_delete(heap_share_list, &share->open_list);
     thr_lock_delete(&share->lock);
+    mysql_rwlock_destroy(&share->latch);
   }
   hp_clear(share);			/* Remove blocks from memory */
   my_free(share->name);
@@ -43,11 +43,15 @@ int heap_delete(HP_INFO *info, const uchar *record)
   }
 
   info->update=HA_STATE_DELETED;
+  if (share->blobs)
+    hp_free_blobs(share, pos);
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
   pos[share->visible]=0;		/* Record deleted */
   share->deleted++;
-  share->key_version++;
+  /* hp_delete_key() has corrected the read position of this handler */
+  if (info->key_version == share->key_version++)
+    info->key_version= share->key_version;
 #if !defined(DBUG_OFF) && defined(EXTRA_HEAP_DEBUG)
   DBUG_EXECUTE("check_heap",heap_check_heap(info, 0););
 #endif
@@ -67,21 +71,13 @@ int heap_delete(HP_INFO *info, const uchar *record)
 int hp_rb_delete_key(HP_INFO *info, register HP_KEYDEF *keyinfo,
 		   const uchar *record, uchar *recpos, int flag)
 {
-  heap_rb_param custom_arg;
-  size_t old_allocated;
-  int res;
+  uint key_length;
 
   if (flag) 
-    info->last_pos= NULL; /* For heap_rnext/heap_rprev */
-
-  custom_arg.keyseg= keyinfo->seg;
-  custom_arg.key_length= hp_rb_make_key(keyinfo, info->recbuf, record, recpos);
-  custom_arg.search_flag= SEARCH_SAME;
-  old_allocated= keyinfo->rb_tree.allocated;
-  res= tree_delete(&keyinfo->rb_tree, info->recbuf, custom_arg.key_length,
-                   &custom_arg);
-  info->s->index_length-= (old_allocated - keyinfo->rb_tree.allocated);
-  return res;
+    info->last_leaf= NULL; /* For heap_rnext/heap_rprev */
+
+  key_length= hp_rb_make_key(keyinfo, info->recbuf, record, recpos);
+  return hp_btree_delete(info->s, keyinfo, info->recbuf, key_length);
 }
 
 
@@ -29,80 +29,6 @@ hp_charpos(CHARSET_INFO *cs, const uchar *b, const uchar *e, size_t num)
 
 
 static ulong hp_hashnr(HP_KEYDEF *keydef, const uchar *key);
-/*
-  Find out how many rows there is in the given range
-
-  SYNOPSIS
-    hp_rb_records_in_range()
-    info		HEAP handler
-    inx			Index to use
-    min_key		Min key. Is = 0 if no min range
-    max_key		Max key. Is = 0 if no max range
-
-  NOTES
-    min_key.flag can have one of the following values:
-      HA_READ_KEY_EXACT		Include the key in the range
-      HA_READ_AFTER_KEY		Don't include key in range
-
-    max_key.flag can have one of the following values:
-      HA_READ_BEFORE_KEY	Don't include key in range
-      HA_READ_AFTER_KEY		Include all 'end_key' values in the range
-
-  RETURN
-   HA_POS_ERROR		Something is wrong with the index tree.
-   0			There is no matching keys in the given range
-   number > 0		There is approximately 'number' matching rows in
-			the range.
-*/
-
-ha_rows hp_rb_records_in_range(HP_INFO *info, int inx,
-                               const key_range *min_key,
-                               const key_range *max_key)
-{
-  ha_rows start_pos, end_pos;
-  HP_KEYDEF *keyinfo= info->s->keydef + inx;
-  TREE *rb_tree = &keyinfo->rb_tree;
-  heap_rb_param custom_arg;
-  DBUG_ENTER("hp_rb_records_in_range");
-
-  info->lastinx= inx;
-  custom_arg.keyseg= keyinfo->seg;
-  custom_arg.search_flag= SEARCH_FIND | SEARCH_SAME;
-  if (min_key)
-  {
-    custom_arg.key_length= hp_rb_pack_key(keyinfo, (uchar*) info->recbuf,
-					  (uchar*) min_key->key,
-					  min_key->keypart_map);
-    start_pos= tree_record_pos(rb_tree, info->recbuf, min_key->flag,
-			       &custom_arg);
-  }
-  else
-  {
-    start_pos= 0;
-  }
-
-  if (max_key)
-  {
-    custom_arg.key_length= hp_rb_pack_key(keyinfo, (uchar*) info->recbuf,
-					  (uchar*) max_key->key,
-                                          max_key->keypart_map);
-    end_pos= tree_record_pos(rb_tree, info->recbuf, max_key->flag,
-			     &custom_arg);
-  }
-  else
-  {
-    end_pos= rb_tree->elements_in_tree + (ha_rows)1;
-  }
-
-  DBUG_PRINT("info",("start_pos: %lu  end_pos: %lu", (ulong) start_pos,
-		     (ulong) end_pos));
-  if (start_pos == HA_POS_ERROR || end_pos == HA_POS_ERROR)
-    DBUG_RETURN(HA_POS_ERROR);
-  DBUG_RETURN(end_pos < start_pos ? (ha_rows) 0 :
-	      (end_pos == start_pos ? (ha_rows) 1 : end_pos - start_pos));
-}
-
-
 	/* Search after a record based on a key */
 	/* Sets info->current_ptr to found record */
 	/* next_flag:  Search=0, next=1, prev =2, same =3 */
@@ -31,7 +31,8 @@ HP_INFO *heap_open_from_share(HP_SHARE *share, int mode)
   DBUG_ENTER("heap_open_from_share");
 
   if (!(info= (HP_INFO*) my_malloc(hp_key_memory_HP_INFO,
-                                   sizeof(HP_INFO) + 2 * share->max_key_length,
+                                   sizeof(HP_INFO) + 2 * share->max_key_length +
+                                   share->blobs * sizeof(uchar*),
                                    MYF(MY_ZEROFILL +
                                        (share->internal ?
                                         MY_THREAD_SPECIFIC : 0)))))
@@ -41,7 +42,8 @@ HP_INFO *heap_open_from_share(HP_SHARE *share, int mode)
   share->open_count++; 
   thr_lock_data_init(&share->lock,&info->lock,NULL);
   info->s= share;
-  info->lastkey= (uchar*) (info + 1);
+  info->blob_chains= (uchar**) (info + 1);
+  info->lastkey= (uchar*) (info->blob_chains + share->blobs);
   info->recbuf= (uchar*) (info->lastkey + share->max_key_length);
   info->mode= mode;
   info->current_record= (ulong) ~0L;		/* No current record */
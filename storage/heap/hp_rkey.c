@@ -35,22 +35,16 @@ int heap_rkey(HP_INFO *info, uchar *record, int inx, const uchar *key,
 
   if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
   {
-    heap_rb_param custom_arg;
-
-    custom_arg.keyseg= info->s->keydef[inx].seg;
-    custom_arg.key_length= info->lastkey_len= 
-      hp_rb_pack_key(keyinfo, (uchar*) info->lastkey,
-		     (uchar*) key, keypart_map);
-    custom_arg.search_flag= SEARCH_FIND | SEARCH_SAME;
-    /* for next rkey() after deletion */
-    if (find_flag == HA_READ_AFTER_KEY)
-      info->last_find_flag= HA_READ_KEY_OR_NEXT;
-    else if (find_flag == HA_READ_BEFORE_KEY)
-      info->last_find_flag= HA_READ_KEY_OR_PREV;
-    else
-      info->last_find_flag= find_flag;
-    if (!(pos= tree_search_key(&keyinfo->rb_tree, info->lastkey, info->parents,
-			       &info->last_pos, find_flag, &custom_arg)))
+    uint key_length= hp_rb_pack_key(keyinfo, (uchar*) info->lastkey,
+                                    (uchar*) key, keypart_map);
+    /*
+      If nothing is found, heap_rnext() and heap_rprev() continue from the
+      searched key. Otherwise lastkey is replaced by the found key.
+    */
+    info->lastkey_len= key_length;
+    info->last_find_flag= HA_READ_KEY_OR_NEXT;
+    if (!(pos= hp_btree_search(info, keyinfo, info->lastkey, key_length,
+                               find_flag)))
     {
       info->update= HA_STATE_NO_KEY;
       DBUG_RETURN(my_errno= HA_ERR_KEY_NOT_FOUND);
@@ -69,6 +63,8 @@ int heap_rkey(HP_INFO *info, uchar *record, int inx, const uchar *key,
       memcpy(info->lastkey, key, (size_t) keyinfo->length);
   }
   memcpy(record, pos, (size_t) share->reclength);
+  if (share->blobs && hp_read_blobs(info, record))
+    DBUG_RETURN(my_errno);
   info->update= HA_STATE_AKTIV;
   DBUG_RETURN(0);
 }
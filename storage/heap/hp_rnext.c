@@ -31,8 +31,6 @@ int heap_rnext(HP_INFO *info, uchar *record)
   keyinfo = share->keydef + info->lastinx;
   if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
   {
-    heap_rb_param custom_arg;
-
     /* If no active record and last was not deleted */
     if (!(info->update & (HA_STATE_AKTIV | HA_STATE_NO_KEY |
                           HA_STATE_DELETED)))
@@ -42,51 +40,16 @@ int heap_rnext(HP_INFO *info, uchar *record)
       else
       {
         /* Last was 'prev' before first record; search after first record */
-        pos= tree_search_edge(&keyinfo->rb_tree, info->parents,
-                              &info->last_pos, offsetof(TREE_ELEMENT, left));
+        pos= hp_btree_first(info, keyinfo);
       }
     }
-    else if (info->last_pos)
-    {
-      /*
-        We enter this branch for non-DELETE queries after heap_rkey()
-        or heap_rfirst(). As last key position (info->last_pos) is available,
-        we only need to climb the tree using tree_search_next().
-      */
-      pos = tree_search_next(&keyinfo->rb_tree, &info->last_pos,
-                             offsetof(TREE_ELEMENT, left),
-                             offsetof(TREE_ELEMENT, right));
-    }
-    else if (!info->lastkey_len)
-    {
-      /*
-        We enter this branch only for DELETE queries after heap_rfirst(). E.g.
-        DELETE FROM t1 WHERE a<10. As last key position is not available
-        (last key is removed by heap_delete()), we must restart search as it
-        is done in heap_rfirst().
-
-        It should be safe to handle this situation without this branch. That is
-        branch below should find smallest element in a tree as lastkey_len is
-        zero. tree_search_edge() is a kind of optimisation here as it should be
-        faster than tree_search_key().
-      */
-      pos= tree_search_edge(&keyinfo->rb_tree, info->parents,
-                            &info->last_pos, offsetof(TREE_ELEMENT, left));
-    }
     else
     {
       /*
-        We enter this branch only for DELETE queries after heap_rkey(). E.g.
-        DELETE FROM t1 WHERE a=10. As last key position is not available
-        (last key is removed by heap_delete()), we must restart search as it
-        is done in heap_rkey().
+        Step to the next key. If the index was changed since the last
+        read, the last read key is searched for first.
       */
-      custom_arg.keyseg = keyinfo->seg;
-      custom_arg.key_length = info->lastkey_len;
-      custom_arg.search_flag = SEARCH_SAME | SEARCH_FIND;
-      info->last_find_flag= HA_READ_KEY_OR_NEXT;
-      pos = tree_search_key(&keyinfo->rb_tree, info->lastkey, info->parents, 
-                           &info->last_pos, info->last_find_flag, &custom_arg);
+      pos= hp_btree_next(info, keyinfo);
     }
     if (pos)
     {
@@ -101,11 +64,16 @@ int heap_rnext(HP_INFO *info, uchar *record)
   }
   else
   {
-    if (info->current_hash_ptr)
+    /*
+      An insert through another handler may have moved the hash entries
+      since the last read. Then the last read row is searched for again.
+    */
+    if (info->current_hash_ptr && info->key_version == share->key_version)
       pos= hp_search_next(info, keyinfo, info->lastkey,
 			   info->current_hash_ptr);
     else
     {
+      info->key_version= share->key_version;
       if (!info->current_ptr && (info->update & HA_STATE_NEXT_FOUND))
       {
 	pos=0;					/* Read next after last */
@@ -125,6 +93,8 @@ int heap_rnext(HP_INFO *info, uchar *record)
     DBUG_RETURN(my_errno);
   }
   memcpy(record,pos,(size_t) share->reclength);
+  if (share->blobs && hp_read_blobs(info, record))
+    DBUG_RETURN(my_errno);
   info->update=HA_STATE_AKTIV | HA_STATE_NEXT_FOUND;
   DBUG_RETURN(0);
 }
@@ -31,8 +31,6 @@ int heap_rprev(HP_INFO *info, uchar *record)
   keyinfo = share->keydef + info->lastinx;
   if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
   {
-    heap_rb_param custom_arg;
-
     /* If no active record and last was not deleted */
     if (!(info->update & (HA_STATE_AKTIV | HA_STATE_NO_KEY |
                           HA_STATE_DELETED)))
@@ -42,22 +40,16 @@ int heap_rprev(HP_INFO *info, uchar *record)
       else
       {
         /* Last was 'next' after last record; search after last record */
-        pos= tree_search_edge(&keyinfo->rb_tree, info->parents,
-                              &info->last_pos, offsetof(TREE_ELEMENT, right));
+        pos= hp_btree_last(info, keyinfo);
       }
     }
-    else if (info->last_pos)
-      pos = tree_search_next(&keyinfo->rb_tree, &info->last_pos,
-                             offsetof(TREE_ELEMENT, right),
-                             offsetof(TREE_ELEMENT, left));
     else
     {
-      custom_arg.keyseg = keyinfo->seg;
-      custom_arg.key_length = keyinfo->length;
-      custom_arg.search_flag = SEARCH_SAME;
-      info->last_find_flag= HA_READ_KEY_OR_PREV;
-      pos = tree_search_key(&keyinfo->rb_tree, info->lastkey, info->parents, 
-                           &info->last_pos, info->last_find_flag, &custom_arg);
+      /*
+        Step to the previous key. If the index was changed since the last
+        read, the last read key is searched for first.
+      */
+      pos= hp_btree_prev(info, keyinfo);
     }
     if (pos)
     {
@@ -93,6 +85,8 @@ int heap_rprev(HP_INFO *info, uchar *record)
     DBUG_RETURN(my_errno);
   }
   memcpy(record,pos,(size_t) share->reclength);
+  if (share->blobs && hp_read_blobs(info, record))
+    DBUG_RETURN(my_errno);
   info->update=HA_STATE_AKTIV | HA_STATE_PREV_FOUND;
   DBUG_RETURN(0);
 }
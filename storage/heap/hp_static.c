@@ -29,6 +29,8 @@ PSI_memory_key hp_key_memory_HP_INFO;
 PSI_memory_key hp_key_memory_HP_PTRS;
 PSI_memory_key hp_key_memory_HP_KEYDEF;
 
+PSI_rwlock_key hp_key_rwlock_HP_SHARE_latch;
+
 #ifdef HAVE_PSI_INTERFACE
 
 static PSI_memory_info all_heap_memory[]=
@@ -39,6 +41,11 @@ static PSI_memory_info all_heap_memory[]=
   { & hp_key_memory_HP_KEYDEF, "HP_KEYDEF", 0}
 };
 
+static PSI_rwlock_info all_heap_rwlocks[]=
+{
+  { & hp_key_rwlock_HP_SHARE_latch, "HP_SHARE::latch", 0}
+};
+
 void init_heap_psi_keys()
 {
   const char* category= "memory";
@@ -49,6 +56,9 @@ void init_heap_psi_keys()
 
   count= array_elements(all_heap_memory);
   mysql_memory_register(category, all_heap_memory, count);
+
+  count= array_elements(all_heap_rwlocks);
+  mysql_rwlock_register(category, all_heap_rwlocks, count);
 }
 #endif /* HAVE_PSI_INTERFACE */
 
@@ -44,6 +44,8 @@ int heap_write(HP_INFO *info, const uchar *record)
 #endif
   if (!(pos=next_free_record_pos(share)))
     DBUG_RETURN(my_errno);
+  if (share->blobs && hp_alloc_blobs(info, record))
+    goto err_blobs;
   share->changed=1;
 
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end;
@@ -54,10 +56,14 @@ int heap_write(HP_INFO *info, const uchar *record)
   }
 
   memcpy(pos,record,(size_t) share->reclength);
+  if (share->blobs)
+    hp_store_blob_chains(share, pos, info->blob_chains);
   pos[share->visible]= 1;                     /* Mark record as not deleted */
   if (++share->records == share->blength)
     share->blength+= share->blength;
-  info->s->key_version++;
+  /* hp_write_key() has kept the read position of this handler valid */
+  if (info->key_version == share->key_version++)
+    info->key_version= share->key_version;
   info->update|=HA_STATE_AKTIV;
 #if !defined(DBUG_OFF) && defined(EXTRA_HEAP_DEBUG)
   DBUG_EXECUTE("check_heap",heap_check_heap(info, 0););
@@ -86,7 +92,11 @@ int heap_write(HP_INFO *info, const uchar *record)
       break;
     keydef--;
   } 
+  share->key_version++;                         /* Hash entries may have moved */
+  if (share->blobs)
+    hp_free_blob_chains(share, info->blob_chains);
 
+err_blobs:
   share->deleted++;
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
@@ -96,36 +106,14 @@ int heap_write(HP_INFO *info, const uchar *record)
 } /* heap_write */
 
 /* 
-  Write a key to rb_tree-index 
+  Write a key to a BTREE index 
 */
 
 int hp_rb_write_key(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *record, 
 		    uchar *recpos)
 {
-  heap_rb_param custom_arg;
-  size_t old_allocated;
-
-  custom_arg.keyseg= keyinfo->seg;
-  custom_arg.key_length= hp_rb_make_key(keyinfo, info->recbuf, record, recpos);
-  if (keyinfo->flag & HA_NOSAME)
-  {
-    custom_arg.search_flag= SEARCH_FIND | SEARCH_UPDATE | SEARCH_INSERT;
-    keyinfo->rb_tree.flag= TREE_NO_DUPS;
-  }
-  else
-  {
-    custom_arg.search_flag= SEARCH_SAME;
-    keyinfo->rb_tree.flag= 0;
-  }
-  old_allocated= keyinfo->rb_tree.allocated;
-  if (!tree_insert(&keyinfo->rb_tree, (void*)info->recbuf,
-		   custom_arg.key_length, &custom_arg))
-  {
-    my_errno= HA_ERR_FOUND_DUPP_KEY;
-    return 1;
-  }
-  info->s->index_length+= (keyinfo->rb_tree.allocated-old_allocated);
-  return 0;
+  uint key_length= hp_rb_make_key(keyinfo, info->recbuf, record, recpos);
+  return hp_btree_insert(info->s, keyinfo, info->recbuf, key_length);
 }
 
 	/* Find where to place new record */
@@ -51,6 +51,7 @@ Created 10/16/1994 Heikki Tuuri
 #include "rem0rec.h"
 #include "rem0cmp.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
 #include "btr0btr.h"
 #include "btr0sea.h"
 #include "row0log.h"
@@ -7886,6 +7887,57 @@ btr_rec_free_updated_extern_fields(
 	}
 }
 
+/** Read ahead the BLOB pages that are expected to follow the current one.
+btr_store_big_rec_extern_fields() allocates each BLOB page with the
+hint prev_page_no + 1, so the chain is usually consecutive and can be
+requested before the next-page pointers are known. A window of at most
+innodb_blob_prefetch_pages is kept in flight; if the chain leaves the
+window, a new window is started at the current page.
+@param[in]	id		current BLOB page
+@param[in]	zip_size	ROW_FORMAT=COMPRESSED page size, or 0
+@param[in]	remaining	number of bytes still to be copied,
+including those on the current page
+@param[in]	payload		number of BLOB bytes per page
+@param[in,out]	low		first page of the read-ahead window
+@param[in,out]	high		first page after the read-ahead window */
+static
+void
+btr_blob_read_ahead(
+	page_id_t	id,
+	ulint		zip_size,
+	ulint		remaining,
+	ulint		payload,
+	uint32_t&	low,
+	uint32_t&	high)
+{
+	const ulint	window = srv_blob_prefetch_pages;
+
+	if (!window || remaining <= payload) {
+		return;
+	}
+
+	/* Number of pages that follow the current one */
+	const ulint	n_pages = std::min(window,
+					   (remaining + payload - 1) / payload
+					   - 1);
+	const uint32_t	next = id.page_no() + 1;
+
+	if (id.page_no() < low || id.page_no() >= high) {
+		low = high = next;
+	}
+
+	const ulint	ahead = high - next;
+
+	/* Refill when at most half of the window is still ahead. */
+	if (ahead >= n_pages || ahead > n_pages / 2) {
+		return;
+	}
+
+	const ulint	n = n_pages - ahead;
+	buf_read_ahead_blob(page_id_t(id.space(), high), zip_size, n);
+	high += uint32_t(n);
+}
+
 /*******************************************************************//**
 Copies the prefix of an uncompressed BLOB.  The clustered index record
 that points to this BLOB must be protected by a lock or a page latch.
@@ -7901,6 +7953,10 @@ btr_copy_blob_prefix(
 	uint32_t	offset)	/*!< in: offset on the first BLOB page */
 {
 	ulint	copied_len	= 0;
+	/* Space available in an uncompressed page to carry blob data */
+	const ulint	payload = srv_page_size - FIL_PAGE_DATA
+		- (BTR_BLOB_HDR_SIZE + FIL_PAGE_DATA_END);
+	uint32_t	ra_low = 0, ra_high = 0;
 
 	for (;;) {
 		mtr_t		mtr;
@@ -7910,6 +7966,9 @@ btr_copy_blob_prefix(
 		ulint		part_len;
 		ulint		copy_len;
 
+		btr_blob_read_ahead(id, 0, len - copied_len, payload,
+				    ra_low, ra_high);
+
 		mtr_start(&mtr);
 
 		block = buf_page_get(id, 0, RW_S_LATCH, &mtr);
@@ -7984,10 +8043,19 @@ btr_copy_zblob_prefix(
 	err = inflateInit(&d_stream);
 	ut_a(err == Z_OK);
 
+	/* The compressed length of the BLOB is not known; the
+	uncompressed length that remains to be copied is an upper
+	bound for the read-ahead. */
+	uint32_t	ra_low = 0, ra_high = 0;
+
 	for (;;) {
 		buf_page_t*	bpage;
 		uint32_t	next_page_no;
 
+		btr_blob_read_ahead(id, zip_size, d_stream.avail_out,
+				    zip_size - FIL_PAGE_DATA,
+				    ra_low, ra_high);
+
 		/* There is no latch on bpage directly.  Instead,
 		bpage is protected by the B-tree page latch that
 		is being held on the clustered index record, or,
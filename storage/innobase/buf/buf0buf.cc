@@ -1228,6 +1228,36 @@ buf_block_init(buf_block_t* block, byte* frame)
 	ut_ad(rw_lock_validate(&(block->lock)));
 }
 
+#ifdef HAVE_LIBNUMA
+/** Pick the NUMA node for the next buffer pool chunk (innodb_numa_node_local).
+The chunks are distributed round-robin over the allowed memory nodes.
+@return the node
+@retval -1 if no node is allowed */
+static int buf_chunk_next_numa_node()
+{
+  /* Chunks are created by buf_pool.create() or buf_pool.resize(),
+  never concurrently. */
+  static int next_node;
+  struct bitmask *numa_mems_allowed= numa_get_mems_allowed();
+  const int n_nodes= std::min(numa_max_node() + 1, 256);
+  int node= -1;
+
+  for (int i= 0; i < n_nodes; i++)
+  {
+    const int n= (next_node + i) % n_nodes;
+    if (numa_bitmask_isbitset(numa_mems_allowed, n))
+    {
+      node= n;
+      next_node= n + 1;
+      break;
+    }
+  }
+
+  numa_bitmask_free(numa_mems_allowed);
+  return node;
+}
+#endif /* HAVE_LIBNUMA */
+
 /** Allocate a chunk of buffer frames.
 @param bytes    requested size
 @return whether the allocation succeeded */
@@ -1245,6 +1275,7 @@ inline bool buf_pool_t::chunk_t::create(size_t bytes)
   MEM_UNDEFINED(mem, mem_size());
 
 #ifdef HAVE_LIBNUMA
+  int numa_node= 0;
   if (srv_numa_interleave)
   {
     struct bitmask *numa_mems_allowed= numa_get_mems_allowed();
@@ -1258,6 +1289,22 @@ inline bool buf_pool_t::chunk_t::create(size_t bytes)
     }
     numa_bitmask_free(numa_mems_allowed);
   }
+  else if (srv_numa_node_local && (numa_node= buf_chunk_next_numa_node()) >= 0)
+  {
+    struct bitmask *numa_mem= numa_allocate_nodemask();
+    numa_bitmask_setbit(numa_mem, numa_node);
+    if (mbind(mem, mem_size(), MPOL_PREFERRED,
+              numa_mem->maskp, numa_mem->size, MPOL_MF_MOVE))
+    {
+      ib::warn() << "Failed to set NUMA memory policy of"
+              " buffer pool page frames to MPOL_PREFERRED"
+              " (node " << numa_node << ", error: "
+              << strerror(errno) << ").";
+    }
+    numa_bitmask_free(numa_mem);
+  }
+  else
+    numa_node= 0;
 #endif /* HAVE_LIBNUMA */
 
 
@@ -1298,6 +1345,9 @@ inline bool buf_pool_t::chunk_t::create(size_t bytes)
 
   for (auto i= size; i--; ) {
     buf_block_init(block, frame);
+#ifdef HAVE_LIBNUMA
+    block->numa_node= uint8_t(numa_node);
+#endif /* HAVE_LIBNUMA */
     MEM_UNDEFINED(block->frame, srv_page_size);
     /* Add the block to the free list */
     UT_LIST_ADD_LAST(buf_pool.free, &block->page);
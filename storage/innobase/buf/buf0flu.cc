@@ -63,6 +63,10 @@ ulint buf_flush_page_count;
 /** Flag indicating if the page_cleaner is in active state. */
 bool buf_page_cleaner_is_active;
 
+/** Number of pages written by the page cleaner in its latest
+iteration, which normally covers one second; 0 when it is idle */
+Atomic_relaxed<ulint> buf_page_cleaner_last_pages;
+
 /** Factor for scan length to determine n_pages for intended oldest LSN
 progress */
 static constexpr ulint buf_flush_lsn_scan_factor = 3;
@@ -2125,6 +2129,7 @@ static os_thread_ret_t DECLARE_THREAD(buf_flush_page_cleaner)(void*)
         pthread_cond_broadcast(&buf_pool.done_flush_list);
       }
 unemployed:
+      buf_page_cleaner_last_pages= 0;
       buf_pool.page_cleaner_set_idle(true);
       continue;
     }
@@ -2208,6 +2213,8 @@ static os_thread_ret_t DECLARE_THREAD(buf_flush_page_cleaner)(void*)
       goto unemployed;
     }
 
+    buf_page_cleaner_last_pages= n_flushed;
+
 #ifdef UNIV_DEBUG
     while (innodb_page_cleaner_disabled_debug && !buf_flush_sync_lsn &&
            srv_shutdown_state == SRV_SHUTDOWN_NONE)
@@ -38,6 +38,10 @@ Created 11/5/1995 Heikki Tuuri
 #include "log0recv.h"
 #include "srv0srv.h"
 #include "srv0mon.h"
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#include <sched.h>
+#endif /* HAVE_LIBNUMA */
 
 /** Flush this many pages in buf_LRU_get_free_block() */
 size_t innodb_lru_flush_size;
@@ -278,6 +282,46 @@ bool buf_LRU_scan_and_free_block(ulint limit)
     buf_LRU_free_from_common_LRU_list(limit);
 }
 
+#ifdef HAVE_LIBNUMA
+/** Maximum number of buf_pool.free entries to inspect when looking for
+a block on the NUMA node of the current thread */
+static constexpr ulint BUF_LRU_FREE_NUMA_SEARCH = 32;
+
+/** @return the first block of buf_pool.free that resides on the NUMA node
+of the calling thread, or the first block if there is none among the first
+BUF_LRU_FREE_NUMA_SEARCH entries (innodb_numa_node_local) */
+static buf_block_t* buf_LRU_get_free_first()
+{
+	buf_page_t*	first = UT_LIST_GET_FIRST(buf_pool.free);
+
+	if (!srv_numa_node_local || srv_numa_interleave || !first) {
+		return reinterpret_cast<buf_block_t*>(first);
+	}
+
+	const int	cpu = sched_getcpu();
+	const int	node = cpu < 0 ? -1 : numa_node_of_cpu(cpu);
+
+	if (node < 0) {
+		return reinterpret_cast<buf_block_t*>(first);
+	}
+
+	ulint	n = BUF_LRU_FREE_NUMA_SEARCH;
+
+	for (buf_page_t* bpage = first; bpage && n--;
+	     bpage = UT_LIST_GET_NEXT(list, bpage)) {
+		buf_block_t*	block = reinterpret_cast<buf_block_t*>(bpage);
+		if (block->numa_node == node) {
+			return block;
+		}
+	}
+
+	return reinterpret_cast<buf_block_t*>(first);
+}
+#else
+# define buf_LRU_get_free_first() \
+	reinterpret_cast<buf_block_t*>(UT_LIST_GET_FIRST(buf_pool.free))
+#endif /* HAVE_LIBNUMA */
+
 /** @return a buffer block from the buf_pool.free list
 @retval	NULL	if the free list is empty */
 buf_block_t* buf_LRU_get_free_only()
@@ -286,8 +330,7 @@ buf_block_t* buf_LRU_get_free_only()
 
 	mysql_mutex_assert_owner(&buf_pool.mutex);
 
-	block = reinterpret_cast<buf_block_t*>(
-		UT_LIST_GET_FIRST(buf_pool.free));
+	block = buf_LRU_get_free_first();
 
 	while (block != NULL) {
 		ut_ad(block->page.in_free_list);
@@ -316,8 +359,7 @@ buf_block_t* buf_LRU_get_free_only()
 			&block->page);
 		ut_d(block->in_withdraw_list = true);
 
-		block = reinterpret_cast<buf_block_t*>(
-			UT_LIST_GET_FIRST(buf_pool.free));
+		block = buf_LRU_get_free_first();
 	}
 
 	return(block);
@@ -723,6 +723,56 @@ buf_read_ahead_linear(const page_id_t page_id, ulint zip_size, bool ibuf)
   return count;
 }
 
+/** Issue asynchronous read requests for the pages of an off-page column
+(BLOB) that are expected to follow in the page chain. The pages of a BLOB
+are allocated with a hint to be consecutive, so that in the common case
+they can be read ahead without knowing the next-page pointers yet.
+NOTE: the calling thread may hold latches on the clustered index page;
+this function never waits for page latches or for the reads to complete.
+@param[in]	page_id		first page to read
+@param[in]	zip_size	ROW_FORMAT=COMPRESSED page size, or 0
+@param[in]	n		number of pages to read
+@return number of page read requests issued */
+ulint buf_read_ahead_blob(const page_id_t page_id, ulint zip_size, ulint n)
+{
+  if (!n || srv_startup_is_before_trx_rollback_phase)
+    return 0;
+
+  if (buf_pool.n_pend_reads > buf_pool.curr_size / BUF_READ_AHEAD_PEND_LIMIT)
+    return 0;
+
+  fil_space_t *space= fil_space_t::get(page_id.space());
+  if (!space)
+    return 0;
+
+  page_id_t high= page_id;
+  high.set_page_no(uint32_t(std::min<ulint>(ulint{page_id.page_no()} + n,
+                                            space->last_page_number() + 1)));
+
+  ulint count= 0;
+  for (page_id_t i= page_id; i < high; ++i)
+  {
+    if (ibuf_bitmap_page(i, zip_size))
+      continue;
+    if (space->is_stopping())
+      break;
+    dberr_t err;
+    space->reacquire();
+    count+= buf_read_page_low(&err, space, false, BUF_READ_ANY_PAGE, i,
+                              zip_size, false);
+  }
+
+  if (count)
+    DBUG_PRINT("ib_buf", ("BLOB read-ahead %zu pages from %s: %u",
+                          count, space->chain.start->name,
+                          page_id.page_no()));
+  space->release();
+
+  buf_pool.stat.n_ra_pages_read+= count;
+  srv_stats.buf_pool_reads.add(count);
+  return count;
+}
+
 /** Issues read requests for pages which recovery wants to read in.
 @param[in]	space_id	tablespace id
 @param[in]	page_nos	array of page numbers to read, with the
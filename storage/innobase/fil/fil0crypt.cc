@@ -32,6 +32,8 @@ Modified           Jan Lindström jan.lindstrom@mariadb.com
 # include "buf0buf.h"
 #else
 #include "buf0dblwr.h"
+#include "buf0flu.h"
+#include "buf0rea.h"
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "mtr0mtr.h"
@@ -1121,6 +1123,7 @@ struct rotate_thread_t {
 	bool first;		    /*!< is position before first space */
 	fil_space_t* space;	    /*!< current space or NULL */
 	uint32_t offset;	    /*!< current page number */
+	uint32_t read_ahead;	    /*!< first page not yet read ahead */
 	ulint batch;		    /*!< #pages to rotate */
 	uint  min_key_version_found;/*!< min key version found but not rotated */
 	lsn_t end_lsn;		    /*!< max lsn when rotating this space */
@@ -1271,6 +1274,20 @@ fil_crypt_update_total_stat(
 	state->crypt_stat.estimated_iops = state->estimated_max_iops;
 }
 
+/** @return the number of iops that key rotation may currently use:
+innodb_encryption_rotation_iops, reduced in proportion to the part of
+innodb_io_capacity that the page cleaner used during its latest
+iteration, but never below 10% */
+static uint fil_crypt_iops_budget()
+{
+	const ulint used = std::min<ulint>(buf_page_cleaner_last_pages,
+					   srv_io_capacity);
+	const uint budget = uint(srv_n_fil_crypt_iops
+				 * (srv_io_capacity - used)
+				 / srv_io_capacity);
+	return std::max(budget, std::max(srv_n_fil_crypt_iops / 10, 1U));
+}
+
 /***********************************************************************
 Allocate iops to thread from global setting,
 used before starting to rotate a space.
@@ -1288,15 +1305,17 @@ fil_crypt_alloc_iops(
 	its status yet. */
 
 	uint max_iops = state->estimated_max_iops;
+	const uint budget = fil_crypt_iops_budget();
 	mutex_enter(&fil_crypt_threads_mutex);
 
-	if (n_fil_crypt_iops_allocated >= srv_n_fil_crypt_iops) {
-		/* this can happen when user decreases srv_fil_crypt_iops */
+	if (n_fil_crypt_iops_allocated >= budget) {
+		/* this can happen when user decreases srv_fil_crypt_iops,
+		or when the page cleaner is busy */
 		mutex_exit(&fil_crypt_threads_mutex);
 		return false;
 	}
 
-	uint alloc = srv_n_fil_crypt_iops - n_fil_crypt_iops_allocated;
+	uint alloc = budget - n_fil_crypt_iops_allocated;
 
 	if (alloc > max_iops) {
 		alloc = max_iops;
@@ -1349,9 +1368,24 @@ fil_crypt_realloc_iops(
 			    / (state->batch ? state->batch : 1)));
 	}
 
-	if (state->estimated_max_iops <= state->allocated_iops) {
+	const uint budget = fil_crypt_iops_budget();
+	uint max_iops = state->estimated_max_iops;
+
+	if (n_fil_crypt_iops_allocated > budget) {
+		/* The page cleaner is busy (dirty read of
+		n_fil_crypt_iops_allocated): give back our share
+		of the excess. */
+		const uint excess = std::min<uint>(
+			n_fil_crypt_iops_allocated - budget,
+			state->allocated_iops);
+		if (state->allocated_iops - excess < max_iops) {
+			max_iops = state->allocated_iops - excess;
+		}
+	}
+
+	if (max_iops <= state->allocated_iops) {
 		/* return extra iops */
-		uint extra = state->allocated_iops - state->estimated_max_iops;
+		uint extra = state->allocated_iops - max_iops;
 
 		if (extra > 0) {
 			mutex_enter(&fil_crypt_threads_mutex);
@@ -1379,10 +1413,9 @@ fil_crypt_realloc_iops(
 	} else {
 		/* see if there are more to get */
 		mutex_enter(&fil_crypt_threads_mutex);
-		if (n_fil_crypt_iops_allocated < srv_n_fil_crypt_iops) {
+		if (n_fil_crypt_iops_allocated < budget) {
 			/* there are extra iops free */
-			uint extra = srv_n_fil_crypt_iops -
-				n_fil_crypt_iops_allocated;
+			uint extra = budget - n_fil_crypt_iops_allocated;
 			if (state->allocated_iops + extra >
 			    state->estimated_max_iops) {
 				/* but don't alloc more than our max */
@@ -1679,6 +1712,39 @@ fil_crypt_start_rotate_space(
 	mutex_exit(&crypt_data->mutex);
 }
 
+/** Interval between key rotation progress messages, in seconds */
+static constexpr time_t FIL_CRYPT_PROGRESS_INTERVAL = 60;
+
+/** Report the progress of rotating a tablespace to the error log,
+at most once per FIL_CRYPT_PROGRESS_INTERVAL.
+@param[in]	space		tablespace being rotated
+@param[in,out]	rotate_state	rotation state of the tablespace */
+static void fil_crypt_report_progress(const fil_space_t& space,
+				      fil_space_rotate_state_t& rotate_state)
+{
+	const time_t now = time(NULL);
+
+	if (now - std::max(rotate_state.start_time,
+			   rotate_state.progress_time)
+	    < FIL_CRYPT_PROGRESS_INTERVAL) {
+		return;
+	}
+
+	rotate_state.progress_time = now;
+
+	const ulint max_offset = std::max(rotate_state.max_offset, 1U);
+	const ulint done = std::min(rotate_state.next_offset,
+				    rotate_state.max_offset);
+	const ulint elapsed = ulint(now - rotate_state.start_time);
+
+	ib::info() << "Key rotation of " << space.name << ": " << done
+		<< " of " << max_offset << " pages ("
+		<< done * 100 / max_offset << "%) in " << elapsed
+		<< " seconds, about "
+		<< (done ? elapsed * (max_offset - done) / done : 0)
+		<< " seconds remaining";
+}
+
 /***********************************************************************
 Search for batch of pages needing rotation
 @param[in]	key_state		Key state
@@ -1721,6 +1787,11 @@ fil_crypt_find_page_to_rotate(
 	}
 
 	crypt_data->rotate_state.next_offset += uint32_t(batch);
+
+	if (found) {
+		fil_crypt_report_progress(*space, crypt_data->rotate_state);
+	}
+
 	mutex_exit(&crypt_data->mutex);
 	return found;
 }
@@ -1779,7 +1850,10 @@ fil_crypt_get_page_throttle_func(
 		return NULL;
 	}
 
-	state->crypt_stat.pages_read_from_disk++;
+	if (offset >= state->read_ahead) {
+		/* otherwise counted in fil_crypt_read_ahead() */
+		state->crypt_stat.pages_read_from_disk++;
+	}
 
 	const ulonglong start = my_interval_timer();
 	block = buf_page_get_gen(page_id, zip_size,
@@ -1794,6 +1868,12 @@ fil_crypt_get_page_throttle_func(
 		state->sum_waited_us += (end - start) / 1000;
 	}
 
+	if (offset < state->read_ahead) {
+		/* The read was issued and throttled by
+		fil_crypt_read_ahead(). */
+		return block;
+	}
+
 	/* average page load */
 	ulint add_sleeptime_ms = 0;
 	ulint avg_wait_time_us =ulint(state->sum_waited_us / state->cnt_waited);
@@ -1940,6 +2020,44 @@ fil_crypt_rotate_page(
 	}
 }
 
+/** Read ahead the pages that are about to be rotated, so that the reads
+overlap with the rotation of the preceding pages. The reads are throttled
+to the allocated iops.
+@param[in,out]	state	rotation state
+@param[in]	end	end of the read-ahead window */
+static void fil_crypt_read_ahead(rotate_thread_t* state, uint32_t end)
+{
+	fil_space_t*	space = state->space;
+	const ulint	zip_size = space->zip_size();
+	ulint		n_reads = 0;
+
+	for (; state->read_ahead < end; state->read_ahead++) {
+		const page_id_t page_id(space->id, state->read_ahead);
+
+		if (space->is_stopping()) {
+			return;
+		}
+
+		if (buf_dblwr.is_inside(page_id)
+		    || buf_pool.page_hash_contains(page_id)
+		    || fseg_page_is_free(space, state->read_ahead)) {
+			continue;
+		}
+
+		space->reacquire();
+		buf_read_page_background(space, page_id, zip_size, false);
+		state->crypt_stat.pages_read_from_disk++;
+		n_reads++;
+	}
+
+	if (n_reads) {
+		os_event_reset(fil_crypt_throttle_sleep_event);
+		os_event_wait_time(fil_crypt_throttle_sleep_event,
+				   n_reads * 1000000
+				   / std::max(state->allocated_iops, 1U));
+	}
+}
+
 /***********************************************************************
 Rotate a batch of pages
 @param[in,out]		key_state		Key state
@@ -1956,7 +2074,13 @@ fil_crypt_rotate_pages(
 
 	ut_ad(state->space->referenced());
 
+	/* Keep about one second worth of reads in flight. */
+	const uint32_t window = std::max(state->allocated_iops, 1U);
+	state->read_ahead = state->offset;
+
 	for (; state->offset < end; state->offset++) {
+		fil_crypt_read_ahead(state,
+				     std::min(end, state->offset + window));
 
 		/* we can't rotate pages in dblwr buffer as
 		* it's not possible to read those due to lots of asserts
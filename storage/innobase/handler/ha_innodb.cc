@@ -19678,6 +19678,13 @@ static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Use NUMA interleave memory policy to allocate InnoDB buffer pool.",
   NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(numa_node_local, srv_numa_node_local,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Bind each InnoDB buffer pool chunk to a NUMA node and prefer"
+  " free pages on the node of the requesting thread"
+  " (ignored if innodb_numa_interleave is set).",
+  NULL, NULL, FALSE);
 #endif /* HAVE_LIBNUMA */
 
 static MYSQL_SYSVAR_ENUM(change_buffering, innodb_change_buffering,
@@ -19693,6 +19700,13 @@ static MYSQL_SYSVAR_UINT(change_buffer_max_size,
   NULL, innodb_change_buffer_max_size_update,
   CHANGE_BUFFER_DEFAULT_SIZE, 0, 50, 0);
 
+static MYSQL_SYSVAR_UINT(change_buffer_merge_pct,
+  srv_change_buffer_merge_pct,
+  PLUGIN_VAR_RQCMDARG,
+  "Percentage of innodb_io_capacity that may be used for merging"
+  " the change buffer in the background (0=merge only when pages are read)",
+  NULL, NULL, 0, 0, 100, 0);
+
 static MYSQL_SYSVAR_ENUM(stats_method, srv_innodb_stats_method,
    PLUGIN_VAR_RQCMDARG,
   "Specifies how InnoDB index statistics collection code should"
@@ -19764,6 +19778,12 @@ static MYSQL_SYSVAR_ULONG(read_ahead_threshold, srv_read_ahead_threshold,
   " trigger a readahead.",
   NULL, NULL, 56, 0, 64, 0);
 
+static MYSQL_SYSVAR_UINT(blob_prefetch_pages, srv_blob_prefetch_pages,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of pages of an off-page column (BLOB) to read ahead"
+  " while reading it (0=disable)",
+  NULL, NULL, 64, 0, 1024, 0);
+
 static MYSQL_SYSVAR_STR(monitor_enable, innobase_enable_monitor_counter,
   PLUGIN_VAR_RQCMDARG,
   "Turn on a monitor counter",
@@ -20140,9 +20160,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(use_native_aio),
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
+  MYSQL_SYSVAR(numa_node_local),
 #endif /* HAVE_LIBNUMA */
   MYSQL_SYSVAR(change_buffering),
   MYSQL_SYSVAR(change_buffer_max_size),
+  MYSQL_SYSVAR(change_buffer_merge_pct),
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
   MYSQL_SYSVAR(change_buffer_dump),
   MYSQL_SYSVAR(change_buffering_debug),
@@ -20152,6 +20174,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* WITH_INNODB_DISALLOW_WRITES */
   MYSQL_SYSVAR(random_read_ahead),
   MYSQL_SYSVAR(read_ahead_threshold),
+  MYSQL_SYSVAR(blob_prefetch_pages),
   MYSQL_SYSVAR(read_only),
   MYSQL_SYSVAR(instant_alter_column_allowed),
   MYSQL_SYSVAR(io_capacity),
@@ -2573,6 +2573,190 @@ ulint ibuf_merge_all()
 	return sum_bytes;
 }
 
+/** Maximum number of index pages that are read ahead and merged in
+one batch by the background change buffer merge */
+static constexpr ulint IBUF_BACKGROUND_MERGE_BATCH = 64;
+
+/** Position from which the next background merge batch continues
+scanning the change buffer tree; only accessed by ibuf_merge_task */
+static page_id_t ibuf_background_merge_pos{0, 0};
+
+/** Collect the next index pages that have buffered changes, in the
+order of the change buffer tree, that is, sorted by (space, page).
+@param[out]	space_ids	tablespace identifiers
+@param[out]	page_nos	page numbers
+@param[in]	max_pages	maximum number of pages to collect
+@return number of pages collected */
+static ulint ibuf_background_merge_collect(uint32_t* space_ids,
+					   uint32_t* page_nos,
+					   ulint max_pages)
+{
+	mtr_t		mtr;
+	btr_pcur_t	pcur;
+	mem_heap_t*	heap = mem_heap_create(512);
+	ulint		n = 0;
+
+	ibuf_mtr_start(&mtr);
+	btr_pcur_open_on_user_rec(
+		ibuf.index,
+		ibuf_search_tuple_build(ibuf_background_merge_pos.space(),
+					ibuf_background_merge_pos.page_no(),
+					heap),
+		PAGE_CUR_GE, BTR_SEARCH_LEAF, &pcur, &mtr);
+	mem_heap_free(heap);
+
+	while (btr_pcur_is_on_user_rec(&pcur)) {
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+		const uint32_t	space_id = ibuf_rec_get_space(&mtr, rec);
+		const uint32_t	page_no = ibuf_rec_get_page_no(&mtr, rec);
+
+		if (!n || space_ids[n - 1] != space_id
+		    || page_nos[n - 1] != page_no) {
+			if (n == max_pages) {
+				break;
+			}
+			space_ids[n] = space_id;
+			page_nos[n] = page_no;
+			n++;
+		}
+
+		if (!btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+			break;
+		}
+	}
+
+	const bool at_end = !btr_pcur_is_on_user_rec(&pcur);
+
+	ibuf_mtr_commit(&mtr);
+	btr_pcur_close(&pcur);
+
+	/* Continue after the last collected page, or wrap around to the
+	start of the tree once the end has been reached. */
+	ibuf_background_merge_pos = at_end || !n
+		? page_id_t(0, 0)
+		: page_id_t(space_ids[n - 1], page_nos[n - 1] + 1);
+
+	return n;
+}
+
+/** Merge buffered changes to up to n_pages index pages. The pages
+are collected in (space, page) order and read ahead asynchronously in
+batches, so that the merge of a batch overlaps with its reads.
+@param[in]	n_pages	maximum number of index pages to merge
+@return number of index pages merged */
+static ulint ibuf_merge_in_background(ulint n_pages)
+{
+	uint32_t	space_ids[IBUF_BACKGROUND_MERGE_BATCH];
+	uint32_t	page_nos[IBUF_BACKGROUND_MERGE_BATCH];
+	ulint		n_merged = 0;
+
+	while (n_merged < n_pages
+	       && srv_shutdown_state <= SRV_SHUTDOWN_INITIATED) {
+		/* Dirty read of ibuf.empty, like in ibuf_merge() */
+		if (ibuf.empty) {
+			break;
+		}
+
+		const ulint n = ibuf_background_merge_collect(
+			space_ids, page_nos,
+			std::min(n_pages - n_merged,
+				 IBUF_BACKGROUND_MERGE_BATCH));
+		if (!n) {
+			break;
+		}
+
+		/* Issue the reads first; ibuf_read_merge_pages() will
+		wait for each of them and apply the buffered changes. */
+		for (ulint i = 0; i < n; i++) {
+			fil_space_t* s = fil_space_t::get(space_ids[i]);
+			if (!s) {
+				continue;
+			}
+			if (page_nos[i] < s->size) {
+				buf_read_page_background(
+					s, page_id_t(space_ids[i],
+						     page_nos[i]),
+					s->zip_size(), false);
+			} else {
+				s->release();
+			}
+		}
+
+		ibuf_read_merge_pages(space_ids, page_nos, n);
+		n_merged += n;
+
+		if (ibuf_background_merge_pos == page_id_t(0, 0)) {
+			/* We reached the end of the tree; leave the
+			rest for the next invocation. */
+			break;
+		}
+	}
+
+	ibuf.n_background_merges += n_merged;
+	return n_merged;
+}
+
+/** Number of index pages that ibuf_merge_task may merge */
+static Atomic_relaxed<ulint> ibuf_background_merge_budget;
+
+/** Run the background change buffer merge for one budget. */
+static void ibuf_merge_callback(void*)
+{
+	const ulint	size_before = ibuf.size;
+	const ulonglong	start = microsecond_interval_timer();
+
+	if (!ibuf_merge_in_background(ibuf_background_merge_budget)) {
+		ibuf.drain_time = 0;
+		return;
+	}
+
+	/* Estimate the drain time from the rate at which the background
+	merge shrinks the change buffer tree. The merge is submitted once
+	per second, so assume at most one budget per second. The dirty
+	reads of ibuf.size are fine for an estimate. */
+	const ulint size_after = ibuf.size;
+
+	if (size_after < size_before) {
+		const ulonglong elapsed = std::max<ulonglong>(
+			microsecond_interval_timer() - start, 1000000);
+		ibuf.drain_time = ulint(size_after * elapsed
+					/ ((size_before - size_after)
+					   * 1000000ULL));
+	}
+}
+
+/** Ensure that the background merge does not run concurrently */
+static tpool::task_group ibuf_merge_task_group(1);
+/** The background change buffer merge task */
+static tpool::waitable_task ibuf_merge_task(ibuf_merge_callback, nullptr,
+					    &ibuf_merge_task_group);
+
+/** Submit the background change buffer merge.
+@param n_pages	maximum number of index pages to merge */
+void ibuf_merge_in_background_start(ulint n_pages)
+{
+	if (!n_pages || ibuf.empty || ibuf_merge_task.is_running()
+	    || srv_read_only_mode
+	    || srv_force_recovery >= SRV_FORCE_NO_IBUF_MERGE) {
+		return;
+	}
+#if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
+	if (ibuf_debug) {
+		return;
+	}
+#endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
+
+	ibuf_background_merge_budget = n_pages;
+	srv_thread_pool->submit_task(&ibuf_merge_task);
+}
+
+/** Wait for the background change buffer merge to finish,
+and prevent it from being started again. */
+void ibuf_merge_in_background_shutdown()
+{
+	ibuf_merge_task.disable();
+}
+
 /*********************************************************************//**
 Contract insert buffer trees after insert if they are too big. */
 UNIV_INLINE
@@ -4617,6 +4801,11 @@ ibuf_print(
 	fputs("discarded operations:\n ", file);
 	ibuf_print_ops(ibuf.n_discarded_ops, file);
 
+	fprintf(file,
+		"background merge: " ULINTPF " pages merged,"
+		" estimated drain time " ULINTPF " s\n",
+		ulint{ibuf.n_background_merges}, ibuf.drain_time);
+
 	mutex_exit(&ibuf_mutex);
 }
 
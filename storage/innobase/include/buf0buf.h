@@ -1061,6 +1061,10 @@ struct buf_block_t{
 					a block is in the unzip_LRU list
 					if page.state() == BUF_BLOCK_FILE_PAGE
 					and page.zip.data != NULL */
+#ifdef HAVE_LIBNUMA
+	/** NUMA node that frame is bound to (if innodb_numa_node_local) */
+	uint8_t		numa_node;
+#endif /* HAVE_LIBNUMA */
 	/* @} */
 	/** @name Optimistic search field */
 	/* @{ */
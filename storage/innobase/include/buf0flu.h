@@ -40,6 +40,10 @@ extern ulint buf_lru_flush_page_count;
 /** Flag indicating if the page_cleaner is in active state. */
 extern bool buf_page_cleaner_is_active;
 
+/** Number of pages written by the page cleaner in its latest
+iteration, which normally covers one second; 0 when it is idle */
+extern Atomic_relaxed<ulint> buf_page_cleaner_last_pages;
+
 #ifdef UNIV_DEBUG
 
 /** Value of MySQL global variable used to disable page cleaner. */
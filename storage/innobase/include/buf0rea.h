@@ -102,6 +102,15 @@ which could result in a deadlock if the OS does not support asynchronous io.
 ulint
 buf_read_ahead_linear(const page_id_t page_id, ulint zip_size, bool ibuf);
 
+/** Issue asynchronous read requests for the pages of an off-page column
+(BLOB) that are expected to follow in the page chain. Does not wait for
+page latches or for the reads to complete.
+@param[in]	page_id		first page to read
+@param[in]	zip_size	ROW_FORMAT=COMPRESSED page size, or 0
+@param[in]	n		number of pages to read
+@return number of page read requests issued */
+ulint buf_read_ahead_blob(const page_id_t page_id, ulint zip_size, ulint n);
+
 /** Issues read requests for pages which recovery wants to read in.
 @param[in]	space_id	tablespace id
 @param[in]	page_nos	array of page numbers to read, with the
@@ -84,6 +84,7 @@ crypt_data_scheme_locker(
 struct fil_space_rotate_state_t
 {
 	time_t start_time;	/*!< time when rotation started */
+	time_t progress_time;	/*!< time of the latest progress report */
 	ulint active_threads;	/*!< active threads in space */
 	uint32_t next_offset;	/*!< next "free" offset */
 	uint32_t max_offset;	/*!< max offset needing to be rotated */
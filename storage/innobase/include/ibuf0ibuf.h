@@ -346,6 +346,15 @@ will be merged from ibuf trees to the pages read, 0 if ibuf is
 empty */
 ulint ibuf_merge_all();
 
+/** Submit the background change buffer merge, which reads pages with
+buffered changes in (space, page) order and merges the changes.
+@param n_pages	maximum number of index pages to merge */
+void ibuf_merge_in_background_start(ulint n_pages);
+
+/** Wait for the background change buffer merge to finish,
+and prevent it from being started again. */
+void ibuf_merge_in_background_shutdown();
+
 /** Contracts insert buffer trees by reading pages referring to space_id
 to the buffer pool.
 @returns number of pages merged.*/
@@ -377,6 +377,8 @@ enum monitor_id_t {
 	MONITOR_OVLD_IBUF_MERGE_DISCARD_PURGE,
 	MONITOR_OVLD_IBUF_MERGES,
 	MONITOR_OVLD_IBUF_SIZE,
+	MONITOR_OVLD_IBUF_BACKGROUND_MERGES,
+	MONITOR_OVLD_IBUF_DRAIN_TIME,
 
 	/* Counters for server operations */
 	MONITOR_MODULE_SERVER,
@@ -242,6 +242,7 @@ use simulated aio.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
 extern my_bool	srv_numa_interleave;
+extern my_bool	srv_numa_node_local;
 
 /* Use atomic writes i.e disable doublewrite buffer */
 extern my_bool srv_use_atomic_writes;
@@ -335,6 +336,8 @@ extern ulint	srv_lock_table_size;
 extern uint	srv_n_file_io_threads;
 extern my_bool	srv_random_read_ahead;
 extern ulong	srv_read_ahead_threshold;
+/** innodb_blob_prefetch_pages */
+extern uint	srv_blob_prefetch_pages;
 extern uint	srv_n_read_io_threads;
 extern uint	srv_n_write_io_threads;
 
@@ -349,6 +352,7 @@ extern uint	srv_defragment_frequency;
 extern ulonglong	srv_defragment_interval;
 
 extern uint	srv_change_buffer_max_size;
+extern uint	srv_change_buffer_merge_pct;
 
 /* Number of IO operations per second the server can do */
 extern ulong    srv_io_capacity;
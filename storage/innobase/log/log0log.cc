@@ -44,6 +44,7 @@ Created 12/9/1995 Heikki Tuuri
 #include "fil0fil.h"
 #include "dict0stats_bg.h"
 #include "btr0defragment.h"
+#include "ibuf0ibuf.h"
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "trx0sys.h"
@@ -1002,6 +1003,7 @@ ATTRIBUTE_COLD void logs_empty_and_mark_files_at_shutdown()
 
 	/* Wait for the end of the buffer resize task.*/
 	buf_resize_shutdown();
+	ibuf_merge_in_background_shutdown();
 	dict_stats_shutdown();
 	btr_defragment_shutdown();
 
@@ -1094,6 +1094,19 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_IBUF_SIZE},
 
+	{"ibuf_background_merges", "change_buffer",
+	 "Number of pages merged by the background change buffer merge",
+	 static_cast<monitor_type_t>(
+	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_IBUF_BACKGROUND_MERGES},
+
+	{"ibuf_drain_time", "change_buffer",
+	 "Estimated seconds for the background merge to empty"
+	 " the change buffer",
+	 static_cast<monitor_type_t>(
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT | MONITOR_DEFAULT_ON),
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_IBUF_DRAIN_TIME},
+
 	/* ========== Counters for server operations ========== */
 	{"module_innodb", "innodb",
 	 "Counter for general InnoDB server wide operations and properties",
@@ -1891,6 +1904,14 @@ srv_mon_process_existing_counter(
 		value = ibuf.size;
 		break;
 
+	case MONITOR_OVLD_IBUF_BACKGROUND_MERGES:
+		value = ibuf.n_background_merges;
+		break;
+
+	case MONITOR_OVLD_IBUF_DRAIN_TIME:
+		value = ibuf.drain_time;
+		break;
+
 	case MONITOR_OVLD_SERVER_ACTIVITY:
 		value = srv_get_activity_count();
 		break;
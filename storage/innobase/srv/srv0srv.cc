@@ -143,6 +143,9 @@ use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio;
 my_bool	srv_numa_interleave;
+/** innodb_numa_node_local: whether to bind each buffer pool chunk to
+a NUMA node and prefer free blocks on the node of the requesting thread */
+my_bool	srv_numa_node_local;
 /** copy of innodb_use_atomic_writes; @see innodb_init_params() */
 my_bool	srv_use_atomic_writes;
 /** innodb_compression_algorithm; used with page compression */
@@ -235,11 +238,18 @@ my_bool	srv_random_read_ahead;
 in the buffer cache and accessed sequentially for InnoDB to trigger a
 readahead request. */
 ulong	srv_read_ahead_threshold;
+/** innodb_blob_prefetch_pages; the maximum number of pages of an
+off-page column to read ahead while following the BLOB page chain. */
+uint	srv_blob_prefetch_pages;
 
 /** innodb_change_buffer_max_size; maximum on-disk size of change
 buffer in terms of percentage of the buffer pool. */
 uint	srv_change_buffer_max_size;
 
+/** innodb_change_buffer_merge_pct; percentage of innodb_io_capacity
+that the background change buffer merge may use */
+uint	srv_change_buffer_merge_pct;
+
 ulong	srv_file_flush_method;
 
 
@@ -1643,6 +1653,27 @@ srv_master_thread_disabled_debug_update(THD*, st_mysql_sys_var*, void*,
 }
 #endif /* UNIV_DEBUG */
 
+/** Submit the background change buffer merge, limited by
+innodb_change_buffer_merge_pct and by the part of innodb_io_capacity
+that was not used for writing pages during the past second. */
+static void srv_master_merge_ibuf()
+{
+	static ulint	old_n_pages_written;
+	const ulint	n_pages_written = buf_pool.stat.n_pages_written;
+	const ulint	n_written = n_pages_written - old_n_pages_written;
+	old_n_pages_written = n_pages_written;
+
+	if (!srv_change_buffer_merge_pct || n_written >= srv_io_capacity) {
+		return;
+	}
+
+	srv_main_thread_op_info = "starting change buffer merge";
+	ibuf_merge_in_background_start(
+		std::min<ulint>(srv_io_capacity - n_written,
+				srv_io_capacity * srv_change_buffer_merge_pct
+				/ 100));
+}
+
 /*********************************************************************//**
 Perform the tasks that the master thread is supposed to do when the
 server is active. There are two types of tasks. The first category is
@@ -1697,6 +1728,8 @@ srv_master_do_active_tasks(void)
 		return;
 	}
 
+	srv_master_merge_ibuf();
+
 	if (cur_time % SRV_MASTER_DICT_LRU_INTERVAL == 0) {
 		srv_main_thread_op_info = "enforcing dict cache limit";
 		ulint	n_evicted = srv_master_evict_from_table_cache(50);
@@ -1765,6 +1798,8 @@ srv_master_do_idle_tasks(void)
 	srv_sync_log_buffer_in_background();
 	MONITOR_INC_TIME_IN_MICRO_SECS(
 		MONITOR_SRV_LOG_FLUSH_MICROSECOND, counter_time);
+
+	srv_master_merge_ibuf();
 }
 
 /**
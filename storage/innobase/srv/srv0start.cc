@@ -830,6 +830,7 @@ static void srv_shutdown_threads()
 
 	lock_sys.timeout_timer.reset();
 	srv_master_timer.reset();
+	ibuf_merge_in_background_shutdown();
 
 	if (purge_sys.enabled()) {
 		srv_purge_shutdown();
@@ -2052,6 +2052,41 @@ int ha_myisam::restart_rnd_next(uchar *buf)
   return rnd_pos(buf, ref);
 }
 
+/*
+  A sample of a table with fixed length rows is read by jumping over the
+  rows that are not in the sample. The gaps between the rows of the sample
+  are geometrically distributed, which takes every row with the probability
+  'fraction'. Other tables, and big samples that would read most pages of
+  the data file anyway, are read with a table scan.
+*/
+
+int ha_myisam::sample_init(double fraction)
+{
+  if (file->s->data_file_type != STATIC_RECORD || fraction > 0.5)
+  {
+    sample_pos= HA_OFFSET_ERROR;
+    return handler::sample_init(fraction);
+  }
+  sample_fraction= fraction;
+  sample_pos= file->s->pack.header_length;
+  return mi_reset(file);
+}
+
+int ha_myisam::sample_next(uchar *buf)
+{
+  if (sample_pos == HA_OFFSET_ERROR)
+    return handler::sample_next(buf);
+
+  double skip= floor(log(1.0 - thd_rnd(table->in_use)) /
+                     log(1.0 - sample_fraction));
+  ulonglong reclength= file->s->base.pack_reclength;
+  if (skip >= (double) (file->state->data_file_length / reclength + 1))
+    return HA_ERR_END_OF_FILE;
+  my_off_t pos= sample_pos + (my_off_t) skip * reclength;
+  sample_pos= pos + reclength;
+  return mi_rrnd(file, buf, pos);
+}
+
 int ha_myisam::rnd_pos(uchar *buf, uchar *pos)
 {
   int error=mi_rrnd(file, buf, my_get_ptr(pos,ref_length));
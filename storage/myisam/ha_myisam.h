@@ -47,6 +47,8 @@ class ha_myisam final : public handler
   ulonglong int_table_flags;
   char    *data_file_name, *index_file_name;
   bool can_enable_indexes;
+  /* The position after the last row of a sample, or HA_OFFSET_ERROR */
+  my_off_t sample_pos;
   int repair(THD *thd, HA_CHECK &param, bool optimize);
   void setup_vcols_for_repair(HA_CHECK *param);
   void restore_vcos_after_repair();
@@ -101,6 +103,8 @@ class ha_myisam final : public handler
   int rnd_pos(uchar * buf, uchar *pos);
   int remember_rnd_pos();
   int restart_rnd_next(uchar *buf);
+  int sample_init(double fraction);
+  int sample_next(uchar *buf);
   void position(const uchar *record);
   int info(uint);
   int extra(enum ha_extra_function operation);